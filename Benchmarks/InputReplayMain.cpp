@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Headless input-session replay (console target, see InputReplay.jucer).
+
+    Replays sessions recorded with the MIDI monitor's "Record input" through
+    InputReplayer and prints each one's output hash and speed:
+
+      InputReplay <session.sdis>... [--expect <hex hash>]
+
+    The same file always gives the same hash, so --expect turns a session
+    into a regression check of the whole input -> output path.  The exit
+    code is 1 when a replay failed or a hash differs from --expect, 2 when
+    no session was given.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/InputReplayer.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The replay builds a processor and a (Timer-based) expression.
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList args (argc, argv);
+
+    const bool hasExpected = args.containsOption ("--expect");
+    const auto expected    = (juce::uint64) args.getValueForOption ("--expect").getHexValue64();
+
+    int numSessions = 0;
+    int numFailed   = 0;
+
+    for (const auto& arg : args.arguments)
+    {
+        if (arg.isOption() || arg.text == args.getValueForOption ("--expect"))
+            continue;
+
+        const auto file = arg.resolveAsFile();
+        const auto r    = InputReplayer::replay (file);
+        ++numSessions;
+
+        if (! r.ok)
+        {
+            std::cerr << file.getFileName() << ": replay failed: " << r.error << std::endl;
+            ++numFailed;
+            continue;
+        }
+
+        const bool matches = ! hasExpected || r.hash == expected;
+        if (! matches)
+            ++numFailed;
+
+        std::cout << file.getFileName() << ": " << r.numRecords << " records -> " << r.numEvents
+                  << " events   hash " << juce::String::toHexString ((juce::int64) r.hash)
+                  << "   " << juce::String (r.realtimeFactor(), 0) << "x realtime"
+                  << (matches ? "" : "   MISMATCH") << std::endl;
+    }
+
+    if (numSessions == 0)
+    {
+        std::cerr << "usage: InputReplay <session.sdis>... [--expect <hex hash>]" << std::endl;
+        return 2;
+    }
+
+    return numFailed == 0 ? 0 : 1;
+}
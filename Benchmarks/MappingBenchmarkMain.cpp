@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Headless keyboard-mapping parser check (console target, see
+    MappingBenchmark.jucer).
+
+    Fuzzes the parser with mutated mapping text, then measures its throughput
+    on a generated file, and prints both:
+
+      MappingBenchmark [--iterations <n>] [--seed <n>] [--megabytes <n>]
+
+    Defaults: 2000 inputs from a time-based seed, an 8 MB file.  A failing
+    input is written to mapping-fuzz-<seed>.txt in the working directory, so
+    it can be loaded as a mapping file or replayed with --seed, and the exit
+    code is 1.  MappingFuzzer.jucer is the coverage-guided (libFuzzer)
+    counterpart.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/KeyboardMappingParser.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    const juce::ArgumentList args (argc, argv);
+
+    const int  iterations = args.containsOption ("--iterations") ? args.getValueForOption ("--iterations").getIntValue() : 2000;
+    const auto seed       = args.containsOption ("--seed")       ? args.getValueForOption ("--seed").getLargeIntValue()  : juce::Time::currentTimeMillis();
+    const int  megabytes  = args.containsOption ("--megabytes")  ? args.getValueForOption ("--megabytes").getIntValue()  : 8;
+
+    const auto fuzz = KeyboardMappingParser::fuzz (iterations, seed);
+
+    if (fuzz.failure.isNotEmpty())
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile ("mapping-fuzz-" + juce::String (seed) + ".txt");
+        file.replaceWithData (fuzz.failingInput.getData(), fuzz.failingInput.getSize());
+
+        std::cerr << "fuzz FAILED after " << fuzz.iterations << " inputs (seed " << seed << "): "
+                  << fuzz.failure << "\ninput saved to " << file.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    std::cout << "fuzz       " << fuzz.iterations << " inputs, " << fuzz.bytes << " bytes passed (seed "
+              << seed << ")" << std::endl;
+
+    const auto bench = KeyboardMappingParser::benchmark (megabytes);
+
+    std::cout << "benchmark  " << juce::String ((double) bench.bytes / (1024.0 * 1024.0), 1) << " MB, "
+              << bench.lines << " lines, " << bench.entries << " entries: "
+              << juce::String (bench.bestSeconds * 1000.0, 1) << " ms, "
+              << juce::String (bench.megabytesPerSecond, 1) << " MB/s" << std::endl;
+
+    return 0;
+}
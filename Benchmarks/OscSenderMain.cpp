@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Standalone OSC load generator (console target, see OscSender.jucer).
+
+    Sends timestamped /stradella/press and /stradella/release pairs to a
+    running plugin at a fixed rate, then asks the plugin's OscControlReceiver
+    for its counters and prints delivered throughput and latency:
+
+      OscSender [--host <ip>] [--port <n>] [--rate <msg/s>] [--seconds <s>]
+                [--reply-port <n>] [--reply-host <ip>]
+
+    Defaults: 127.0.0.1:9100, 1000 msg/s for 5 s, replies on port 9101.
+    Send → receive latency compares this machine's high-resolution clock
+    with the plugin's, so it is only meaningful when both run on the same
+    machine.  The exit code is 1 when messages were lost, 2 when the plugin
+    could not be reached or did not answer.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+namespace
+{
+    // The plugin's grid: 4 rows by 12 columns.
+    constexpr int kRows    = 4;
+    constexpr int kColumns = 12;
+
+    //==============================================================================
+    /** Collects the /stradella/stats/reply answer on the receive thread. */
+    struct StatsReply : private juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>
+    {
+        explicit StatsReply (juce::OSCReceiver& r) : receiver (r)  { receiver.addListener (this); }
+        ~StatsReply() override                                     { receiver.removeListener (this); }
+
+        juce::int32 received = 0, rejected = 0, stamped = 0;
+        float meanWireUs = 0.0f, maxWireUs = 0.0f, meanQueueUs = 0.0f, maxQueueUs = 0.0f, ratePerS = 0.0f;
+        juce::WaitableEvent arrived;
+
+    private:
+        void oscMessageReceived (const juce::OSCMessage& m) override
+        {
+            if (m.getAddressPattern().toString() != "/stradella/stats/reply" || m.size() < 8)
+                return;
+
+            for (int i = 0; i < 3; ++i)
+                if (! m[i].isInt32())
+                    return;
+
+            for (int i = 3; i < 8; ++i)
+                if (! m[i].isFloat32())
+                    return;
+
+            received    = m[0].getInt32();
+            rejected    = m[1].getInt32();
+            stamped     = m[2].getInt32();
+            meanWireUs  = m[3].getFloat32();
+            maxWireUs   = m[4].getFloat32();
+            meanQueueUs = m[5].getFloat32();
+            maxQueueUs  = m[6].getFloat32();
+            ratePerS    = m[7].getFloat32();
+            arrived.signal();
+        }
+
+        juce::OSCReceiver& receiver;
+    };
+
+    juce::int32 highWord (juce::int64 ticks) noexcept { return (juce::int32) (juce::uint32) ((juce::uint64) ticks >> 32); }
+    juce::int32 lowWord  (juce::int64 ticks) noexcept { return (juce::int32) (juce::uint32) ((juce::uint64) ticks & 0xffffffffu); }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    const juce::ArgumentList args (argc, argv);
+
+    auto option = [&] (const char* name, const juce::String& fallback)
+    {
+        return args.containsOption (name) ? args.getValueForOption (name) : fallback;
+    };
+
+    const auto host      = option ("--host", "127.0.0.1");
+    const int  port      = option ("--port", "9100").getIntValue();
+    const int  rate      = juce::jmax (1, option ("--rate", "1000").getIntValue());
+    const auto seconds   = juce::jmax (0.1, option ("--seconds", "5").getDoubleValue());
+    const int  replyPort = option ("--reply-port", "9101").getIntValue();
+    const auto replyHost = option ("--reply-host", "127.0.0.1");
+
+    juce::OSCReceiver replyReceiver;
+    StatsReply reply (replyReceiver);
+
+    if (! replyReceiver.connect (replyPort))
+    {
+        std::cerr << "Cannot bind reply port " << replyPort << std::endl;
+        return 2;
+    }
+
+    juce::OSCSender sender;
+    if (! sender.connect (host, port))
+    {
+        std::cerr << "Cannot open a socket to " << host << ":" << port << std::endl;
+        return 2;
+    }
+
+    sender.send ("/stradella/stats/reset");
+
+    // Alternating press/release, walking the grid, so at most one cell is held.
+    const auto total    = (juce::int64) (rate * seconds) & ~(juce::int64) 1;
+    const auto start    = juce::Time::getMillisecondCounterHiRes();
+    const auto interval = 1000.0 / rate;
+    juce::int64 failed  = 0;
+
+    for (juce::int64 i = 0; i < total; ++i)
+    {
+        const auto due = start + (double) i * interval;
+
+        for (auto now = juce::Time::getMillisecondCounterHiRes(); now < due; now = juce::Time::getMillisecondCounterHiRes())
+            if (due - now > 2.0)
+                juce::Thread::sleep (1);
+
+        const auto cell  = (int) ((i / 2) % (kRows * kColumns));
+        const auto row   = cell / kColumns;
+        const auto col   = cell % kColumns;
+        const auto ticks = juce::Time::getHighResolutionTicks();
+
+        const bool ok = (i % 2 == 0)
+                      ? sender.send ("/stradella/press", row, col, 100, 1, 0, highWord (ticks), lowWord (ticks))
+                      : sender.send ("/stradella/release", row, col, highWord (ticks), lowWord (ticks));
+        if (! ok)
+            ++failed;
+    }
+
+    const auto sendSeconds = (juce::Time::getMillisecondCounterHiRes() - start) / 1000.0;
+
+    // Let the receive thread drain before asking for the counters.
+    juce::Thread::sleep (250);
+    sender.send ("/stradella/stats", replyPort, replyHost);
+
+    if (! reply.arrived.wait (2000))
+    {
+        std::cerr << "No /stradella/stats/reply from " << host << ":" << port
+                  << " (is OSC enabled in the plugin?)" << std::endl;
+        return 2;
+    }
+
+    const auto sent = total - failed;
+    std::cout << "sent       " << sent << " in " << juce::String (sendSeconds, 2) << " s ("
+              << juce::String ((double) sent / sendSeconds, 0) << " msg/s, " << failed << " send errors)\n"
+              << "delivered  " << reply.stamped << " (" << juce::String (sent - reply.stamped) << " lost), "
+              << juce::String (reply.ratePerS, 0) << " msg/s at the receiver, "
+              << reply.rejected << " rejected\n"
+              << "wire       " << juce::String (reply.meanWireUs, 1) << " us avg, "
+              << juce::String (reply.maxWireUs, 1) << " us max (send -> receive)\n"
+              << "queue      " << juce::String (reply.meanQueueUs, 1) << " us avg, "
+              << juce::String (reply.maxQueueUs, 1) << " us max (receive -> queued)" << std::endl;
+
+    return reply.stamped < sent ? 1 : 0;
+}
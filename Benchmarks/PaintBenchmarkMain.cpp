@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Headless paint benchmark (console target, see PaintBenchmark.jucer).
+
+    Runs PaintBenchmark without a window or plugin host, prints the report
+    and compares it with the baseline committed next to this file:
+
+      PaintBenchmark [--baseline <file>] [--frames <n>] [--write-baseline]
+
+    The baseline defaults to Benchmarks/paint-baseline.txt under the working
+    directory.  --write-baseline replaces it with this run's report instead
+    of comparing.  The exit code is 1 when a case regressed, 2 when the
+    baseline is missing or has no entry for one of this run's cases.
+
+    This target defines STRADELLA_COUNT_ALLOCATIONS=1, so allocations per
+    frame are counted.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PaintBenchmark.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The message manager must exist: the benchmark creates components.
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList args (argc, argv);
+
+    const auto baseline = args.containsOption ("--baseline")
+                            ? juce::File::getCurrentWorkingDirectory().getChildFile (args.getValueForOption ("--baseline"))
+                            : juce::File::getCurrentWorkingDirectory().getChildFile ("Benchmarks/paint-baseline.txt");
+
+    const int frames = args.containsOption ("--frames") ? args.getValueForOption ("--frames").getIntValue() : 30;
+
+    const auto result = PaintBenchmark::run (frames);
+    const auto report = result.toText();
+    std::cout << report << "# " << juce::String (result.wallSeconds, 1) << " s" << std::endl;
+
+    if (args.containsOption ("--write-baseline"))
+    {
+        if (! baseline.replaceWithText (report))
+        {
+            std::cerr << "Cannot write " << baseline.getFullPathName() << std::endl;
+            return 2;
+        }
+
+        std::cout << "Baseline written to " << baseline.getFullPathName() << std::endl;
+        return 0;
+    }
+
+    if (! baseline.existsAsFile())
+    {
+        std::cerr << "No baseline at " << baseline.getFullPathName() << " (run with --write-baseline)" << std::endl;
+        return 2;
+    }
+
+    const auto reference = PaintBenchmark::Result::fromText (baseline.loadFileAsString());
+
+    const auto missing = result.findMissing (reference);
+    if (! missing.isEmpty())
+    {
+        for (const auto& name : missing)
+            std::cerr << "MISSING " << name << std::endl;
+
+        std::cerr << missing.size() << " cases not in " << baseline.getFullPathName()
+                  << " (run with --write-baseline on the reference machine)" << std::endl;
+        return 2;
+    }
+
+    const auto regressions = result.findRegressions (reference);
+
+    for (const auto& r : regressions)
+        std::cout << "REGRESSION " << r << std::endl;
+
+    std::cout << (regressions.isEmpty() ? "no regressions" : juce::String (regressions.size()) + " regressions")
+              << std::endl;
+
+    return regressions.isEmpty() ? 0 : 1;
+}
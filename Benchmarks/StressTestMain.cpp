@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Headless UI -> audio hand-over stress test (console target, see
+    StressTest.jucer).
+
+    Runs BoundaryStressTest and prints its verdict and throughput:
+
+      StressTest [--seconds <s>] [--workers <n>]
+
+    Build the TSan or ASan configuration to have the sanitizer watch the
+    same paths; a sanitizer report fails the run on its own.  The exit code
+    is 1 when the result did not pass (stuck or unmatched notes, dropped
+    events, an undrained queue or a block over the queue's capacity).
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/BoundaryStressTest.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processor needs the message manager, although nothing here runs
+    // its loop: this thread plays the audio thread.
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList args (argc, argv);
+
+    const auto seconds = args.containsOption ("--seconds") ? args.getValueForOption ("--seconds").getDoubleValue() : 5.0;
+    const int  workers = args.containsOption ("--workers") ? args.getValueForOption ("--workers").getIntValue()    : 4;
+
+    const auto r = BoundaryStressTest::run (seconds, workers);
+
+    std::cout << (r.passed() ? "PASS" : "FAIL")
+              << "   " << juce::String (r.seconds, 1) << " s"
+              << "   " << juce::String (r.callsPerSecond(), 0) << " calls/s"
+              << "   " << juce::String (r.deliveredPerSecond(), 0) << " msgs/s\n"
+              << "peak queue " << r.peakQueueDepth
+              << "   stuck " << (juce::int64) r.stuckNotes
+              << "   unmatched " << (juce::int64) r.unmatchedNoteOffs
+              << "   dropped " << (juce::int64) r.eventsDropped
+              << "   " << (r.drained ? "drained" : "NOT drained") << std::endl;
+
+    return r.passed() ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Asynchronous structured logging implementation.
+
+  ==============================================================================
+*/
+
+#include "AsyncLogger.h"
+
+namespace
+{
+    // Format strings indexed by AsyncLogger::Event.  Arguments are substituted
+    // in order for each "%d".
+    static const char* kEventFormats[(int) AsyncLogger::Event::numEvents] = {
+        "CC sent: channel=%d controller=%d value=%d",
+        "Cell pressed: row=%d col=%d velocity=%d notes=%d",
+        "Cell released: row=%d col=%d notes=%d",
+        "Bellows direction change: %d",
+        "All notes off",
+        "Keyboard rollover: %d keys held (key code %d)",
+        "Suspected ghost key: code=%d held=%dus"
+    };
+}
+
+//==============================================================================
+AsyncLogger& AsyncLogger::getInstance()
+{
+    static AsyncLogger instance;
+    return instance;
+}
+
+AsyncLogger::AsyncLogger()
+    : juce::Thread ("StraDella log writer")
+{
+    for (juce::uint32 i = 0; i < kCapacity; ++i)
+        slots[i].sequence.store (i, std::memory_order_relaxed);
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    stopThread (1000);
+}
+
+//==============================================================================
+void AsyncLogger::log (Event event, int a, int b, int c, int d) noexcept
+{
+    auto& logger = getInstance();
+    if (! logger.isEnabled())
+        return;
+
+    Record r;
+    r.ticks   = juce::Time::getHighResolutionTicks();
+    r.event   = event;
+    r.args[0] = a;
+    r.args[1] = b;
+    r.args[2] = c;
+    r.args[3] = d;
+
+    if (! logger.push (r))
+        logger.dropped.fetch_add (1, std::memory_order_relaxed);
+}
+
+bool AsyncLogger::push (const Record& r) noexcept
+{
+    auto pos = enqueuePos.load (std::memory_order_relaxed);
+
+    for (;;)
+    {
+        auto& slot = slots[pos & kMask];
+        const auto seq  = slot.sequence.load (std::memory_order_acquire);
+        const auto diff = (juce::int32) (seq - pos);
+
+        if (diff == 0)
+        {
+            if (enqueuePos.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+            {
+                slot.record = r;
+                slot.sequence.store (pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;   // full
+        }
+        else
+        {
+            pos = enqueuePos.load (std::memory_order_relaxed);
+        }
+    }
+}
+
+bool AsyncLogger::pop (Record& r) noexcept
+{
+    auto& slot = slots[dequeuePos & kMask];
+    if (slot.sequence.load (std::memory_order_acquire) != dequeuePos + 1)
+        return false;
+
+    r = slot.record;
+    slot.sequence.store (dequeuePos + kCapacity, std::memory_order_release);
+    ++dequeuePos;
+    return true;
+}
+
+//==============================================================================
+void AsyncLogger::addClient()
+{
+    const juce::ScopedLock sl (clientLock);
+    if (numClients++ == 0)
+        startThread (juce::Thread::Priority::background);
+}
+
+void AsyncLogger::removeClient()
+{
+    const juce::ScopedLock sl (clientLock);
+    jassert (numClients > 0);
+    if (--numClients == 0)
+    {
+        stopThread (1000);
+        drain();
+    }
+}
+
+void AsyncLogger::run()
+{
+    while (! threadShouldExit())
+    {
+        drain();
+        wait (20);
+    }
+}
+
+void AsyncLogger::drain()
+{
+    Record r;
+    while (pop (r))
+        juce::Logger::writeToLog (format (r));
+
+    const auto lost = dropped.load (std::memory_order_relaxed);
+    if (lost != droppedReported)
+    {
+        juce::Logger::writeToLog ("AsyncLogger: " + juce::String (lost - droppedReported)
+                                  + " record(s) dropped (ring full)");
+        droppedReported = lost;
+    }
+}
+
+juce::String AsyncLogger::format (const Record& r)
+{
+    const auto index = (int) r.event;
+    if (! juce::isPositiveAndBelow (index, (int) Event::numEvents))
+        return "Unknown log event " + juce::String (index);
+
+    juce::String text;
+    int arg = 0;
+    for (const char* p = kEventFormats[index]; *p != 0; ++p)
+    {
+        if (p[0] == '%' && p[1] == 'd' && arg < 4)
+        {
+            text << r.args[arg++];
+            ++p;
+        }
+        else
+        {
+            text << *p;
+        }
+    }
+
+    const auto seconds = juce::Time::highResolutionTicksToSeconds (r.ticks);
+    return "[" + juce::String (seconds, 6) + "] " + text;
+}
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Asynchronous structured logging.
+
+    Callers push fixed-size binary records into a lock-free ring; a background
+    thread formats them and hands them to juce::Logger.  Pushing a record is a
+    relaxed atomic check, a timestamp read and one CAS, so it is safe to call
+    from the audio thread and from the 60 Hz expression timer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Logging is compiled in for debug builds only unless the build overrides it.
+#ifndef STRADELLA_ASYNC_LOGGING
+ #define STRADELLA_ASYNC_LOGGING JUCE_DEBUG
+#endif
+
+//==============================================================================
+class AsyncLogger  : private juce::Thread
+{
+public:
+    //==============================================================================
+    /** Record types.  Each one owns a format string in AsyncLogger.cpp. */
+    enum class Event : juce::uint16
+    {
+        ccSent = 0,        // a = channel, b = controller, c = value
+        cellPressed,       // a = row, b = col, c = velocity, d = notes sent
+        cellReleased,      // a = row, b = col, c = notes released
+        directionChange,   // a = new direction (+1 right, -1 left)
+        allNotesOff,       // no arguments
+        keyRollover,       // a = keys held including this press, b = key code
+        keyGhost,          // a = key code, b = hold time in microseconds
+        numEvents
+    };
+
+    /** One fixed-size binary log record. */
+    struct Record
+    {
+        juce::int64  ticks = 0;     // juce::Time::getHighResolutionTicks()
+        Event        event = Event::ccSent;
+        juce::int32  args[4] {};
+    };
+
+    //==============================================================================
+    static AsyncLogger& getInstance();
+
+    /** Appends a record.  Lock-free and allocation-free.  Does nothing while
+        logging is disabled; drops the record (and counts it) when the ring
+        is full. */
+    static void log (Event event, int a = 0, int b = 0, int c = 0, int d = 0) noexcept;
+
+    /** Starts the writer thread for one client (reference counted). */
+    void addClient();
+
+    /** Releases one client; the writer thread stops with the last one. */
+    void removeClient();
+
+    void setEnabled (bool shouldBeEnabled) noexcept   { enabled.store (shouldBeEnabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept                   { return enabled.load (std::memory_order_relaxed); }
+
+    /** Number of records lost because the ring was full. */
+    juce::int64 getNumDropped() const noexcept        { return dropped.load (std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    AsyncLogger();
+    ~AsyncLogger() override;
+
+    bool push (const Record& r) noexcept;
+    bool pop  (Record& r) noexcept;
+
+    void run() override;
+    void drain();
+
+    static juce::String format (const Record& r);
+
+    //==============================================================================
+    // Bounded multi-producer / single-consumer ring (Vyukov).  Each slot
+    // carries a sequence number so producers never wait on the consumer.
+    static constexpr juce::uint32 kCapacity = 4096;   // power of two
+    static constexpr juce::uint32 kMask     = kCapacity - 1;
+
+    struct Slot
+    {
+        std::atomic<juce::uint32> sequence { 0 };
+        Record                    record;
+    };
+
+    Slot slots[kCapacity];
+    alignas (64) std::atomic<juce::uint32> enqueuePos { 0 };
+    alignas (64) juce::uint32              dequeuePos { 0 };
+
+    std::atomic<bool>        enabled { true };
+    std::atomic<juce::int64> dropped { 0 };
+    juce::int64              droppedReported = 0;
+
+    juce::CriticalSection clientLock;
+    int                   numClients = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncLogger)
+};
+
+//==============================================================================
+#if STRADELLA_ASYNC_LOGGING
+ #define STRADELLA_LOG(...)  AsyncLogger::log (__VA_ARGS__)
+#else
+ #define STRADELLA_LOG(...)  ((void) 0)
+#endif
@@ -0,0 +1,293 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Bass pattern engine implementation.
+
+  ==============================================================================
+*/
+
+#include "BassPatternEngine.h"
+
+//==============================================================================
+namespace
+{
+    struct PatternDef
+    {
+        const char* name;
+        double      stepPpq;   ///< step length in quarter notes
+        int         length;    ///< steps per cycle
+        int         steps[4];  ///< BassPatternEngine::Step values
+    };
+
+    // rest = 0, bass = 1, altBass = 2, chord = 3
+    static const PatternDef kPatterns[(int) BassPatternEngine::Pattern::numPatterns] = {
+        { "Off",     1.0, 1, { 0 } },
+        { "Oom-pah", 1.0, 2, { 1, 3 } },          // root, chord
+        { "Waltz",   1.0, 3, { 1, 3, 3 } },       // root, chord, chord
+        { "Polka",   0.5, 4, { 1, 3, 2, 3 } }     // root, chord, counterbass, chord
+    };
+
+    // Positions closer than this are treated as the same point on the timeline.
+    constexpr double kEpsilonPpq = 1.0e-6;
+
+    // A block that starts further than this from where the previous one ended
+    // is a locate or loop jump.
+    constexpr double kJumpTolerancePpq = 0.01;
+
+    static double positiveModulo (double x, double m)
+    {
+        const double r = std::fmod (x, m);
+        return r < 0.0 ? r + m : r;
+    }
+}
+
+juce::String BassPatternEngine::getPatternName (Pattern p)
+{
+    jassert (juce::isPositiveAndBelow ((int) p, (int) Pattern::numPatterns));
+    return kPatterns[(int) p].name;
+}
+
+//==============================================================================
+void BassPatternEngine::prepare (double newSampleRate)
+{
+    sampleRate  = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+    wasPlaying  = false;
+    wasSounding = false;
+    freePpq     = 0.0;
+
+    // Notes already started must still end: their note-offs go out at the
+    // start of the next block rather than being dropped.
+    flushPending = noteOffs.getNumPending() > 0;
+}
+
+void BassPatternEngine::process (const Sources& sources, const Settings& settings,
+                                 const juce::Optional<juce::AudioPlayHead::PositionInfo>& position,
+                                 juce::int64 blockStart, int numSamples, MidiEventList& out)
+{
+    if (numSamples <= 0)
+        return;
+
+    if (flushPending)
+    {
+        flushNoteOffs (out, 0);
+        noteOffs.reset (blockStart);
+        flushPending = false;
+    }
+
+    // Switching pattern (or turning it off) cuts whatever is still sounding.
+    if (settings.pattern != lastPattern)
+    {
+        flushNoteOffs (out, 0);
+        lastPattern = settings.pattern;
+        wasSounding = false;
+    }
+
+    emitDueNoteOffs (blockStart, numSamples, out);
+
+    if (settings.pattern == Pattern::off)
+    {
+        wasPlaying = false;
+        return;
+    }
+
+    const auto& def = kPatterns[(int) settings.pattern];
+
+    Clock clock;
+    bool   playing = false;
+    double ppq     = 0.0;
+    bool   looping = false;
+    juce::AudioPlayHead::LoopPoints loop;
+
+    if (position.hasValue())
+    {
+        if (auto bpm = position->getBpm(); bpm.hasValue() && *bpm > 0.0)
+            lastBpm = *bpm;
+
+        if (auto p = position->getPpqPosition(); p.hasValue())
+        {
+            ppq     = *p;
+            playing = position->getIsPlaying();
+        }
+
+        if (auto bar = position->getPpqPositionOfLastBarStart(); bar.hasValue())
+            clock.barStartPpq = *bar;
+
+        if (auto sig = position->getTimeSignature(); sig.hasValue() && sig->numerator > 0 && sig->denominator > 0)
+            clock.barLengthPpq = sig->numerator * 4.0 / sig->denominator;
+
+        if (auto lp = position->getLoopPoints(); lp.hasValue() && position->getIsLooping())
+        {
+            loop    = *lp;
+            looping = loop.ppqEnd > loop.ppqStart;
+        }
+    }
+
+    const double samplesPerBeat = sampleRate * 60.0 / lastBpm;
+    const double blockPpq       = numSamples / samplesPerBeat;
+
+    if (playing)
+    {
+        // Transport start, locate, or a loop wrap on a block boundary.
+        if (! wasPlaying || std::abs (ppq - expectedPpq) > kJumpTolerancePpq)
+            flushNoteOffs (out, 0);
+
+        wasPlaying  = true;
+        wasSounding = false;
+
+        const double endPpq = ppq + blockPpq;
+
+        if (looping && ppq < loop.ppqEnd && endPpq > loop.ppqEnd)
+        {
+            // The loop wraps inside this block: play up to the loop end, cut
+            // the ringing notes there, and carry on from the loop start.
+            const int split = juce::jlimit (0, numSamples,
+                                            juce::roundToInt ((loop.ppqEnd - ppq) * samplesPerBeat));
+
+            processSegment (ppq, loop.ppqEnd, 0, split, samplesPerBeat, clock,
+                            sources, settings, blockStart, out);
+            flushNoteOffs (out, juce::jmin (split, numSamples - 1));
+
+            const double resumePpq = loop.ppqStart + (endPpq - loop.ppqEnd);
+            processSegment (loop.ppqStart, resumePpq, split, numSamples, samplesPerBeat, clock,
+                            sources, settings, blockStart, out);
+            expectedPpq = resumePpq;
+        }
+        else
+        {
+            processSegment (ppq, endPpq, 0, numSamples, samplesPerBeat, clock,
+                            sources, settings, blockStart, out);
+            expectedPpq = endPpq;
+        }
+    }
+    else
+    {
+        if (wasPlaying)
+        {
+            flushNoteOffs (out, 0);
+            wasPlaying = false;
+        }
+
+        // Free-run: restart on the downbeat whenever the first source arrives.
+        const bool sounding = ! sources.isEmpty();
+        if (sounding && ! wasSounding)
+            freePpq = 0.0;
+        wasSounding = sounding;
+
+        clock.barStartPpq  = 0.0;
+        clock.barLengthPpq = def.stepPpq * def.length;
+
+        processSegment (freePpq, freePpq + blockPpq, 0, numSamples, samplesPerBeat, clock,
+                        sources, settings, blockStart, out);
+        freePpq += blockPpq;
+    }
+
+    // Short gates at fast tempi can end inside the block they started in.
+    emitDueNoteOffs (blockStart, numSamples, out);
+}
+
+//==============================================================================
+void BassPatternEngine::processSegment (double ppqFrom, double ppqTo, int sampleFrom, int sampleTo,
+                                        double samplesPerBeat, const Clock& clock,
+                                        const Sources& sources, const Settings& settings,
+                                        juce::int64 blockStart, MidiEventList& out)
+{
+    if (sampleTo <= sampleFrom || ppqTo <= ppqFrom)
+        return;
+
+    const auto&  def  = kPatterns[(int) settings.pattern];
+    const double step = def.stepPpq;
+
+    // Steps sit on a grid anchored at the bar start; include a boundary that
+    // falls exactly on ppqFrom, exclude one exactly on ppqTo (the next block
+    // starts there and will pick it up).
+    auto k = (juce::int64) std::ceil ((ppqFrom - clock.barStartPpq) / step - kEpsilonPpq);
+
+    // A pattern whose cycle divides the bar restarts on every downbeat;
+    // one that does not (a waltz in 4/4) runs its own cycle from ppq 0.
+    const double patternCycle = step * def.length;
+    const double cyclesPerBar = clock.barLengthPpq / patternCycle;
+    const bool   barSynced    = cyclesPerBar > 0.5
+                             && std::abs (cyclesPerBar - std::round (cyclesPerBar)) < kEpsilonPpq;
+    const double cycleStart   = barSynced ? clock.barStartPpq  : 0.0;
+    const double cycleLength  = barSynced ? clock.barLengthPpq : patternCycle;
+
+    for (;; ++k)
+    {
+        const double boundary = clock.barStartPpq + (double) k * step;
+        if (boundary >= ppqTo - kEpsilonPpq)
+            break;
+
+        const int offset = juce::jlimit (sampleFrom, sampleTo - 1,
+                                         sampleFrom + juce::roundToInt ((boundary - ppqFrom) * samplesPerBeat));
+
+        const double posInCycle = positiveModulo (boundary - cycleStart, cycleLength);
+        const int    index      = (int) std::floor (posInCycle / step + 0.5) % def.length;
+
+        fireStep ((Step) def.steps[index], offset, step * samplesPerBeat,
+                  sources, settings, blockStart, out);
+    }
+}
+
+void BassPatternEngine::fireStep (Step step, int sampleOffset, double stepSamples,
+                                  const Sources& sources, const Settings& settings,
+                                  juce::int64 blockStart, MidiEventList& out)
+{
+    if (step == Step::rest)
+        return;
+
+    const float gate     = juce::jlimit (0.1f, 0.95f, settings.gate);
+    const auto  offTime  = blockStart + sampleOffset + juce::jmax ((juce::int64) 1, (juce::int64) (stepSamples * gate));
+    const auto  velocity = (juce::uint8) juce::jlimit (1, 127, sources.velocity);
+
+    // The note-off is parked first; a note that cannot be ended is never started.
+    auto play = [&] (int note, int priority)
+    {
+        if (! juce::isPositiveAndBelow (note, 128))
+            return;
+
+        if (noteOffs.schedule (offTime, juce::MidiMessage::noteOff (1, note)))
+            out.add (juce::MidiMessage::noteOn (1, note, velocity), sampleOffset, priority);
+    };
+
+    switch (step)
+    {
+        case Step::bass:
+            play (sources.bass, sources.bassPriority);
+            break;
+
+        case Step::altBass:
+            if (sources.altBass >= 0)
+                play (sources.altBass, sources.altBassPriority);
+            else
+                play (sources.bass, sources.bassPriority);
+            break;
+
+        case Step::chord:
+            for (int i = 0; i < sources.numChord; ++i)
+                play (sources.chord[i], sources.chordPriority[i]);
+            break;
+
+        case Step::rest:
+        default:
+            break;
+    }
+}
+
+//==============================================================================
+void BassPatternEngine::flushNoteOffs (MidiEventList& out, int sampleOffset)
+{
+    noteOffs.popAll ([&] (const TimingWheel::Event& e)
+    {
+        out.add (e.data, e.size, sampleOffset);
+    });
+}
+
+void BassPatternEngine::emitDueNoteOffs (juce::int64 blockStart, int numSamples, MidiEventList& out)
+{
+    noteOffs.popDue (blockStart + numSamples, [&] (const TimingWheel::Event& e)
+    {
+        out.add (e.data, e.size, (int) juce::jlimit ((juce::int64) 0, (juce::int64) numSamples - 1,
+                                                     e.time - blockStart));
+    });
+}
@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Tempo-synced automatic bass patterns (oom-pah, waltz, polka).
+
+    While a pattern is selected, the held bass and chord cells no longer sound
+    directly; instead they become the sources for a repeating accompaniment
+    figure that is locked to the host position.  Steps are placed at exact
+    sample offsets inside the block, note-offs for the gated steps are parked
+    in a TimingWheel so they can fall in later blocks, and loop wraps inside a
+    block are split so the step after the loop start is never missed.
+
+    With the host transport stopped (or no play head at all) the pattern
+    free-runs at the last known tempo, starting on the downbeat as soon as a
+    source cell is pressed.
+
+    Each pattern restarts on the downbeat when its cycle fits the bar a
+    whole number of times; otherwise (a waltz in 4/4) it keeps its own
+    cycle across bar lines.
+
+    process() runs on the audio thread and never allocates or locks.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TimingWheel.h"
+#include "MidiEventList.h"
+
+//==============================================================================
+class BassPatternEngine
+{
+public:
+    //==============================================================================
+    enum class Pattern { off = 0, oomPah, waltz, polka, numPatterns };
+
+    static juce::String getPatternName (Pattern p);
+
+    /** User settings (copied to the audio thread once per block). */
+    struct Settings
+    {
+        Pattern pattern = Pattern::off;
+        float   gate    = 0.5f;   ///< fraction of a step each note sounds (0.1 - 0.95)
+    };
+
+    /** Notes the pattern draws from, maintained by the processor as cells are
+        pressed and released.  -1 / 0 entries mean "nothing held". */
+    struct Sources
+    {
+        static constexpr int kMaxChordNotes = 8;
+
+        int bass     = -1;   ///< root step note
+        int altBass  = -1;   ///< counterbass step note
+        int chord[kMaxChordNotes] {};
+        int numChord = 0;
+        int velocity = 100;
+
+        // Voice limiter steal priorities of the notes above.
+        int bassPriority    = 3;
+        int altBassPriority = 2;
+        int chordPriority[kMaxChordNotes] {};
+
+        bool isEmpty() const noexcept { return bass < 0 && numChord == 0; }
+    };
+
+    //==============================================================================
+    BassPatternEngine() = default;
+
+    /** Keeps the note-offs of notes already started; they are sent at the
+        start of the next process() call. */
+    void prepare (double sampleRate);
+
+    /** Appends this block's pattern events to `out`.  blockStart is the running
+        sample position of the first sample in the block. */
+    void process (const Sources& sources, const Settings& settings,
+                  const juce::Optional<juce::AudioPlayHead::PositionInfo>& position,
+                  juce::int64 blockStart, int numSamples, MidiEventList& out);
+
+    /** Number of step notes lost because the note-off pool was full. */
+    juce::int64 getNumDroppedNoteOffs() const noexcept { return noteOffs.getNumDropped(); }
+
+private:
+    //==============================================================================
+    enum class Step : juce::uint8 { rest, bass, altBass, chord };
+
+    struct Clock
+    {
+        double barStartPpq = 0.0, barLengthPpq = 4.0;
+    };
+
+    void processSegment (double ppqFrom, double ppqTo, int sampleFrom, int sampleTo,
+                         double samplesPerBeat, const Clock& clock, const Sources& sources, const Settings& settings,
+                         juce::int64 blockStart, MidiEventList& out);
+
+    void fireStep (Step step, int sampleOffset, double stepSamples, const Sources& sources,
+                   const Settings& settings, juce::int64 blockStart, MidiEventList& out);
+
+    void flushNoteOffs (MidiEventList& out, int sampleOffset);
+
+    void emitDueNoteOffs (juce::int64 blockStart, int numSamples, MidiEventList& out);
+
+    //==============================================================================
+    TimingWheel noteOffs;
+    double      sampleRate = 44100.0;
+
+    // Continuity tracking for loop/jump detection.
+    bool        wasPlaying   = false;
+    double      expectedPpq  = 0.0;
+    double      lastBpm      = 120.0;
+
+    // Free-running clock used while the transport is stopped.
+    double      freePpq      = 0.0;
+    bool        wasSounding  = false;
+    Pattern     lastPattern  = Pattern::off;
+
+    // Set by prepare(): note-offs still parked go out with the next block.
+    bool        flushPending = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BassPatternEngine)
+};
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Bass register implementation.
+
+  ==============================================================================
+*/
+
+#include "BassRegisters.h"
+
+//==============================================================================
+namespace
+{
+    // Grid rows, as the processor's RowType.
+    enum { thirdRow = 0, bassRow, majorRow, minorRow };
+
+    constexpr juce::uint8 octaves (std::initializer_list<int> list)
+    {
+        juce::uint8 mask = 0;
+        for (int o : list)
+            mask |= BassRegisters::octaveBit (o);
+        return mask;
+    }
+
+    struct Factory
+    {
+        const char* name;
+        juce::uint8 bass;     // Bass and Third rows
+        juce::uint8 chords;   // Major and Minor rows
+        bool        mix;
+    };
+
+    // Bass reeds reach down further than the chord reeds, which sit in the
+    // middle of the instrument.
+    const Factory kFactory[BassRegisters::kNumRegisters] = {
+        { "Single reed",                 octaves ({ 0 }),                 octaves ({ 0 }),         false },
+        { "2 reeds",                     octaves ({ -1, 0 }),             octaves ({ 0 }),         false },
+        { "3 reeds",                     octaves ({ -1, 0, 1 }),          octaves ({ 0, 1 }),      false },
+        { "4 reeds",                     octaves ({ -2, -1, 0, 1 }),      octaves ({ -1, 0, 1 }),  false },
+        { "5 reeds",                     octaves ({ -2, -1, 0, 1, 2 }),   octaves ({ -1, 0, 1 }),  false },
+        { "Tutti (bass + counterbass)",  octaves ({ -1, 0, 1 }),          octaves ({ -1, 0, 1 }),  true  },
+    };
+}
+
+//==============================================================================
+BassRegisters::BassRegisters()
+{
+    for (int i = 0; i < kNumRegisters; ++i)
+    {
+        const auto& f = kFactory[i];
+
+        Register r;
+        r.octaves[thirdRow] = r.octaves[bassRow]  = f.bass;
+        r.octaves[majorRow] = r.octaves[minorRow] = f.chords;
+        r.mixBassRows = f.mix;
+        setRegister (i, r);
+    }
+}
+
+juce::String BassRegisters::getName (int index)
+{
+    return kFactory[clampIndex (index)].name;
+}
+
+void BassRegisters::setRegister (int index, const Register& r)
+{
+    index = clampIndex (index);
+    registers[index] = r;
+
+    for (auto& o : registers[index].octaves)
+    {
+        o &= (juce::uint8) ((1 << (kMaxOctave - kMinOctave + 1)) - 1);
+        if (o == 0)
+            o = octaveBit (0);
+    }
+
+    compile (index);
+}
+
+// Turns a register into the semitone shifts expand() ORs together.
+void BassRegisters::compile (int index)
+{
+    const auto& r = registers[index];
+
+    for (int row = 0; row < kNumRows; ++row)
+    {
+        auto& s = shifts[index][row];
+        s.count = 0;
+
+        // The other single-note row is a major 3rd above (Bass) or below (Third).
+        const bool mix      = r.mixBassRows && (row == thirdRow || row == bassRow);
+        const int  mixShift = row == bassRow ? 4 : -4;
+
+        for (int octave = kMinOctave; octave <= kMaxOctave; ++octave)
+        {
+            if ((r.octaves[row] & octaveBit (octave)) == 0)
+                continue;
+
+            s.semitones[s.count++] = (juce::int8) (octave * 12);
+            if (mix)
+                s.semitones[s.count++] = (juce::int8) (octave * 12 + mixShift);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Bass register switches: multi-reed octave doubling.
+
+    A real Stradella bass sounds each button on several reed banks at once,
+    and its register switches choose which banks speak (2-, 3-, 4- and
+    5-reed bass).  Here a register is, per grid row, the set of octaves the
+    cell's notes are doubled in, plus an optional "tutti" mix in which the
+    Bass and Third rows also sound each other's note.
+
+    Each register/row pair is compiled into a short list of semitone shifts,
+    so expanding a cell is one shifted NoteMask OR per shift: a 5-reed chord
+    costs the same as a single-reed one, and notes that land on the same
+    pitch are merged by the mask.
+
+    Not thread-safe: the processor guards it with its message lock.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "NoteMask.h"
+
+//==============================================================================
+class BassRegisters
+{
+public:
+    //==============================================================================
+    static constexpr int kNumRegisters = 6;
+    static constexpr int kNumRows      = 4;    ///< as the processor's RowType
+    static constexpr int kMinOctave    = -2;
+    static constexpr int kMaxOctave    = 2;
+
+    /** One register switch.  octaves[row] has bit (octave - kMinOctave) set
+        for every octave the row sounds in; bit 2 alone (octave 0) is a
+        single reed.  mixBassRows adds the Third to the Bass row and the
+        root to the Third row, in the same octaves. */
+    struct Register
+    {
+        juce::uint8 octaves[kNumRows] {};
+        bool        mixBassRows = false;
+    };
+
+    static constexpr juce::uint8 octaveBit (int octave) noexcept   { return (juce::uint8) (1 << (octave - kMinOctave)); }
+
+    //==============================================================================
+    /** Starts with the factory registers (single reed to tutti). */
+    BassRegisters();
+
+    /** Replaces one register; an empty octave set is treated as a single reed. */
+    void            setRegister (int index, const Register& r);
+    const Register& getRegister (int index) const noexcept   { return registers[clampIndex (index)]; }
+
+    static juce::String getName (int index);
+
+    /** The notes of a cell on `row` as sounded by register `index`. */
+    NoteMask expand (int index, int row, const NoteMask& notes) const noexcept
+    {
+        const auto& s = shifts[clampIndex (index)][row];
+
+        NoteMask out;
+        for (int i = 0; i < s.count; ++i)
+            out |= notes.shiftedBy (s.semitones[i]);
+        return out;
+    }
+
+private:
+    //==============================================================================
+    static constexpr int kMaxShifts = 2 * (kMaxOctave - kMinOctave + 1);
+
+    struct Shifts
+    {
+        juce::int8 semitones[kMaxShifts] {};
+        int        count = 0;
+    };
+
+    static int clampIndex (int index) noexcept   { return juce::jlimit (0, kNumRegisters - 1, index); }
+
+    void compile (int index);
+
+    Register registers[kNumRegisters];
+    Shifts   shifts[kNumRegisters][kNumRows];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BassRegisters)
+};
@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Stress test for the UI -> audio hand-over (see header).
+
+  ==============================================================================
+*/
+
+#include "BoundaryStressTest.h"
+#include "PluginProcessor.h"
+
+using Processor = StraDellaMIDI_pluginAudioProcessor;
+
+//==============================================================================
+// One hammering thread.  It only ever releases cells it pressed itself, and
+// releases everything it still holds before it returns.
+class BoundaryStressTest::Worker : public juce::Thread
+{
+public:
+    Worker (Processor& p, int index)
+        : juce::Thread ("StraDella stress " + juce::String (index)),
+          audioProcessor (p),
+          random (0x5eed + index)
+    {
+    }
+
+    ~Worker() override { stopThread (2000); }
+
+    juce::uint64 getNumCalls() const noexcept { return numCalls.load (std::memory_order_relaxed); }
+
+private:
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            const int op = random.nextInt (100);
+
+            if (op < 45 || (op < 90 && numHeld == 0))
+                pressRandomCell();
+            else if (op < 90)
+                releaseRandomCell();
+            else if (op < 99)
+                changeVoicing();
+            else
+                audioProcessor.sendAllNotesOff();
+
+            numCalls.fetch_add (1, std::memory_order_relaxed);
+        }
+
+        for (int row = 0; row < Processor::NUM_ROWS; ++row)
+            for (int col = 0; col < Processor::NUM_COLUMNS; ++col)
+                if (held[row][col])
+                    audioProcessor.buttonReleased (row, col);
+    }
+
+    void pressRandomCell()
+    {
+        const int row = random.nextInt (Processor::NUM_ROWS);
+        const int col = random.nextInt (Processor::NUM_COLUMNS);
+        if (held[row][col])
+            return;
+
+        held[row][col] = true;
+        ++numHeld;
+        audioProcessor.buttonPressed (row, col, 40 + random.nextInt (80),
+                                      random.nextBool(), random.nextBool());
+    }
+
+    void releaseRandomCell()
+    {
+        // Held cells are few; scan from a random start for the next one.
+        int cell = random.nextInt (Processor::NUM_ROWS * Processor::NUM_COLUMNS);
+        for (;; cell = (cell + 1) % (Processor::NUM_ROWS * Processor::NUM_COLUMNS))
+        {
+            const int row = cell / Processor::NUM_COLUMNS;
+            const int col = cell % Processor::NUM_COLUMNS;
+
+            if (held[row][col])
+            {
+                held[row][col] = false;
+                --numHeld;
+                audioProcessor.buttonReleased (row, col);
+                return;
+            }
+        }
+    }
+
+    void changeVoicing()
+    {
+        const int what  = random.nextInt (4);
+        const int value = random.nextInt (4);
+
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            switch (what)
+            {
+                case 0:  s.autoInversion  = ! s.autoInversion; break;
+                case 1:  s.strumDirection = value;             break;
+                case 2:  s.majorInversion = value % 3;         break;
+                default: s.octaveOffset[value] = random.nextInt (3) - 1; break;
+            }
+        });
+    }
+
+    Processor&                audioProcessor;
+    juce::Random              random;
+    bool                      held[Processor::NUM_ROWS][Processor::NUM_COLUMNS] {};
+    int                       numHeld = 0;
+    std::atomic<juce::uint64> numCalls { 0 };
+};
+
+//==============================================================================
+BoundaryStressTest::Result BoundaryStressTest::run (double seconds, int numWorkers)
+{
+    // A private instance: its output goes nowhere, and its counters start
+    // at zero, so the peak depth is this run's.
+    constexpr double kSampleRate = 48000.0;
+    constexpr int    kBlockSize  = 512;
+
+    seconds    = juce::jlimit (0.1, 600.0, seconds);
+    numWorkers = juce::jlimit (1, 16, numWorkers);
+
+    auto processor = std::make_unique<Processor>();
+    processor->setRateAndBufferSizeDetails (kSampleRate, kBlockSize);
+    processor->prepareToPlay (kSampleRate, kBlockSize);
+
+    juce::AudioBuffer<float> audio (0, kBlockSize);
+    juce::MidiBuffer         midi;
+    const int                blockMs = juce::roundToInt (kBlockSize * 1000.0 / kSampleRate);
+
+    auto processOneBlock = [&]
+    {
+        midi.clear();
+        processor->processBlock (audio, midi);
+        juce::Thread::sleep (blockMs);
+    };
+
+    juce::OwnedArray<Worker> workers;
+    for (int i = 0; i < numWorkers; ++i)
+        workers.add (new Worker (*processor, i))->startThread();
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    const auto endTicks   = startTicks + juce::Time::secondsToHighResolutionTicks (seconds);
+
+    while (juce::Time::getHighResolutionTicks() < endTicks)
+        processOneBlock();
+
+    // Workers release their cells on the way out; keep processing meanwhile
+    // so none of them can stall on a full queue.
+    for (auto* w : workers)
+        w->signalThreadShouldExit();
+
+    for (auto* w : workers)
+        while (w->isThreadRunning())
+            processOneBlock();
+
+    const auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+    juce::uint64 calls = 0;
+    for (auto* w : workers)
+        calls += w->getNumCalls();
+
+    // Give processBlock up to two seconds to pick up the last releases,
+    // then another 100 ms to play out any rolled chord tones.
+    for (int i = 0; i < 2000 / blockMs; ++i)
+    {
+        if (processor->getBoundaryStats().queueDepth == 0)
+            break;
+
+        processOneBlock();
+    }
+
+    for (int i = 0; i < 100 / blockMs + 1; ++i)
+        processOneBlock();
+
+    workers.clear();
+
+    const auto after = processor->getBoundaryStats();
+    processor->releaseResources();
+
+    Result r;
+    r.seconds           = elapsed;
+    r.calls             = calls;
+    r.delivered         = after.messagesDelivered;
+    r.peakQueueDepth    = after.peakQueueDepth;
+    r.eventsDropped     = after.eventsDropped;
+    r.unmatchedNoteOffs = after.unmatchedNoteOffs;
+    r.stuckNotes        = after.stuckNotes;
+    r.drained           = after.queueDepth == 0;
+    return r;
+}
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Stress test for the UI -> audio hand-over.
+
+    The test creates its own processor instance, prepared like a host would
+    (rate, block size, prepareToPlay), so rolled chords and their carry-over
+    across blocks are exercised too.  Several worker threads call that
+    instance's message-thread entry points (buttonPressed / buttonReleased /
+    setVoicingSettings / sendAllNotesOff) as fast as they can while the
+    calling thread runs processBlock at audio block pace.  Every
+    worker releases what it pressed before it stops, so afterwards the
+    BoundaryStats must show no stuck and no unmatched notes, the queue must
+    have drained completely, and no block may have picked up more than the
+    pending queue's non-reserved capacity.  The result also reports
+    sustained throughput in calls and delivered messages per second.
+
+    Benchmarks/StressTest.jucer runs it headless, with TSan and ASan
+    configurations, and exits non-zero when the result did not pass.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PendingEventQueue.h"
+
+class StraDellaMIDI_pluginAudioProcessor;
+
+//==============================================================================
+class BoundaryStressTest
+{
+public:
+    //==============================================================================
+    struct Result
+    {
+        double       seconds           = 0.0;
+        juce::uint64 calls             = 0;   ///< entry-point calls made by the workers
+        juce::uint64 delivered         = 0;   ///< messages processBlock picked up
+        int          peakQueueDepth    = 0;   ///< most messages one block picked up
+        juce::uint64 eventsDropped     = 0;
+        juce::uint64 unmatchedNoteOffs = 0;
+        juce::uint64 stuckNotes        = 0;
+        bool         drained           = false;   ///< queue empty after the run
+
+        double callsPerSecond()     const noexcept { return seconds > 0.0 ? (double) calls     / seconds : 0.0; }
+        double deliveredPerSecond() const noexcept { return seconds > 0.0 ? (double) delivered / seconds : 0.0; }
+        bool   passed()             const noexcept
+        {
+            return drained && eventsDropped == 0 && unmatchedNoteOffs == 0 && stuckNotes == 0
+                && peakQueueDepth <= PendingEventQueue::kCapacity - PendingEventQueue::kReleaseReserve;
+        }
+    };
+
+    /** Runs the test for the given time on the calling thread, which plays
+        the audio thread, and returns when every worker has stopped. */
+    static Result run (double seconds, int numWorkers = 4);
+
+private:
+    //==============================================================================
+    class Worker;
+};
@@ -0,0 +1,253 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Chord recognizer implementation.
+
+  ==============================================================================
+*/
+
+#include "ChordRecognizer.h"
+
+using Quality = ChordRecognizer::Quality;
+
+//==============================================================================
+namespace
+{
+    // Interval sets relative to the root, simplest reading first: when one
+    // pitch-class set spells two chords, the earlier template is preferred.
+    struct Template
+    {
+        Quality quality;
+        int     intervals;   // bit n = n semitones above the root
+    };
+
+    constexpr int bits (std::initializer_list<int> intervals)
+    {
+        int mask = 0;
+        for (int i : intervals)
+            mask |= 1 << i;
+        return mask;
+    }
+
+    const Template kTemplates[] = {
+        { Quality::major,     bits ({ 0, 4, 7 }) },
+        { Quality::minor,     bits ({ 0, 3, 7 }) },
+        { Quality::dominant7, bits ({ 0, 4, 7, 10 }) },
+        { Quality::minor7,    bits ({ 0, 3, 7, 10 }) },
+        { Quality::dominant7, bits ({ 0, 4, 10 }) },        // no 5th
+        { Quality::minor7,    bits ({ 0, 3, 10 }) },        // no 5th
+        { Quality::majorAdd9, bits ({ 0, 2, 4, 7 }) },
+        { Quality::minorAdd9, bits ({ 0, 2, 3, 7 }) },
+        { Quality::dominant9, bits ({ 0, 2, 4, 7, 10 }) },
+        { Quality::minor9,    bits ({ 0, 2, 3, 7, 10 }) },
+        { Quality::dominant9, bits ({ 0, 2, 4, 10 }) },     // no 5th
+        { Quality::minor9,    bits ({ 0, 2, 3, 10 }) },     // no 5th
+    };
+
+    int rotateDown (int pitchClassSet, int semitones) noexcept
+    {
+        return ((pitchClassSet >> semitones) | (pitchClassSet << (12 - semitones))) & 0xfff;
+    }
+
+    bool isMinorQuality (Quality q) noexcept
+    {
+        return q == Quality::minor || q == Quality::minor7 || q == Quality::minorAdd9 || q == Quality::minor9;
+    }
+
+    int lowestSetBit (juce::uint64 word) noexcept
+    {
+        const auto lo = (juce::uint32) word;
+        if (lo != 0)
+            return juce::findHighestSetBit (lo & (0u - lo));
+
+        const auto hi = (juce::uint32) (word >> 32);
+        return 32 + juce::findHighestSetBit (hi & (0u - hi));
+    }
+}
+
+//==============================================================================
+void ChordRecognizer::build (const int* columnRoots)
+{
+    for (int col = 0; col < 12; ++col)
+        columnOfPitchClass[columnRoots[col] % 12] = (juce::int8) col;
+
+    for (auto& e : table)
+        e = Entry();
+
+    for (int set = 1; set < 4096; ++set)
+    {
+        auto& e = table[set];
+        int   n = 0;
+
+        for (const auto& t : kTemplates)
+        {
+            for (int root = 0; root < 12 && n < 2; ++root)
+            {
+                if (rotateDown (set, root) != t.intervals || (n == 1 && e.root[0] == root))
+                    continue;
+
+                e.root[n]    = (juce::int8) root;
+                e.quality[n] = t.quality;
+                ++n;
+            }
+        }
+    }
+
+    reset();
+}
+
+void ChordRecognizer::reset() noexcept
+{
+    std::memset (noteCount, 0, sizeof (noteCount));
+    std::memset (pitchClassCount, 0, sizeof (pitchClassCount));
+    noteBits[0] = noteBits[1] = 0;
+    pitchClassSet = 0;
+    chord = Chord();
+}
+
+//==============================================================================
+bool ChordRecognizer::handle (const juce::uint8* data, int size) noexcept
+{
+    if (size < 3)
+        return false;
+
+    const auto type = data[0] & 0xf0;
+
+    if (type == 0x90 && data[2] > 0)
+        return noteOn (data[1] & 0x7f);
+
+    if (type == 0x80 || type == 0x90)
+        return noteOff (data[1] & 0x7f);
+
+    // All Notes Off / All Sound Off.
+    if (type == 0xb0 && (data[1] == 120 || data[1] == 123) && pitchClassSet != 0)
+    {
+        reset();
+        return true;
+    }
+
+    return false;
+}
+
+bool ChordRecognizer::noteOn (int note) noexcept
+{
+    if (noteCount[note]++ > 0)
+        return false;
+
+    noteBits[note >> 6] |= (juce::uint64) 1 << (note & 63);
+    if (pitchClassCount[note % 12]++ == 0)
+        pitchClassSet |= 1 << (note % 12);
+
+    return update();
+}
+
+bool ChordRecognizer::noteOff (int note) noexcept
+{
+    if (noteCount[note] == 0 || --noteCount[note] > 0)
+        return false;
+
+    noteBits[note >> 6] &= ~((juce::uint64) 1 << (note & 63));
+    if (--pitchClassCount[note % 12] == 0)
+        pitchClassSet &= ~(1 << (note % 12));
+
+    return update();
+}
+
+int ChordRecognizer::lowestNote() const noexcept
+{
+    if (noteBits[0] != 0)
+        return lowestSetBit (noteBits[0]);
+
+    return noteBits[1] != 0 ? 64 + lowestSetBit (noteBits[1]) : -1;
+}
+
+bool ChordRecognizer::update() noexcept
+{
+    const int  lowest = lowestNote();
+    const auto next   = lowest < 0 ? Chord()
+                                   : recognize (pitchClassSet, lowest % 12, pitchClassCount[lowest % 12] == 1);
+
+    if (next == chord)
+        return false;
+
+    chord = next;
+    return true;
+}
+
+ChordRecognizer::Chord ChordRecognizer::recognize (int set, int bass, bool bassSoundsOnce) const noexcept
+{
+    Chord c;
+    c.bass = (juce::int8) bass;
+
+    const auto* e = &table[set & 0xfff];
+    if (e->root[0] < 0 && bassSoundsOnce)
+        e = &table[set & ~(1 << bass) & 0xfff];
+
+    if (e->root[0] < 0)
+        return c;
+
+    const int pick = e->root[1] == bass ? 1 : 0;
+    c.root    = e->root[pick];
+    c.quality = e->quality[pick];
+    return c;
+}
+
+//==============================================================================
+ChordRecognizer::Cells ChordRecognizer::toCells (const Chord& c) const noexcept
+{
+    Cells cells;
+
+    if (c.root >= 0)
+    {
+        cells.chordRow = (juce::int8) (isMinorQuality (c.quality) ? 3 : 2);
+        cells.chordCol = columnOfPitchClass[c.root];
+        cells.seventh  = c.quality == Quality::dominant7 || c.quality == Quality::minor7
+                      || c.quality == Quality::dominant9 || c.quality == Quality::minor9;
+        cells.ninth    = c.quality == Quality::majorAdd9 || c.quality == Quality::minorAdd9
+                      || c.quality == Quality::dominant9 || c.quality == Quality::minor9;
+    }
+
+    if (c.bass >= 0)
+    {
+        // The Third row of a column sounds its root's major 3rd.
+        if (c.root >= 0 && c.bass == (c.root + 4) % 12)
+        {
+            cells.bassRow = 0;
+            cells.bassCol = columnOfPitchClass[c.root];
+        }
+        else
+        {
+            cells.bassRow = 1;
+            cells.bassCol = columnOfPitchClass[c.bass];
+        }
+    }
+
+    return cells;
+}
+
+juce::uint64 ChordRecognizer::Cells::mask() const noexcept
+{
+    juce::uint64 m = 0;
+    if (chordRow >= 0) m |= (juce::uint64) 1 << (chordRow * 12 + chordCol);
+    if (bassRow  >= 0) m |= (juce::uint64) 1 << (bassRow  * 12 + bassCol);
+    return m;
+}
+
+juce::String ChordRecognizer::getName (const Chord& c)
+{
+    static const char* pitchNames[12] = { "C", "Db", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B" };
+    static const char* suffixes[(int) Quality::numQualities] = { "", "", "m", "7", "m7", "add9", "madd9", "9", "m9" };
+
+    if (c.bass < 0)
+        return "-";
+
+    if (c.root < 0)
+        return juce::String ("? / ") + pitchNames[c.bass];
+
+    juce::String name (pitchNames[c.root]);
+    name << suffixes[(int) c.quality];
+    if (c.bass != c.root)
+        name << "/" << pitchNames[c.bass];
+    return name;
+}
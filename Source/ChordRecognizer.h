@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Chord recognizer for incoming (piano-played) MIDI.
+
+    The sounding notes are kept as a 12-bit pitch-class set, and a 4096-entry
+    table built once maps every set to the chords it spells (root and
+    quality; up to two readings for the rare ambiguous sets).  Each note-on
+    or note-off is therefore O(1): update the set, one table lookup, then
+    the lowest-pitch rule:
+
+      - the lowest sounding note is the bass;
+      - when a set has two readings, the one rooted on the bass wins;
+      - when the set spells no chord and the bass pitch class sounds only
+        once, the set without it is tried, so "C/Bb" reads as C over Bb.
+
+    Inversions therefore need no special casing: E-G-C is C major over E.
+
+    Qualities are the ones the grid can play: major and minor triads, with
+    the 7th (left mouse) and/or 9th (right mouse) extension, 7th chords with
+    or without their 5th.  toCells() maps a chord to the chord cell plus the
+    bass cell for its lowest note (the Third row when the bass is the major
+    3rd of the root).
+
+    Audio thread safe: nothing allocates after build().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class ChordRecognizer
+{
+public:
+    //==============================================================================
+    enum class Quality : juce::uint8
+    {
+        none = 0,
+        major, minor,
+        dominant7, minor7,
+        majorAdd9, minorAdd9,
+        dominant9, minor9,
+        numQualities
+    };
+
+    struct Chord
+    {
+        juce::int8 root    = -1;              ///< pitch class 0-11, -1 = no chord
+        Quality    quality = Quality::none;
+        juce::int8 bass    = -1;              ///< pitch class of the lowest note, -1 = silence
+
+        bool operator== (const Chord& o) const noexcept { return root == o.root && quality == o.quality && bass == o.bass; }
+        bool operator!= (const Chord& o) const noexcept { return ! (*this == o); }
+    };
+
+    /** The grid cells that play a chord.  Rows follow the processor's RowType
+        (0 = Third, 1 = Bass, 2 = Major, 3 = Minor); -1 = no cell. */
+    struct Cells
+    {
+        juce::int8 chordRow = -1, chordCol = -1;
+        bool       seventh  = false;   ///< played with the left mouse button
+        bool       ninth    = false;   ///< played with the right mouse button
+        juce::int8 bassRow  = -1, bassCol  = -1;
+
+        /** One bit per cell, bit = row * 12 + col (as UiSnapshot::heldCells). */
+        juce::uint64 mask() const noexcept;
+    };
+
+    //==============================================================================
+    ChordRecognizer() = default;
+
+    /** Builds the pitch-class table.  columnRoots are the bass root notes of
+        the 12 grid columns. */
+    void build (const int* columnRoots);
+
+    /** Forgets every sounding note. */
+    void reset() noexcept;
+
+    /** Feeds one MIDI event; anything but a note-on/off is ignored.  Returns
+        true when the recognized chord changed. */
+    bool handle (const juce::uint8* data, int size) noexcept;
+
+    const Chord& getChord() const noexcept   { return chord; }
+    Cells        toCells (const Chord& c) const noexcept;
+
+    /** O(1) table lookup with the lowest-pitch rule (see above). */
+    Chord recognize (int pitchClassSet, int bassPitchClass, bool bassSoundsOnce) const noexcept;
+
+    static juce::String getName (const Chord& c);
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        juce::int8 root[2]    { -1, -1 };
+        Quality    quality[2] { Quality::none, Quality::none };
+    };
+
+    bool noteOn  (int note) noexcept;
+    bool noteOff (int note) noexcept;
+    bool update() noexcept;
+    int  lowestNote() const noexcept;
+
+    Entry      table[4096];
+    juce::int8 columnOfPitchClass[12] {};
+
+    juce::uint8  noteCount[128] {};
+    juce::uint64 noteBits[2]    {};
+    juce::uint8  pitchClassCount[12] {};
+    int          pitchClassSet = 0;
+    Chord        chord;
+};
@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Expression response curve tables implementation.
+
+  ==============================================================================
+*/
+
+#include "CurveBank.h"
+
+namespace
+{
+    // Drawn points closer than this in x are merged (keeps the spline's
+    // segment widths well away from zero).
+    constexpr float kMinPointSpacing = 1.0e-3f;
+
+    juce::Array<juce::Point<float>> straightLine()
+    {
+        return { { 0.0f, 0.0f }, { 1.0f, 1.0f } };
+    }
+}
+
+//==============================================================================
+juce::String CurveBank::getShortName (Curve c)
+{
+    switch (c)
+    {
+        case Curve::linear:      return "Lin";
+        case Curve::exponential: return "Exp";
+        case Curve::logarithmic: return "Log";
+        case Curve::sCurve:      return "S";
+        case Curve::drawn:       return "Drawn";
+        case Curve::numCurves:
+        default:                 return {};
+    }
+}
+
+void CurveBank::Tables::evaluate (const int* rows, const float* in, float* out, int num) const noexcept
+{
+    for (int n = 0; n < num; ++n)
+    {
+        const float  pos = juce::jlimit (0.0f, 1.0f, in[n]) * (float) kTableSize;
+        const int    i   = juce::jmin ((int) pos, kTableSize - 1);
+        const float* t   = values + rows[n] + i;
+        out[n] = t[0] + (pos - (float) i) * (t[1] - t[0]);
+    }
+}
+
+//==============================================================================
+CurveBank::CurveBank()
+    : blocks (new Tables[4]),
+      drawnPoints (straightLine())
+{
+    fillPresets (blocks[0]);
+    fillSpline (blocks[0].values + (int) Curve::drawn * kStride, drawnPoints);
+
+    for (int i = 1; i < 4; ++i)
+        blocks[i] = blocks[0];
+
+    messageTables = &blocks[3];
+}
+
+const CurveBank::Tables& CurveBank::getDefaultTables()
+{
+    static const auto tables = []
+    {
+        auto t = std::make_unique<Tables>();
+        fillPresets (*t);
+        fillSpline (t->values + (int) Curve::drawn * kStride, straightLine());
+        return t;
+    }();
+
+    return *tables;
+}
+
+void CurveBank::fillPresets (Tables& t) noexcept
+{
+    auto fill = [&t] (Curve curve, auto&& fn)
+    {
+        float* row = t.values + (int) curve * kStride;
+        for (int i = 0; i <= kTableSize; ++i)
+            row[i] = juce::jlimit (0.0f, 1.0f, (float) fn ((double) i / kTableSize));
+    };
+
+    fill (Curve::linear,      [] (double x) { return x; });
+    fill (Curve::exponential, [] (double x) { return x * x; });
+    fill (Curve::logarithmic, [] (double x) { return std::sqrt (x); });
+    fill (Curve::sCurve,      [] (double x) { return x * x * (3.0 - 2.0 * x); });
+}
+
+// Monotone cubic Hermite interpolation (Fritsch–Carlson): the tangents are
+// limited so that no segment leaves the range of its two end points.
+void CurveBank::fillSpline (float* row, const juce::Array<juce::Point<float>>& points) noexcept
+{
+    const int n = points.size();
+    jassert (n >= 2 && n <= kMaxPoints);
+
+    double secant[kMaxPoints] {};
+    double tangent[kMaxPoints] {};
+
+    for (int k = 0; k < n - 1; ++k)
+        secant[k] = (double) (points[k + 1].y - points[k].y) / (double) (points[k + 1].x - points[k].x);
+
+    tangent[0]     = secant[0];
+    tangent[n - 1] = secant[n - 2];
+
+    for (int k = 1; k < n - 1; ++k)
+        tangent[k] = secant[k - 1] * secant[k] <= 0.0 ? 0.0 : 0.5 * (secant[k - 1] + secant[k]);
+
+    for (int k = 0; k < n - 1; ++k)
+    {
+        if (secant[k] == 0.0)
+        {
+            tangent[k] = tangent[k + 1] = 0.0;
+            continue;
+        }
+
+        const double a = tangent[k] / secant[k];
+        const double b = tangent[k + 1] / secant[k];
+        const double s = a * a + b * b;
+
+        if (s > 9.0)
+        {
+            const double scale = 3.0 / std::sqrt (s);
+            tangent[k]     = scale * a * secant[k];
+            tangent[k + 1] = scale * b * secant[k];
+        }
+    }
+
+    int k = 0;
+    for (int i = 0; i <= kTableSize; ++i)
+    {
+        const double x = (double) i / kTableSize;
+        while (k < n - 2 && x > (double) points[k + 1].x)
+            ++k;
+
+        const double x0 = points[k].x, x1 = points[k + 1].x;
+        const double y0 = points[k].y, y1 = points[k + 1].y;
+        const double h  = x1 - x0;
+        const double t  = (x - x0) / h;
+        const double t2 = t * t, t3 = t2 * t;
+
+        const double y = (2.0 * t3 - 3.0 * t2 + 1.0) * y0
+                       + (t3 - 2.0 * t2 + t)        * h * tangent[k]
+                       + (-2.0 * t3 + 3.0 * t2)     * y1
+                       + (t3 - t2)                  * h * tangent[k + 1];
+
+        row[i] = juce::jlimit (0.0f, 1.0f, (float) y);
+    }
+}
+
+//==============================================================================
+void CurveBank::setDrawnCurve (const juce::Array<juce::Point<float>>& points)
+{
+    juce::Array<juce::Point<float>> sorted;
+    for (auto p : points)
+        sorted.add ({ juce::jlimit (0.0f, 1.0f, p.x), juce::jlimit (0.0f, 1.0f, p.y) });
+
+    std::sort (sorted.begin(), sorted.end(),
+               [] (juce::Point<float> a, juce::Point<float> b) { return a.x < b.x; });
+
+    juce::Array<juce::Point<float>> cleaned;
+    for (auto p : sorted)
+        if (cleaned.isEmpty() || p.x - cleaned.getLast().x >= kMinPointSpacing)
+            cleaned.add (p);
+
+    if (cleaned.isEmpty() || cleaned.getFirst().x >= kMinPointSpacing)
+        cleaned.insert (0, { 0.0f, 0.0f });
+    else
+        cleaned.getReference (0).x = 0.0f;
+
+    if (cleaned.getLast().x < 1.0f - kMinPointSpacing)
+        cleaned.add ({ 1.0f, 1.0f });
+    else
+        cleaned.getReference (cleaned.size() - 1).x = 1.0f;
+
+    // Too many: keep the first ones and the end point.
+    while (cleaned.size() > kMaxPoints)
+        cleaned.remove (cleaned.size() - 2);
+
+    drawnPoints = cleaned;
+
+    float* messageRow = messageTables->values + (int) Curve::drawn * kStride;
+    fillSpline (messageRow, drawnPoints);
+
+    // Publish: write the spare block's row, then swap it in for the audio
+    // thread.  Only the drawn row ever differs between the blocks.
+    auto& block = blocks[writeIndex];
+    std::copy (messageRow, messageRow + kStride, block.values + (int) Curve::drawn * kStride);
+    writeIndex = spareIndex.exchange (writeIndex | kFreshBit, std::memory_order_acq_rel) & 3;
+}
+
+const CurveBank::Tables& CurveBank::acquire() noexcept
+{
+    if ((spareIndex.load (std::memory_order_acquire) & kFreshBit) != 0)
+        readIndex = spareIndex.exchange (readIndex, std::memory_order_acq_rel) & 3;
+
+    return blocks[readIndex];
+}
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Expression response curves as precomputed lookup tables.
+
+    Every curve is a table of kTableSize + 1 points over 0..1, read with
+    linear interpolation, so a lookup costs the same whatever the curve's
+    shape and the input keeps its full resolution until the output is
+    quantised.  The presets are built once; the drawn curve is a monotone
+    cubic spline through up to kMaxPoints points placed in the Expression
+    window (end points included), so it cannot overshoot 0..1.
+
+    All curves sit in one Tables block, one row per curve.  The message
+    thread (mouse expression, curve editor) reads its own copy; the audio
+    thread (modulation matrix) reads through a triple buffer: a new drawn
+    curve is written to a spare block and swapped in with one atomic
+    exchange, so processBlock never waits and never sees a half-written
+    table.  Neither side allocates.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class CurveBank
+{
+public:
+    //==============================================================================
+    static constexpr int kTableSize = 1024;             ///< intervals per curve
+    static constexpr int kStride    = kTableSize + 1;   ///< points per curve row
+    static constexpr int kMaxPoints = 8;                ///< drawn curve, end points included
+
+    enum class Curve : juce::uint8
+    {
+        linear = 0,
+        exponential,    ///< x²
+        logarithmic,    ///< √x
+        sCurve,         ///< smoothstep
+        drawn,
+        numCurves
+    };
+
+    static constexpr int kNumCurves = (int) Curve::numCurves;
+
+    /** Short label for narrow selectors ("Lin", "Exp", ...). */
+    static juce::String getShortName (Curve c);
+
+    //==============================================================================
+    struct Tables
+    {
+        float values[kNumCurves * kStride];
+
+        /** Curve value at x (clamped to 0..1). */
+        float evaluate (Curve curve, float x) const noexcept
+        {
+            const float pos = juce::jlimit (0.0f, 1.0f, x) * (float) kTableSize;
+            const int   i   = juce::jmin ((int) pos, kTableSize - 1);
+            const float* t  = values + (int) curve * kStride + i;
+            return t[0] + (pos - (float) i) * (t[1] - t[0]);
+        }
+
+        /** Batch lookup: out[n] = curve value at in[n], where rows[n] is the
+            curve's row offset (curve index * kStride).  Branch-free, so the
+            loop vectorises with gathers. */
+        void evaluate (const int* rows, const float* in, float* out, int num) const noexcept;
+    };
+
+    //==============================================================================
+    CurveBank();
+
+    /** Replaces the drawn curve (message thread).  Points are in 0..1 and
+        sorted by x here; end points at x = 0 and 1 are added if missing. */
+    void setDrawnCurve (const juce::Array<juce::Point<float>>& points);
+
+    /** The drawn curve's points, end points included (message thread). */
+    const juce::Array<juce::Point<float>>& getDrawnPoints() const noexcept   { return drawnPoints; }
+
+    /** Message thread's view of the curves. */
+    const Tables& getTables() const noexcept   { return *messageTables; }
+
+    /** Audio thread's view: the latest published curves.  Call once per
+        block; the reference stays valid until the next call. */
+    const Tables& acquire() noexcept;
+
+    /** Preset curves with a straight drawn curve; for code without a bank. */
+    static const Tables& getDefaultTables();
+
+private:
+    //==============================================================================
+    static void fillPresets (Tables& t) noexcept;
+    static void fillSpline  (float* row, const juce::Array<juce::Point<float>>& points) noexcept;
+
+    static constexpr int kFreshBit = 4;
+
+    // Three blocks for the audio side plus the message thread's own.
+    std::unique_ptr<Tables[]> blocks;
+    Tables*                   messageTables = nullptr;
+
+    int              writeIndex = 0;                 ///< message thread
+    int              readIndex  = 2;                 ///< audio thread
+    std::atomic<int> spareIndex { 1 };               ///< | kFreshBit when published
+
+    juce::Array<juce::Point<float>> drawnPoints;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CurveBank)
+};
@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Response curve display and editor implementation.
+
+  ==============================================================================
+*/
+
+#include "CurveEditorComponent.h"
+
+namespace
+{
+    constexpr float kPointRadius   = 4.0f;
+    constexpr float kHitRadius     = 7.0f;
+    constexpr float kPointSpacing  = 0.01f;   // closest two drawn points may get in x
+    constexpr int   kPlotSegments  = 128;
+}
+
+//==============================================================================
+CurveEditorComponent::CurveEditorComponent (CurveBank& bank)
+    : curveBank (bank)
+{
+}
+
+void CurveEditorComponent::setCurve (CurveBank::Curve newCurve)
+{
+    curve        = newCurve;
+    draggedPoint = -1;
+    setMouseCursor (isEditable() ? juce::MouseCursor::CrosshairCursor : juce::MouseCursor::NormalCursor);
+    repaint();
+}
+
+//==============================================================================
+juce::Rectangle<float> CurveEditorComponent::getPlotArea() const
+{
+    return getLocalBounds().toFloat().reduced (kPointRadius + 2.0f);
+}
+
+juce::Point<float> CurveEditorComponent::toScreen (juce::Point<float> p) const
+{
+    const auto area = getPlotArea();
+    return { area.getX() + p.x * area.getWidth(), area.getBottom() - p.y * area.getHeight() };
+}
+
+juce::Point<float> CurveEditorComponent::toCurve (juce::Point<float> p) const
+{
+    const auto area = getPlotArea();
+    return { juce::jlimit (0.0f, 1.0f, (p.x - area.getX()) / area.getWidth()),
+             juce::jlimit (0.0f, 1.0f, (area.getBottom() - p.y) / area.getHeight()) };
+}
+
+int CurveEditorComponent::findPoint (juce::Point<float> pos) const
+{
+    const auto& points = curveBank.getDrawnPoints();
+    for (int i = 0; i < points.size(); ++i)
+        if (toScreen (points[i]).getDistanceFrom (pos) <= kHitRadius)
+            return i;
+
+    return -1;
+}
+
+//==============================================================================
+void CurveEditorComponent::paint (juce::Graphics& g)
+{
+    const auto area = getPlotArea();
+
+    g.setColour (juce::Colour (0xff1e1e2e));
+    g.fillRect (getLocalBounds());
+    g.setColour (juce::Colours::grey);
+    g.drawRect (getLocalBounds());
+
+    // Quarter grid and the straight line for reference.
+    g.setColour (juce::Colours::white.withAlpha (0.08f));
+    for (int i = 1; i < 4; ++i)
+    {
+        const float f = (float) i / 4.0f;
+        g.drawVerticalLine   (juce::roundToInt (area.getX() + f * area.getWidth()), area.getY(), area.getBottom());
+        g.drawHorizontalLine (juce::roundToInt (area.getY() + f * area.getHeight()), area.getX(), area.getRight());
+    }
+    g.drawLine ({ toScreen ({ 0.0f, 0.0f }), toScreen ({ 1.0f, 1.0f }) });
+
+    // The curve as the tables return it.
+    const auto& tables = curveBank.getTables();
+    juce::Path path;
+    for (int i = 0; i <= kPlotSegments; ++i)
+    {
+        const float x = (float) i / kPlotSegments;
+        const auto  p = toScreen ({ x, tables.evaluate (curve, x) });
+        if (i == 0)
+            path.startNewSubPath (p);
+        else
+            path.lineTo (p);
+    }
+
+    g.setColour (juce::Colours::orange);
+    g.strokePath (path, juce::PathStrokeType (2.0f));
+
+    if (! isEditable())
+        return;
+
+    for (const auto& point : curveBank.getDrawnPoints())
+    {
+        const auto p = toScreen (point);
+        g.setColour (juce::Colours::white);
+        g.fillEllipse (p.x - kPointRadius, p.y - kPointRadius, 2.0f * kPointRadius, 2.0f * kPointRadius);
+    }
+}
+
+//==============================================================================
+void CurveEditorComponent::mouseDown (const juce::MouseEvent& e)
+{
+    if (! isEditable())
+        return;
+
+    draggedPoint = findPoint (e.position);
+    if (draggedPoint >= 0)
+        return;
+
+    auto points = curveBank.getDrawnPoints();
+    if (points.size() >= CurveBank::kMaxPoints)
+        return;
+
+    const auto added = toCurve (e.position);
+    points.add (added);
+    curveBank.setDrawnCurve (points);
+
+    // The bank sorts the points; drag the new one wherever it landed.
+    const auto& sorted = curveBank.getDrawnPoints();
+    for (int i = 0; i < sorted.size(); ++i)
+        if (sorted[i] == added)
+            draggedPoint = i;
+
+    repaint();
+}
+
+void CurveEditorComponent::mouseDrag (const juce::MouseEvent& e)
+{
+    if (! isEditable() || draggedPoint < 0)
+        return;
+
+    auto points = curveBank.getDrawnPoints();
+    if (draggedPoint >= points.size())
+        return;
+
+    auto p = toCurve (e.position);
+    const int last = points.size() - 1;
+
+    // End points only move up and down; the others stay between their
+    // neighbours so the point order (and the drag) never changes.  Points
+    // closer than that (restored state may have them 1e-3 apart) keep their x.
+    if (draggedPoint == 0)
+        p.x = 0.0f;
+    else if (draggedPoint == last)
+        p.x = 1.0f;
+    else
+    {
+        const float lo = points[draggedPoint - 1].x + kPointSpacing;
+        const float hi = points[draggedPoint + 1].x - kPointSpacing;
+
+        p.x = lo <= hi ? juce::jlimit (lo, hi, p.x) : points[draggedPoint].x;
+    }
+
+    points.set (draggedPoint, p);
+    curveBank.setDrawnCurve (points);
+    repaint();
+}
+
+void CurveEditorComponent::mouseUp (const juce::MouseEvent&)
+{
+    draggedPoint = -1;
+}
+
+void CurveEditorComponent::mouseDoubleClick (const juce::MouseEvent& e)
+{
+    if (! isEditable())
+        return;
+
+    const int index = findPoint (e.position);
+    auto points = curveBank.getDrawnPoints();
+
+    if (index <= 0 || index >= points.size() - 1)
+        return;
+
+    points.remove (index);
+    curveBank.setDrawnCurve (points);
+    draggedPoint = -1;
+    repaint();
+}
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Response curve display and editor for the Expression window.
+
+    Shows the selected CurveBank curve as it is looked up (input along x,
+    output up).  For the drawn curve its points are shown and edited:
+    click to add a point (up to CurveBank::kMaxPoints), drag to move one,
+    double-click to remove it.  The end points stay at x = 0 and 1 but can
+    be moved up and down.  Every edit goes straight to
+    CurveBank::setDrawnCurve().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CurveBank.h"
+
+//==============================================================================
+class CurveEditorComponent  : public juce::Component
+{
+public:
+    //==============================================================================
+    explicit CurveEditorComponent (CurveBank& bank);
+
+    /** The curve to show; only CurveBank::Curve::drawn can be edited. */
+    void setCurve (CurveBank::Curve curve);
+
+    //==============================================================================
+    void paint (juce::Graphics&) override;
+
+    void mouseDown        (const juce::MouseEvent&) override;
+    void mouseDrag        (const juce::MouseEvent&) override;
+    void mouseUp          (const juce::MouseEvent&) override;
+    void mouseDoubleClick (const juce::MouseEvent&) override;
+
+private:
+    //==============================================================================
+    juce::Rectangle<float> getPlotArea() const;
+    juce::Point<float>     toScreen (juce::Point<float> curvePoint) const;
+    juce::Point<float>     toCurve  (juce::Point<float> screenPoint) const;
+
+    /** Index of the drawn point under pos, or -1. */
+    int findPoint (juce::Point<float> pos) const;
+
+    bool isEditable() const noexcept   { return curve == CurveBank::Curve::drawn; }
+
+    CurveBank&        curveBank;
+    CurveBank::Curve  curve         = CurveBank::Curve::linear;
+    int               draggedPoint  = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CurveEditorComponent)
+};
@@ -0,0 +1,288 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Direct MIDI output implementation.
+
+  ==============================================================================
+*/
+
+#include "DirectMidiOutput.h"
+
+//==============================================================================
+namespace
+{
+    static bool isNoteOnBytes (const juce::uint8* d, int size)
+    {
+        return size == 3 && (d[0] & 0xf0) == 0x90 && d[2] != 0;
+    }
+
+    static bool isNoteOffBytes (const juce::uint8* d, int size)
+    {
+        return size == 3 && ((d[0] & 0xf0) == 0x80 || ((d[0] & 0xf0) == 0x90 && d[2] == 0));
+    }
+
+    // Note-offs and channel-mode messages (All Notes Off etc.): losing one
+    // leaves a note hanging on the device.
+    static bool isReleaseBytes (const juce::uint8* d, int size)
+    {
+        return isNoteOffBytes (d, size) || (size == 3 && (d[0] & 0xf0) == 0xb0 && d[1] >= 120);
+    }
+}
+
+//==============================================================================
+DirectMidiOutput::DirectMidiOutput()
+    : juce::Thread ("StraDella direct MIDI")
+{
+}
+
+DirectMidiOutput::~DirectMidiOutput()
+{
+    close();
+}
+
+bool DirectMidiOutput::isAvailable()
+{
+    return juce::PluginHostType::getPluginLoadedAs() == juce::AudioProcessor::wrapperType_Standalone;
+}
+
+bool DirectMidiOutput::open (const juce::String& identifier)
+{
+    close();
+
+    auto device = juce::MidiOutput::openDevice (identifier);
+    if (device == nullptr)
+        return false;
+
+    output           = std::move (device);
+    deviceIdentifier = identifier;
+    numWaiting       = 0;
+    numDelayed.store (0);
+    fifo.reset();
+
+    isOpen.store (true);
+    startThread (juce::Thread::Priority::highest);
+    return true;
+}
+
+void DirectMidiOutput::close()
+{
+    if (! isOpen.exchange (false))
+        return;
+
+    signalThreadShouldExit();
+    wake.signal();
+    stopThread (1000);
+
+    // Anything still sounding on the device would otherwise hang forever.
+    for (int ch = 1; ch <= 16; ++ch)
+        output->sendMessageNow (juce::MidiMessage::allNotesOff (ch));
+
+    output.reset();
+    deviceIdentifier.clear();
+}
+
+//==============================================================================
+void DirectMidiOutput::send (const juce::MidiMessage& message, juce::int64 inputTicks, int cell)
+{
+    if (! isOpen.load())
+        return;
+
+    const auto* data    = message.getRawData();
+    const int   size    = message.getRawDataSize();
+    const auto  delayMs = message.getTimeStamp();
+
+    if (size > 3)
+    {
+        const juce::ScopedLock sl (sendLock);
+        output->sendMessageNow (message);
+        return;
+    }
+
+    // A note-off sent from here could overtake a rolled note-on the sender
+    // thread is about to send, leaving it stuck.  While any are waiting the
+    // note-off goes through the sender thread instead, which drops the
+    // matching note-ons before sending it.
+    if (mode.load() == Mode::immediate && delayMs <= 0.0
+         && ! (isNoteOffBytes (data, size) && numDelayed.load() > 0))
+    {
+        sendNow (data, size, inputTicks);
+        return;
+    }
+
+    Pending p;
+    p.dueTicks   = juce::Time::getHighResolutionTicks()
+                 + (juce::int64) (delayMs * (double) juce::Time::getHighResolutionTicksPerSecond() / 1000.0);
+    p.inputTicks = delayMs > 0.0 ? 0 : inputTicks;   // rolled tones are late on purpose
+    p.size       = (juce::uint8) size;
+    p.cell       = (juce::int8) cell;
+    p.delayed    = delayMs > 0.0;
+    std::memcpy (p.data, data, (size_t) size);
+
+    // Counted before the push so the sender thread can never see it sent
+    // before it was counted.
+    if (p.delayed)
+        ++numDelayed;
+
+    if (! push (p) && p.delayed)
+        --numDelayed;
+}
+
+bool DirectMidiOutput::push (const Pending& p)
+{
+    const bool release = isReleaseBytes (p.data, p.size);
+
+    if (fifo.getFreeSpace() <= (release ? 0 : kReleaseReserve))
+    {
+        // Even the reserve is full: a release goes out now rather than never.
+        if (release)
+        {
+            sendNow (p.data, p.size, p.inputTicks);
+
+            if (p.delayed)
+                --numDelayed;
+
+            return true;
+        }
+
+        ++numDropped;
+        return false;
+    }
+
+    fifo.write (1).forEach ([&] (int index) { queue[index] = p; });
+    wake.signal();
+    return true;
+}
+
+void DirectMidiOutput::sendNow (const juce::uint8* data, int size, juce::int64 inputTicks)
+{
+    const juce::ScopedLock sl (sendLock);
+    output->sendMessageNow (juce::MidiMessage (data, size));
+
+    if (inputTicks > 0 && isNoteOnBytes (data, size))
+    {
+        const auto latency = juce::jmax ((juce::int64) 0, juce::Time::getHighResolutionTicks() - inputTicks);
+        ++latencyCount;
+        latencySum  += latency;
+        latencyLast.store (latency);
+        if (latency > latencyMax.load())
+            latencyMax.store (latency);
+    }
+}
+
+//==============================================================================
+void DirectMidiOutput::run()
+{
+    const double ticksPerMs = (double) juce::Time::getHighResolutionTicksPerSecond() / 1000.0;
+
+    while (! threadShouldExit())
+    {
+        const auto now = juce::Time::getHighResolutionTicks();
+
+        fifo.read (fifo.getNumReady()).forEach ([&] (int index) { accept (queue[index], now); });
+
+        // Send whatever is due, earliest first, and find the next due time.
+        juce::int64 nextDue = 0;
+
+        for (;;)
+        {
+            int earliest = -1;
+            for (int i = 0; i < numWaiting; ++i)
+                if (earliest < 0 || waiting[i].dueTicks < waiting[earliest].dueTicks)
+                    earliest = i;
+
+            if (earliest < 0)
+                break;
+
+            if (waiting[earliest].dueTicks > juce::Time::getHighResolutionTicks())
+            {
+                nextDue = waiting[earliest].dueTicks;
+                break;
+            }
+
+            const auto p = waiting[earliest];
+            waiting[earliest] = waiting[--numWaiting];
+            sendNow (p.data, p.size, p.inputTicks);
+
+            // Only once it is on the wire may a note-off bypass this thread.
+            if (p.delayed)
+                --numDelayed;
+        }
+
+        // Sleep until the next rolled tone is due, or until new input arrives.
+        if (nextDue == 0)
+        {
+            wake.wait (-1);
+        }
+        else
+        {
+            const auto waitMs = (int) ((double) (nextDue - juce::Time::getHighResolutionTicks()) / ticksPerMs);
+            if (waitMs > 0)
+                wake.wait (waitMs);
+        }
+    }
+}
+
+// Sender thread: handles one message from the queue.
+void DirectMidiOutput::accept (const Pending& p, juce::int64 now)
+{
+    if (isNoteOffBytes (p.data, p.size))
+        cancelWaitingNoteOns (p.data, p.cell);
+
+    if (p.dueTicks <= now || numWaiting >= kCapacity)
+    {
+        sendNow (p.data, p.size, p.inputTicks);
+
+        if (p.delayed)
+            --numDelayed;
+    }
+    else
+    {
+        waiting[numWaiting++] = p;
+    }
+}
+
+void DirectMidiOutput::cancelWaitingNoteOns (const juce::uint8* noteOff, int cell)
+{
+    const auto channel = noteOff[0] & 0x0f;
+
+    for (int i = numWaiting; --i >= 0;)
+    {
+        const auto& w = waiting[i];
+        if (isNoteOnBytes (w.data, w.size) && (w.data[0] & 0x0f) == channel && w.data[1] == noteOff[1]
+             && w.cell == cell)
+        {
+            if (w.delayed)
+                --numDelayed;
+
+            waiting[i] = waiting[--numWaiting];
+        }
+    }
+}
+
+//==============================================================================
+DirectMidiOutput::LatencyStats DirectMidiOutput::getLatencyStats() const noexcept
+{
+    const double ticksPerUs = (double) juce::Time::getHighResolutionTicksPerSecond() / 1.0e6;
+
+    LatencyStats s;
+    s.count   = latencyCount.load();
+    s.dropped = numDropped.load();
+
+    if (s.count > 0)
+    {
+        s.meanUs = (double) latencySum.load() / (double) s.count / ticksPerUs;
+        s.maxUs  = (double) latencyMax.load()  / ticksPerUs;
+        s.lastUs = (double) latencyLast.load() / ticksPerUs;
+    }
+
+    return s;
+}
+
+void DirectMidiOutput::resetLatencyStats() noexcept
+{
+    latencyCount.store (0);
+    latencySum.store   (0);
+    latencyMax.store   (0);
+    latencyLast.store  (0);
+}
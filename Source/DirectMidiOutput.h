@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Direct-to-device MIDI output for the standalone build.
+
+    In a host, every press waits for the next processBlock.  When running as
+    the standalone app this class can instead send the grid's messages to a
+    chosen MIDI output device as soon as the input is seen:
+
+      immediate     – MidiOutput::sendMessageNow() on the input thread itself
+                      (rolled chord tones still wait on the sender thread, and
+                      a note-off goes through it while any are waiting)
+      senderThread  – every message is handed to a high-priority sender
+                      thread, so the input thread never blocks on the driver
+
+    On Linux the device is opened through JUCE's ALSA sequencer backend;
+    sendMessageNow() writes the event directly to the sequencer, so both modes
+    work there unchanged.
+
+    Press-to-wire latency (input event timestamp → return from
+    sendMessageNow) is measured for every note-on.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class DirectMidiOutput : private juce::Thread
+{
+public:
+    //==============================================================================
+    enum class Mode { off = 0, immediate, senderThread };
+
+    DirectMidiOutput();
+    ~DirectMidiOutput() override;
+
+    /** True only in the standalone wrapper; plugin builds never send directly. */
+    static bool isAvailable();
+
+    /** Opens a device from MidiOutput::getAvailableDevices() and starts the
+        sender thread.  Must not run concurrently with send(): the processor
+        calls both with its message lock held. */
+    bool open (const juce::String& deviceIdentifier);
+    void close();
+
+    void setMode (Mode newMode) noexcept     { mode.store (newMode); }
+    Mode getMode() const noexcept            { return mode.load(); }
+
+    juce::String getDeviceIdentifier() const { return deviceIdentifier; }
+
+    /** True when messages should bypass processBlock. */
+    bool isActive() const noexcept           { return isOpen.load() && mode.load() != Mode::off; }
+
+    /** Sends or queues a message.  A non-zero timestamp is a delay in ms (as
+        used for rolled chord tones).  inputTicks is when the triggering input
+        was observed; cell is the grid cell the note belongs to (-1 = none),
+        and a note-off only cancels waiting note-ons of its own cell.  Callers
+        must be serialised (the processor calls this with its message lock
+        held): the queue has a single producer. */
+    void send (const juce::MidiMessage& message, juce::int64 inputTicks, int cell = -1);
+
+    //==============================================================================
+    struct LatencyStats
+    {
+        juce::int64 count  = 0;
+        double      meanUs = 0.0;
+        double      maxUs  = 0.0;
+        double      lastUs = 0.0;
+        juce::int64 dropped = 0;   ///< note-ons etc. lost to a full sender queue
+    };
+
+    LatencyStats getLatencyStats() const noexcept;
+    void         resetLatencyStats() noexcept;
+
+private:
+    //==============================================================================
+    struct Pending
+    {
+        juce::int64 dueTicks   = 0;
+        juce::int64 inputTicks = 0;
+        juce::uint8 data[3]    {};
+        juce::uint8 size       = 0;
+        juce::int8  cell       = -1;      ///< owning grid cell, -1 = none
+        bool        delayed    = false;   ///< counted in numDelayed until sent
+    };
+
+    void run() override;
+    void sendNow (const juce::uint8* data, int size, juce::int64 inputTicks);
+    bool push (const Pending& p);
+    void accept (const Pending& p, juce::int64 now);
+    void cancelWaitingNoteOns (const juce::uint8* noteOff, int cell);
+
+    // The last kReleaseReserve queue slots only take note-offs and
+    // channel-mode messages, so a burst of note-ons cannot crowd them out.
+    static constexpr int kCapacity       = 1024;
+    static constexpr int kReleaseReserve = 128;
+
+    std::unique_ptr<juce::MidiOutput> output;
+    juce::CriticalSection             sendLock;   ///< input and sender thread may both send
+    juce::String                      deviceIdentifier;
+    std::atomic<bool>                 isOpen { false };
+    std::atomic<Mode>                 mode   { Mode::off };
+
+    // Producer → sender thread.
+    juce::AbstractFifo   fifo { kCapacity };
+    Pending              queue[kCapacity];
+    juce::WaitableEvent  wake;
+
+    // Sender thread only: messages waiting for their due time.
+    Pending              waiting[kCapacity];
+    int                  numWaiting = 0;
+    std::atomic<int>     numDelayed { 0 };   ///< delayed messages queued or waiting, not yet sent
+
+    std::atomic<juce::int64> latencyCount { 0 };
+    std::atomic<juce::int64> latencySum   { 0 };   // ticks
+    std::atomic<juce::int64> latencyMax   { 0 };   // ticks
+    std::atomic<juce::int64> latencyLast  { 0 };   // ticks
+    std::atomic<juce::int64> numDropped   { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DirectMidiOutput)
+};
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Focus-mode input capture surface implementation.
+
+  ==============================================================================
+*/
+
+#include "FocusCaptureOverlay.h"
+
+//==============================================================================
+FocusCaptureOverlay::FocusCaptureOverlay (juce::Component& keyTarget)
+    : target (keyTarget)
+{
+    // Nothing in this component ever calls repaint().
+    setOpaque (false);
+    setWantsKeyboardFocus (true);
+}
+
+FocusCaptureOverlay::~FocusCaptureOverlay()
+{
+    if (isOnDesktop())
+        removeFromDesktop();
+}
+
+bool FocusCaptureOverlay::canShowBehind (const juce::Component& uiWindow)
+{
+    return juce::PluginHostType::getPluginLoadedAs() == juce::AudioProcessor::wrapperType_Standalone
+        && uiWindow.isOnDesktop() && uiWindow.getParentComponent() == nullptr;
+}
+
+void FocusCaptureOverlay::showBehind (juce::Component& uiWindow, juce::Rectangle<int> screenArea)
+{
+    jassert (canShowBehind (uiWindow));
+
+    setBounds (screenArea);
+    addToDesktop (0);
+    setVisible (true);
+    toBehind (&uiWindow);
+}
+
+//==============================================================================
+// The lowest non-zero alpha: invisible, but some platforms pass clicks on
+// fully transparent pixels through to the window below.
+void FocusCaptureOverlay::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colour (0x01000000));
+}
+
+void FocusCaptureOverlay::mouseDown (const juce::MouseEvent&)
+{
+    // Clicks are captured here so they never reach the host; the mouse
+    // buttons themselves are read by the editor via ModifierKeys.
+    target.grabKeyboardFocus();
+}
+
+bool FocusCaptureOverlay::keyPressed (const juce::KeyPress& key)
+{
+    return target.keyPressed (key);
+}
+
+bool FocusCaptureOverlay::keyStateChanged (bool isKeyDown)
+{
+    return target.keyStateChanged (isKeyDown);
+}
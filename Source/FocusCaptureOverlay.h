@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Focus-mode input capture surface.
+
+    A borderless desktop window covering the display, placed behind the plugin
+    UI.  It swallows mouse clicks (so the host never steals focus while the
+    mouse buttons are used for chord extensions) and forwards key events to
+    the editor.  It paints almost nothing (see paint()), so the desktop stays
+    as it was; the editor keeps its own small, opaque window and dirty-rect
+    repaints.
+
+    Only usable when the UI is a top-level window of its own (the standalone
+    app): a host embeds the editor in one of its windows, which the overlay
+    cannot be ordered against, so it could end up covering the plugin UI.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class FocusCaptureOverlay  : public juce::Component
+{
+public:
+    //==============================================================================
+    /** keyTarget receives forwarded key events and is re-focused on every click. */
+    explicit FocusCaptureOverlay (juce::Component& keyTarget);
+    ~FocusCaptureOverlay() override;
+
+    /** True when uiWindow is a top-level desktop window the overlay can be
+        ordered behind (see the class description). */
+    static bool canShowBehind (const juce::Component& uiWindow);
+
+    /** Adds the overlay to the desktop over screenArea, ordered behind
+        uiWindow, which must pass canShowBehind(). */
+    void showBehind (juce::Component& uiWindow, juce::Rectangle<int> screenArea);
+
+    //==============================================================================
+    void paint (juce::Graphics&) override;
+
+    void mouseDown (const juce::MouseEvent&) override;
+
+    bool keyPressed      (const juce::KeyPress&) override;
+    bool keyStateChanged (bool isKeyDown)        override;
+
+private:
+    //==============================================================================
+    juce::Component& target;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FocusCaptureOverlay)
+};
@@ -0,0 +1,279 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Input glue between the raw mouse / keyboard events and the processor.
+
+  ==============================================================================
+*/
+
+#include "GridInputController.h"
+
+using Record = InputRecorder::Record;
+using Type   = InputRecorder::Type;
+
+//==============================================================================
+GridInputController::GridInputController (StraDellaMIDI_pluginAudioProcessor& processor,
+                                          MouseMidiExpression& expression)
+    : audioProcessor (processor),
+      mouseExpression (expression),
+      recorder (processor.getInputRecorder())
+{
+    mouseExpression.onDirectionChange = [this] { bellowsDirectionChanged(); };
+
+    mouseExpression.onPointerSources = [this] (float pointerY, float bellowsSpeed)
+    {
+        audioProcessor.setModulationSources (pointerY, bellowsSpeed);
+    };
+
+    // The velocity curve reads the processor's tables, drawn curve included.
+    mouseExpression.setCurveBank (&audioProcessor.getCurveBank());
+
+    // Live pointer samples: capture the button state that belongs to this
+    // sample (the retrigger uses it) and record the sample.
+    mouseExpression.onPointerSample = [this] (juce::Point<int> pos, juce::int64 ticks)
+    {
+        const auto mods = juce::ModifierKeys::getCurrentModifiers();
+        sampleButtons = buttonBits (mods.isLeftButtonDown(), mods.isRightButtonDown());
+        sampleTicks   = ticks;
+        recorder.push (InputRecorder::makePointer (ticks, pos, sampleButtons));
+    };
+
+    recorder.onSessionStart = [this] (InputRecorder::SessionHeader& header) { startSession (header); };
+}
+
+GridInputController::~GridInputController()
+{
+    recorder.stop();
+    recorder.onSessionStart = nullptr;
+
+    mouseExpression.onDirectionChange = nullptr;
+    mouseExpression.onPointerSample   = nullptr;
+    mouseExpression.onPointerSources  = nullptr;
+    mouseExpression.setCurveBank (nullptr);
+}
+
+//==============================================================================
+void GridInputController::mouseDown (int row, int col, bool leftDown, bool rightDown, juce::int64 ticks)
+{
+    recorder.push (InputRecorder::makeMouseDown (ticks, row, col, buttonBits (leftDown, rightDown)));
+
+    pressedRow = row;
+    pressedCol = col;
+    audioProcessor.buttonPressed (row, col, mouseExpression.getCurrentNoteVelocity(),
+                                  leftDown, rightDown, ticks);
+}
+
+void GridInputController::mouseUp (juce::int64 ticks)
+{
+    if (pressedRow < 0)
+        return;
+
+    recorder.push (InputRecorder::makeEmpty (Type::mouseUp, ticks));
+
+    audioProcessor.buttonReleased (pressedRow, pressedCol, ticks);
+    pressedRow = pressedCol = -1;
+}
+
+bool GridInputController::keyPressed (int keyCode, bool leftDown, bool rightDown, juce::int64 ticks)
+{
+    adoptKeyTable (ticks);
+    recorder.push (InputRecorder::makeKey (Type::keyDown, ticks, keyCode, buttonBits (leftDown, rightDown)));
+
+    intentBatch.clear();
+    const bool handled = keyboardEngine.handleKeyPressed (keyCode, ticks,
+                                                          mouseExpression.getCurrentNoteVelocity(),
+                                                          leftDown, rightDown, intentBatch);
+    applyIntentBatch();
+    return handled;
+}
+
+void GridInputController::panic (juce::int64 ticks)
+{
+    adoptKeyTable (ticks);
+    recorder.push (InputRecorder::makeEmpty (Type::panic, ticks));
+
+    // Release any currently held mouse button.
+    if (pressedRow >= 0)
+    {
+        audioProcessor.buttonReleased (pressedRow, pressedCol, ticks);
+        pressedRow = pressedCol = -1;
+    }
+
+    // Release every key held via the computer keyboard.
+    intentBatch.clear();
+    keyboardEngine.releaseAll (ticks, intentBatch);
+    applyIntentBatch();
+
+    // Broadcast All Notes Off + All Sound Off on all MIDI channels.
+    audioProcessor.sendAllNotesOff();
+}
+
+void GridInputController::pollMouseButtons (juce::int64 ticks)
+{
+    // Realtime: the buttons may go down outside the editor window.
+    const auto mods = juce::ModifierKeys::getCurrentModifiersRealtime();
+    mouseButtonsChanged (buttonBits (mods.isLeftButtonDown(), mods.isRightButtonDown()), ticks);
+}
+
+void GridInputController::mouseButtonsChanged (int buttons, juce::int64 ticks)
+{
+    if (buttons == heldButtons)
+        return;
+
+    recorder.push (InputRecorder::makeButtons (ticks, buttons));
+
+    heldButtons = buttons;
+    audioProcessor.setMouseButtons ((buttons & InputRecorder::leftButton)  != 0,
+                                    (buttons & InputRecorder::rightButton) != 0, ticks);
+}
+
+void GridInputController::replayPointerSample (juce::Point<int> pos, int buttons, juce::int64 ticks)
+{
+    sampleButtons = buttons;
+    sampleTicks   = ticks;
+    mouseExpression.processPointerSample (pos, ticks);
+}
+
+//==============================================================================
+// When the bellows direction changes, retrigger all held notes.
+void GridInputController::bellowsDirectionChanged()
+{
+    const int vel = mouseExpression.getCurrentNoteVelocity();
+
+    // Release + re-press every held cell, applied as one batch.
+    auto retrigger = [&] (int row, int col)
+    {
+        CellIntent intent;
+        intent.ticks = sampleTicks;
+        intent.row   = (juce::int8) row;
+        intent.col   = (juce::int8) col;
+        intentBatch.add (intent);
+
+        intent.isPress        = true;
+        intent.velocity       = (juce::uint8) juce::jlimit (0, 127, vel);
+        intent.leftMouseDown  = (sampleButtons & InputRecorder::leftButton)  != 0;
+        intent.rightMouseDown = (sampleButtons & InputRecorder::rightButton) != 0;
+        intentBatch.add (intent);
+    };
+
+    intentBatch.clear();
+    if (pressedRow >= 0)
+        retrigger (pressedRow, pressedCol);
+    keyboardEngine.forEachHeldCell (retrigger);
+    applyIntentBatch();
+}
+
+void GridInputController::setKeyTable (const KeyboardInputEngine::KeyTable& table, juce::int64 ticks)
+{
+    keyboardEngine.setTable (table);
+    recordKeyTable (ticks);
+}
+
+void GridInputController::adoptKeyTable (juce::int64 ticks)
+{
+    if (keyboardEngine.adoptPublishedTable())
+        recordKeyTable (ticks);
+}
+
+// The table in force, one keyMap record per key; the first one starts the
+// table (a lone key code -1 stands for an empty one).
+void GridInputController::recordKeyTable (juce::int64 ticks)
+{
+    if (! recorder.isRecording())
+        return;
+
+    bool first = true;
+    keyboardEngine.forEachMappedKey ([&] (int keyCode, int row, int col)
+    {
+        recorder.push (InputRecorder::makeKeyMap (ticks, keyCode, row, col, first));
+        first = false;
+    });
+
+    if (first)
+        recorder.push (InputRecorder::makeKeyMap (ticks, -1, -1, -1, true));
+}
+
+void GridInputController::applyIntentBatch()
+{
+    audioProcessor.applyCellIntents (intentBatch.intents, intentBatch.size);
+    intentBatch.clear();
+}
+
+//==============================================================================
+void GridInputController::pollSettings (juce::int64 ticks)
+{
+    if (! recorder.isRecording())
+        return;
+
+    auto pushIfChanged = [this] (const Record& r, Record& last)
+    {
+        if (r.size == last.size && std::memcmp (r.data, last.data, r.size) == 0)
+            return;
+
+        last = r;
+        recorder.push (r);
+    };
+
+    pushIfChanged (InputRecorder::makeVoicing     (ticks, audioProcessor.getVoicingSettings()), lastVoicing);
+    pushIfChanged (InputRecorder::makeExpression  (ticks, mouseExpression.getSettings()),       lastExpression);
+    pushIfChanged (InputRecorder::makeOutputStage (ticks, audioProcessor),                       lastOutputStage);
+
+    const auto modulation = audioProcessor.getModulationSettings();
+    if (! modulationRecorded || modulation != lastModulation)
+    {
+        for (int i = 0; i < ModulationMatrix::kMaxRoutes; ++i)
+            recorder.push (InputRecorder::makeModulation (ticks, modulation, i));
+
+        lastModulation     = modulation;
+        modulationRecorded = true;
+    }
+
+    const auto& curvePoints = audioProcessor.getCurveBank().getDrawnPoints();
+    if (! curveRecorded || curvePoints != lastCurvePoints)
+    {
+        for (int i = 0; i < curvePoints.size(); ++i)
+            recorder.push (InputRecorder::makeCurvePoint (ticks, curvePoints, i));
+
+        lastCurvePoints = curvePoints;
+        curveRecorded   = true;
+    }
+}
+
+// Called by InputRecorder::start(): the session begins with nothing held and
+// with the expression and processor in a state the replay can recreate.
+void GridInputController::startSession (InputRecorder::SessionHeader& header)
+{
+    const auto ticks = header.startTicks;
+
+    if (pressedRow >= 0)
+    {
+        audioProcessor.buttonReleased (pressedRow, pressedCol);
+        pressedRow = pressedCol = -1;
+    }
+
+    intentBatch.clear();
+    keyboardEngine.releaseAll (ticks, intentBatch);
+    applyIntentBatch();
+    audioProcessor.sendAllNotesOff();
+
+    header.screenBounds = mouseExpression.getScreenBounds();
+    header.pointer      = juce::Desktop::getInstance().getMainMouseSource().getScreenPosition().toInt();
+    header.randomSeed   = juce::Random::getSystemRandom().nextInt64();
+
+    mouseExpression.resetPointerState (header.pointer);
+    audioProcessor.beginInputSession (header.randomSeed);
+
+    // Forget what was last written so every setting is recorded up front.
+    lastVoicing = lastExpression = lastOutputStage = Record();
+    modulationRecorded = curveRecorded = false;
+    pollSettings (ticks);
+
+    // Likewise the mouse buttons, which a replay starts from as all up.
+    heldButtons = -1;
+    pollMouseButtons (ticks);
+
+    // And the key table: a replay starts from the built-in mapping.
+    keyboardEngine.adoptPublishedTable();
+    recordKeyTable (ticks);
+}
@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Input glue between the raw mouse / keyboard events and the processor.
+
+    Owns the keyboard engine and the mouse-held cell, wires the bellows
+    expression to the processor (modulation sources and direction-change
+    retrigger), and is
+    the single place where raw inputs are recorded into the processor's
+    InputRecorder.  The editor forwards its mouse and key callbacks here;
+    InputReplayer drives a second instance from a recorded session, so live
+    input and replay run exactly the same code.
+
+    Every entry point takes the input's high-resolution tick timestamp, so
+    nothing below reads a clock of its own.  Message thread only.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "MouseMidiExpression.h"
+#include "KeyboardInputEngine.h"
+#include "StradellaKeyboardMapper.h"
+
+//==============================================================================
+class GridInputController
+{
+public:
+    //==============================================================================
+    GridInputController (StraDellaMIDI_pluginAudioProcessor& processor, MouseMidiExpression& expression);
+    ~GridInputController();
+
+    /** Rebuilds the key → cell table from the mapper. */
+    void buildKeyTable (const StradellaKeyboardMapper& mapper)   { keyboardEngine.buildTable (mapper); }
+
+    /** Hands a new key table over from any thread (mapping reload).  It takes
+        effect, and is recorded, with the next key event or panic; keys held
+        at that point release the cells they were pressed with. */
+    void publishKeyTable (std::unique_ptr<KeyboardInputEngine::KeyTable> table)
+    {
+        keyboardEngine.publishTable (std::move (table));
+    }
+
+    /** Switches to table at once and records it (replay of a keyMap run). */
+    void setKeyTable (const KeyboardInputEngine::KeyTable& table, juce::int64 ticks);
+
+    void mouseDown (int row, int col, bool leftDown, bool rightDown, juce::int64 ticks);
+    void mouseUp   (juce::int64 ticks);
+
+    /** Returns false if the key is not mapped. */
+    bool keyPressed (int keyCode, bool leftDown, bool rightDown, juce::int64 ticks);
+
+    /** Releases every held key for which isKeyDown (keyCode) is false. */
+    template <typename IsKeyDown>
+    int keysReleased (juce::int64 ticks, IsKeyDown&& isKeyDown)
+    {
+        adoptKeyTable (ticks);
+
+        intentBatch.clear();
+        const int released = keyboardEngine.handleKeyReleased (ticks, intentBatch, [&] (int keyCode)
+        {
+            const bool down = isKeyDown (keyCode);
+            if (! down)
+                recorder.push (InputRecorder::makeKey (InputRecorder::Type::keyUp, ticks, keyCode, 0));
+            return down;
+        });
+        applyIntentBatch();
+        return released;
+    }
+
+    /** Releases everything held from the grid and sends All Notes Off. */
+    void panic (juce::int64 ticks);
+
+    /** Samples the global mouse buttons (editor timer) and passes a change to
+        mouseButtonsChanged(). */
+    void pollMouseButtons (juce::int64 ticks);
+
+    /** The mouse buttons (InputRecorder button bits) went down or up: held
+        chord cells gain or lose their 7th/9th. */
+    void mouseButtonsChanged (int buttons, juce::int64 ticks);
+
+    /** Feeds a recorded pointer sample through the expression (replay). */
+    void replayPointerSample (juce::Point<int> pos, int buttons, juce::int64 ticks);
+
+    /** Records any change to the voicing, expression, output-stage or
+        modulation settings since the last call.  Cheap no-op while not
+        recording. */
+    void pollSettings (juce::int64 ticks);
+
+    const KeyboardInputEngine& getKeyboardEngine() const noexcept { return keyboardEngine; }
+
+private:
+    //==============================================================================
+    void bellowsDirectionChanged();
+    void applyIntentBatch();
+    void startSession (InputRecorder::SessionHeader& header);
+    void adoptKeyTable (juce::int64 ticks);
+    void recordKeyTable (juce::int64 ticks);
+
+    static int buttonBits (bool leftDown, bool rightDown) noexcept
+    {
+        return (leftDown ? InputRecorder::leftButton : 0) | (rightDown ? InputRecorder::rightButton : 0);
+    }
+
+    StraDellaMIDI_pluginAudioProcessor& audioProcessor;
+    MouseMidiExpression&                mouseExpression;
+    InputRecorder&                      recorder;
+
+    // Cell held by the mouse (-1 = none).
+    int pressedRow = -1;
+    int pressedCol = -1;
+
+    KeyboardInputEngine              keyboardEngine;
+    KeyboardInputEngine::IntentBatch intentBatch;   ///< scratch, reused per event
+
+    // Buttons and time of the pointer sample being processed; the bellows
+    // retrigger reads these rather than the live modifier state.
+    int         sampleButtons = 0;
+    juce::int64 sampleTicks   = 0;
+
+    // Buttons last passed to the processor's setMouseButtons(); -1 = unknown.
+    int heldButtons = 0;
+
+    // Last settings written to the session, packed, for change detection.
+    InputRecorder::Record lastVoicing, lastExpression, lastOutputStage;
+
+    // Last modulation matrix written to the session (one record per route).
+    ModulationMatrix::Settings lastModulation;
+    bool                       modulationRecorded = false;
+
+    // Last drawn curve written to the session (one record per point).
+    juce::Array<juce::Point<float>> lastCurvePoints;
+    bool                            curveRecorded = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GridInputController)
+};
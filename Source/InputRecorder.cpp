@@ -0,0 +1,482 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Raw input session recorder (see header).
+
+  ==============================================================================
+*/
+
+#include "InputRecorder.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+    constexpr char         kMagic[4] = { 'S', 'D', 'I', 'S' };
+    constexpr juce::uint16 kVersion  = 5;   // 2: buttons records, 3: keyMap records, 4: modulation records,
+                                            // 5: curvePoint records
+
+    //==============================================================================
+    // Little-endian payload packing.
+    struct Packer
+    {
+        InputRecorder::Record& r;
+
+        void u8  (int v) noexcept          { r.data[r.size++] = (juce::uint8) v; }
+        void i16 (int v) noexcept          { u8 (v & 0xff); u8 ((v >> 8) & 0xff); }
+        void i32 (int v) noexcept          { i16 (v & 0xffff); i16 ((v >> 16) & 0xffff); }
+        void f32 (float v) noexcept        { juce::uint32 bits; std::memcpy (&bits, &v, 4); i32 ((int) bits); }
+    };
+
+    struct Unpacker
+    {
+        const InputRecorder::Record& r;
+        int pos = 0;
+
+        int u8() noexcept                  { return pos < r.size ? r.data[pos++] : 0; }
+        int i16() noexcept                 { const int lo = u8(); return (juce::int16) (lo | (u8() << 8)); }
+        int i32() noexcept                 { const auto lo = (juce::uint32) (juce::uint16) i16(); return (int) (lo | ((juce::uint32) i16() << 16)); }
+        float f32() noexcept               { const auto bits = (juce::uint32) i32(); float v; std::memcpy (&v, &bits, 4); return v; }
+    };
+
+    //==============================================================================
+    void writeVarInt (juce::OutputStream& out, juce::uint64 v)
+    {
+        while (v >= 0x80)
+        {
+            out.writeByte ((char) ((v & 0x7f) | 0x80));
+            v >>= 7;
+        }
+        out.writeByte ((char) v);
+    }
+
+    bool readVarInt (juce::InputStream& in, juce::uint64& v)
+    {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            juce::uint8 b;
+            if (in.read (&b, 1) != 1)
+                return false;
+
+            v |= (juce::uint64) (b & 0x7f) << shift;
+            if ((b & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+}
+
+//==============================================================================
+InputRecorder::InputRecorder()
+    : juce::Thread ("StraDella input recorder")
+{
+}
+
+InputRecorder::~InputRecorder()
+{
+    stop();
+}
+
+bool InputRecorder::start (const juce::File& f)
+{
+    stop();
+
+    if (onSessionStart == nullptr)
+        return false;
+
+    f.deleteFile();
+    auto out = std::make_unique<juce::FileOutputStream> (f);
+    if (! out->openedOk())
+        return false;
+
+    SessionHeader header;
+    header.ticksPerSecond = juce::Time::getHighResolutionTicksPerSecond();
+    header.startTicks     = juce::Time::getHighResolutionTicks();
+
+    // Recording is live from here so the hook can push the initial settings;
+    // the writer thread only starts once the header is on disk.
+    fifo.reset();
+    numRecorded.store (0);
+    numDropped.store (0);
+    recording.store (true);
+
+    onSessionStart (header);
+
+    out->write (kMagic, 4);
+    out->writeShort ((short) kVersion);
+    out->writeInt64 (header.ticksPerSecond);
+    out->writeInt64 (header.startTicks);
+    out->writeInt (header.screenBounds.getX());
+    out->writeInt (header.screenBounds.getY());
+    out->writeInt (header.screenBounds.getWidth());
+    out->writeInt (header.screenBounds.getHeight());
+    out->writeInt (header.pointer.x);
+    out->writeInt (header.pointer.y);
+    out->writeInt64 (header.randomSeed);
+
+    file             = f;
+    stream           = std::move (out);
+    lastWrittenTicks = header.startTicks;
+
+    startThread (juce::Thread::Priority::low);
+    return true;
+}
+
+void InputRecorder::stop()
+{
+    if (! recording.exchange (false))
+        return;
+
+    signalThreadShouldExit();
+    wake.signal();
+    stopThread (2000);
+
+    drain();
+    stream->flush();
+    stream.reset();
+}
+
+void InputRecorder::push (const Record& r) noexcept
+{
+    if (! isRecording())
+        return;
+
+    const auto scope = fifo.write (1);
+    if (scope.blockSize1 == 0)
+    {
+        numDropped.fetch_add (1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring[scope.startIndex1] = r;
+    numRecorded.fetch_add (1, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void InputRecorder::run()
+{
+    while (! threadShouldExit())
+    {
+        wake.wait (50);
+        drain();
+    }
+}
+
+void InputRecorder::drain()
+{
+    const auto scope = fifo.read (fifo.getNumReady());
+
+    auto write = [this] (int start, int count)
+    {
+        for (int i = start; i < start + count; ++i)
+        {
+            const auto& r = ring[i];
+            writeVarInt (*stream, (juce::uint64) juce::jmax ((juce::int64) 0, r.ticks - lastWrittenTicks));
+            stream->writeByte ((char) r.type);
+            stream->writeByte ((char) r.size);
+            stream->write (r.data, (size_t) r.size);
+            lastWrittenTicks = juce::jmax (lastWrittenTicks, r.ticks);
+        }
+    };
+
+    write (scope.startIndex1, scope.blockSize1);
+    write (scope.startIndex2, scope.blockSize2);
+}
+
+//==============================================================================
+juce::Result InputRecorder::read (const juce::File& f, Session& session)
+{
+    juce::FileInputStream in (f);
+    if (! in.openedOk())
+        return juce::Result::fail ("Cannot open " + f.getFullPathName());
+
+    char magic[4] {};
+    if (in.read (magic, 4) != 4 || std::memcmp (magic, kMagic, 4) != 0)
+        return juce::Result::fail ("Not an input session file");
+
+    const auto version = (juce::uint16) in.readShort();
+    if (version == 0 || version > kVersion)
+        return juce::Result::fail ("Unsupported session version");
+
+    auto& h = session.header;
+    h.ticksPerSecond = in.readInt64();
+    h.startTicks     = in.readInt64();
+    const int x = in.readInt(), y = in.readInt(), w = in.readInt(), ht = in.readInt();
+    h.screenBounds   = { x, y, w, ht };
+    h.pointer.x      = in.readInt();
+    h.pointer.y      = in.readInt();
+    h.randomSeed     = in.readInt64();
+
+    if (h.ticksPerSecond <= 0)
+        return juce::Result::fail ("Corrupt session header");
+
+    session.records.clear();
+    juce::int64 ticks = h.startTicks;
+
+    for (;;)
+    {
+        juce::uint64 delta;
+        if (! readVarInt (in, delta))
+            break;   // clean end of file (or a record cut off by a crash)
+
+        Record r;
+        juce::uint8 typeAndSize[2];
+        if (in.read (typeAndSize, 2) != 2)
+            break;
+
+        if (typeAndSize[0] >= (juce::uint8) Type::numTypes || typeAndSize[1] > Record::kMaxPayload)
+            return juce::Result::fail ("Corrupt record " + juce::String ((int) session.records.size()));
+
+        ticks  += (juce::int64) delta;
+        r.ticks = ticks;
+        r.type  = (Type) typeAndSize[0];
+        r.size  = typeAndSize[1];
+
+        if (in.read (r.data, r.size) != r.size)
+            break;
+
+        session.records.push_back (r);
+    }
+
+    return juce::Result::ok();
+}
+
+//==============================================================================
+InputRecorder::Record InputRecorder::makeEmpty (Type type, juce::int64 ticks) noexcept
+{
+    Record r;
+    r.ticks = ticks;
+    r.type  = type;
+    return r;
+}
+
+InputRecorder::Record InputRecorder::makePointer (juce::int64 ticks, juce::Point<int> pos, int buttons) noexcept
+{
+    auto r = makeEmpty (Type::pointer, ticks);
+    Packer p { r };
+    p.i16 (pos.x);
+    p.i16 (pos.y);
+    p.u8 (buttons);
+    return r;
+}
+
+InputRecorder::Record InputRecorder::makeMouseDown (juce::int64 ticks, int row, int col, int buttons) noexcept
+{
+    auto r = makeEmpty (Type::mouseDown, ticks);
+    Packer p { r };
+    p.u8 (row);
+    p.u8 (col);
+    p.u8 (buttons);
+    return r;
+}
+
+InputRecorder::Record InputRecorder::makeButtons (juce::int64 ticks, int buttons) noexcept
+{
+    auto r = makeEmpty (Type::buttons, ticks);
+    Packer p { r };
+    p.u8 (buttons);
+    return r;
+}
+
+InputRecorder::Record InputRecorder::makeKeyMap (juce::int64 ticks, int keyCode, int row, int col,
+                                                 bool startsTable) noexcept
+{
+    auto r = makeEmpty (Type::keyMap, ticks);
+    Packer p { r };
+    p.i32 (keyCode);
+    p.u8 (row);
+    p.u8 (col);
+    p.u8 (startsTable ? 1 : 0);
+    return r;
+}
+
+InputRecorder::Record InputRecorder::makeKey (Type type, juce::int64 ticks, int keyCode, int buttons) noexcept
+{
+    auto r = makeEmpty (type, ticks);
+    Packer p { r };
+    p.i32 (keyCode);
+    if (type == Type::keyDown)
+        p.u8 (buttons);
+    return r;
+}
+
+juce::Point<int> InputRecorder::getPointer (const Record& r) noexcept
+{
+    Unpacker u { r };
+    const int x = u.i16();
+    return { x, u.i16() };
+}
+
+int InputRecorder::getButtons (const Record& r) noexcept
+{
+    switch (r.type)
+    {
+        case Type::pointer:   return r.size > 4 ? r.data[4] : 0;
+        case Type::mouseDown: return r.size > 2 ? r.data[2] : 0;
+        case Type::keyDown:   return r.size > 4 ? r.data[4] : 0;
+        case Type::buttons:   return r.size > 0 ? r.data[0] : 0;
+        default:              return 0;
+    }
+}
+
+int InputRecorder::getKeyCode (const Record& r) noexcept
+{
+    Unpacker u { r };
+    return u.i32();
+}
+
+//==============================================================================
+InputRecorder::Record InputRecorder::makeVoicing (juce::int64 ticks, const VoicingSettings& s) noexcept
+{
+    auto r = makeEmpty (Type::voicing, ticks);
+    Packer p { r };
+    for (int offset : s.octaveOffset)
+        p.u8 (offset);
+    p.u8 (s.majorInversion);
+    p.u8 (s.minorInversion);
+    p.u8 ((s.majorLeftMouseAdds7  ? 1 : 0) | (s.minorLeftMouseAdds7  ? 2 : 0)
+        | (s.majorRightMouseAdds9 ? 4 : 0) | (s.minorRightMouseAdds9 ? 8 : 0)
+        | (s.autoInversion        ? 16 : 0));
+    p.u8 (s.autoInversionLowNote);
+    p.u8 (s.strumDirection);
+    p.u8 (s.strumVelocityTilt);
+    p.f32 (s.strumSpreadMs);
+    return r;
+}
+
+void InputRecorder::readVoicing (const Record& r, VoicingSettings& s) noexcept
+{
+    Unpacker u { r };
+    for (auto& offset : s.octaveOffset)
+        offset = (juce::int8) u.u8();
+    s.majorInversion       = u.u8();
+    s.minorInversion       = u.u8();
+    const int flags        = u.u8();
+    s.majorLeftMouseAdds7  = (flags & 1)  != 0;
+    s.minorLeftMouseAdds7  = (flags & 2)  != 0;
+    s.majorRightMouseAdds9 = (flags & 4)  != 0;
+    s.minorRightMouseAdds9 = (flags & 8)  != 0;
+    s.autoInversion        = (flags & 16) != 0;
+    s.autoInversionLowNote = u.u8();
+    s.strumDirection       = u.u8();
+    s.strumVelocityTilt    = (juce::int8) u.u8();
+    s.strumSpreadMs        = u.f32();
+}
+
+InputRecorder::Record InputRecorder::makeExpression (juce::int64 ticks, const MouseMidiExpression::Settings& s) noexcept
+{
+    auto r = makeEmpty (Type::expression, ticks);
+    Packer p { r };
+    // Bits 1 and 2 were the CC1 / CC11 switches, now modulation routes.
+    p.u8 ((s.retrigger ? 4 : 0) | (s.jitterFilter ? 8 : 0));
+    p.u8 ((int) s.curve);
+    p.i16 (s.deadZonePixels);
+    p.i16 (s.minHoldMs);
+    p.f32 (s.minCutoffHz);
+    p.f32 (s.beta);
+    return r;
+}
+
+void InputRecorder::readExpression (const Record& r, MouseMidiExpression::Settings& s) noexcept
+{
+    Unpacker u { r };
+    const int flags  = u.u8();
+    s.retrigger      = (flags & 4) != 0;
+    s.jitterFilter   = (flags & 8) != 0;
+    s.curve          = (MouseMidiExpression::CurveType) juce::jmin (u.u8(), (int) MouseMidiExpression::CurveType::Drawn);
+    s.deadZonePixels = u.i16();
+    s.minHoldMs      = u.i16();
+    s.minCutoffHz    = u.f32();
+    s.beta           = u.f32();
+}
+
+InputRecorder::Record InputRecorder::makeOutputStage (juce::int64 ticks, const StraDellaMIDI_pluginAudioProcessor& proc)
+{
+    const auto pattern = proc.getPatternSettings();
+    const auto limiter = proc.getVoiceLimiterSettings();
+
+    auto r = makeEmpty (Type::outputStage, ticks);
+    Packer p { r };
+    p.u8 ((int) pattern.pattern);
+    p.f32 (pattern.gate);
+    p.u8 (limiter.maxVoices);
+    p.u8 ((int) limiter.policy);
+    p.u8 ((int) proc.getThruMode());
+    p.u8 (proc.getBassRegister());
+    return r;
+}
+
+void InputRecorder::applyOutputStage (const Record& r, StraDellaMIDI_pluginAudioProcessor& proc)
+{
+    Unpacker u { r };
+
+    BassPatternEngine::Settings pattern;
+    pattern.pattern = (BassPatternEngine::Pattern) u.u8();
+    pattern.gate    = u.f32();
+
+    VoiceLimiter::Settings limiter;
+    limiter.maxVoices = u.u8();
+    limiter.policy    = (VoiceLimiter::StealPolicy) u.u8();
+
+    proc.setPatternSettings (pattern);
+    proc.setVoiceLimiterSettings (limiter);
+    proc.setThruMode ((StraDellaMIDI_pluginAudioProcessor::ThruMode) u.u8());
+
+    // Sessions recorded before bass registers had no register byte.
+    proc.setBassRegister (r.size > 8 ? u.u8() : 0);
+}
+
+InputRecorder::Record InputRecorder::makeModulation (juce::int64 ticks, const ModulationMatrix::Settings& s,
+                                                     int routeIndex) noexcept
+{
+    const auto& route = s.routes[routeIndex];
+
+    auto r = makeEmpty (Type::modulation, ticks);
+    Packer p { r };
+    p.u8 (routeIndex);
+    p.u8 ((int) route.source);
+    p.u8 (route.sourceCC);
+    p.u8 ((int) route.destination);
+    p.u8 (route.destCC);
+    p.u8 ((int) route.curve);
+    p.f32 (route.depth);
+    p.f32 (s.lfoRateHz);
+    return r;
+}
+
+void InputRecorder::readModulation (const Record& r, ModulationMatrix::Settings& s) noexcept
+{
+    Unpacker u { r };
+    const int index = u.u8();
+    if (index >= ModulationMatrix::kMaxRoutes)
+        return;
+
+    auto& route       = s.routes[index];
+    route.source      = (ModulationMatrix::Source) u.u8();
+    route.sourceCC    = u.u8();
+    route.destination = (ModulationMatrix::Destination) u.u8();
+    route.destCC      = u.u8();
+    route.curve       = (ModulationMatrix::Curve) u.u8();
+    route.depth       = u.f32();
+    s.lfoRateHz       = u.f32();
+}
+
+InputRecorder::Record InputRecorder::makeCurvePoint (juce::int64 ticks, const juce::Array<juce::Point<float>>& points,
+                                                     int index) noexcept
+{
+    auto r = makeEmpty (Type::curvePoint, ticks);
+    Packer p { r };
+    p.u8 (index);
+    p.f32 (points[index].x);
+    p.f32 (points[index].y);
+    return r;
+}
+
+juce::Point<float> InputRecorder::getCurvePoint (const Record& r) noexcept
+{
+    Unpacker u { r };
+    u.u8();
+    const float x = u.f32();
+    return { x, u.f32() };
+}
@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Raw input session recorder.
+
+    Logs every raw input that reaches the grid – polled pointer samples,
+    mouse presses, mouse button changes, key presses and key-release scans,
+    panic – plus every
+    change to the settings that shape the output (the modulation matrix
+    and the drawn response curve included) and to the key → cell table, each stamped with
+    juce::Time::getHighResolutionTicks().  The message thread pushes
+    fixed-size records into a single-producer FIFO; a background thread
+    encodes them into a compact binary file, so recording never touches the
+    disk on the input path.
+
+    File layout (little-endian):
+        "SDIS", uint16 version, int64 ticks/second, int64 start ticks,
+        int32 x4 screen bounds, int32 x2 start pointer, int64 random seed,
+        then per record: LEB128 tick delta, uint8 type, uint8 size, payload.
+
+    InputReplayer feeds a file back through the same code (see there).
+    Inputs that do not go through GridInputController (OSC) are not recorded.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MouseMidiExpression.h"
+#include "ModulationMatrix.h"
+
+struct VoicingSettings;
+class StraDellaMIDI_pluginAudioProcessor;
+
+//==============================================================================
+class InputRecorder : private juce::Thread
+{
+public:
+    //==============================================================================
+    enum class Type : juce::uint8
+    {
+        pointer = 0,    // int16 x, int16 y, uint8 buttons
+        mouseDown,      // uint8 row, uint8 col, uint8 buttons
+        mouseUp,        // -
+        keyDown,        // int32 key code, uint8 buttons
+        keyUp,          // int32 key code; consecutive keyUps with equal ticks are one scan
+        panic,          // -
+        voicing,        // packed VoicingSettings
+        expression,     // packed MouseMidiExpression::Settings
+        outputStage,    // packed pattern / voice limiter / thru / bass register settings
+        buttons,        // uint8 buttons; the mouse buttons went down or up
+        keyMap,         // int32 key code, int8 row, int8 col, uint8 starts table; one per mapped key
+        modulation,     // uint8 route index, packed route, f32 LFO rate; one per matrix route
+        curvePoint,     // uint8 point index, f32 x, f32 y; one per drawn-curve point, index 0 starts the curve
+        numTypes
+    };
+
+    /** Mouse button bits used in the button payload bytes. */
+    enum { leftButton = 1, rightButton = 2 };
+
+    struct Record
+    {
+        static constexpr int kMaxPayload = 22;
+
+        juce::int64 ticks = 0;
+        Type        type  = Type::pointer;
+        juce::uint8 size  = 0;
+        juce::uint8 data[kMaxPayload] {};
+    };
+
+    struct SessionHeader
+    {
+        juce::int64          ticksPerSecond = 0;
+        juce::int64          startTicks     = 0;
+        juce::Rectangle<int> screenBounds;
+        juce::Point<int>     pointer;
+        juce::int64          randomSeed     = 0;
+    };
+
+    struct Session
+    {
+        SessionHeader       header;
+        std::vector<Record> records;
+    };
+
+    //==============================================================================
+    InputRecorder();
+    ~InputRecorder() override;
+
+    /** Called from start() on the message thread, before the header is
+        written: puts the input chain into a known state, fills in the header
+        and pushes the initial settings records. */
+    std::function<void (SessionHeader&)> onSessionStart;
+
+    /** Starts recording into file (replacing it).  Message thread.  Fails if
+        no input chain is attached or the file cannot be opened. */
+    bool start (const juce::File& file);
+    void stop();
+
+    bool        isRecording() const noexcept     { return recording.load (std::memory_order_relaxed); }
+    juce::File  getFile() const                  { return file; }
+    juce::int64 getNumRecorded() const noexcept  { return numRecorded.load (std::memory_order_relaxed); }
+    juce::int64 getNumDropped() const noexcept   { return numDropped.load (std::memory_order_relaxed); }
+
+    /** Queues one record.  Message thread only (single producer); never blocks. */
+    void push (const Record& r) noexcept;
+
+    //==============================================================================
+    // Payload helpers shared by the recorder and InputReplayer.
+    static Record makePointer   (juce::int64 ticks, juce::Point<int> pos, int buttons) noexcept;
+    static Record makeMouseDown (juce::int64 ticks, int row, int col, int buttons) noexcept;
+    static Record makeKey       (Type type, juce::int64 ticks, int keyCode, int buttons) noexcept;
+    static Record makeEmpty     (Type type, juce::int64 ticks) noexcept;
+    static Record makeButtons   (juce::int64 ticks, int buttons) noexcept;
+    static Record makeKeyMap    (juce::int64 ticks, int keyCode, int row, int col, bool startsTable) noexcept;
+
+    static Record makeVoicing     (juce::int64 ticks, const VoicingSettings& s) noexcept;
+    static Record makeExpression  (juce::int64 ticks, const MouseMidiExpression::Settings& s) noexcept;
+    static Record makeOutputStage (juce::int64 ticks, const StraDellaMIDI_pluginAudioProcessor& p);
+    static Record makeModulation  (juce::int64 ticks, const ModulationMatrix::Settings& s, int routeIndex) noexcept;
+    static Record makeCurvePoint  (juce::int64 ticks, const juce::Array<juce::Point<float>>& points, int index) noexcept;
+
+    static juce::Point<int> getPointer (const Record& r) noexcept;
+    static int              getButtons (const Record& r) noexcept;
+    static int              getKeyCode (const Record& r) noexcept;
+    static int              getRow     (const Record& r) noexcept   { return r.data[0]; }
+    static int              getCol     (const Record& r) noexcept   { return r.data[1]; }
+
+    /** keyMap records: the cell, and whether this record begins a new table. */
+    static int              getKeyMapRow (const Record& r) noexcept { return (juce::int8) r.data[4]; }
+    static int              getKeyMapCol (const Record& r) noexcept { return (juce::int8) r.data[5]; }
+    static bool             startsKeyTable (const Record& r) noexcept { return r.size > 6 && r.data[6] != 0; }
+
+    /** curvePoint records: the point's place in the drawn curve, and the point. */
+    static int                getCurvePointIndex (const Record& r) noexcept { return r.data[0]; }
+    static juce::Point<float> getCurvePoint      (const Record& r) noexcept;
+
+    static void readVoicing     (const Record& r, VoicingSettings& s) noexcept;
+    static void readExpression  (const Record& r, MouseMidiExpression::Settings& s) noexcept;
+    static void applyOutputStage (const Record& r, StraDellaMIDI_pluginAudioProcessor& p);
+    static void readModulation   (const Record& r, ModulationMatrix::Settings& s) noexcept;
+
+    /** Reads a whole session file. */
+    static juce::Result read (const juce::File& file, Session& session);
+
+private:
+    //==============================================================================
+    void run() override;
+    void drain();
+
+    static constexpr int kCapacity = 4096;
+
+    juce::AbstractFifo fifo { kCapacity };
+    Record             ring[kCapacity];
+
+    juce::File                                file;
+    std::unique_ptr<juce::FileOutputStream>   stream;
+    juce::int64                               lastWrittenTicks = 0;
+    juce::WaitableEvent                       wake;
+
+    std::atomic<bool>        recording   { false };
+    std::atomic<juce::int64> numRecorded { 0 };
+    std::atomic<juce::int64> numDropped  { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InputRecorder)
+};
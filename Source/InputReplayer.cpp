@@ -0,0 +1,259 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Deterministic replay of a recorded input session.
+
+  ==============================================================================
+*/
+
+#include "InputReplayer.h"
+#include "InputRecorder.h"
+#include "GridInputController.h"
+
+using Type = InputRecorder::Type;
+
+//==============================================================================
+namespace
+{
+    // 64-bit FNV-1a, fed one byte at a time.
+    struct Fnv1a
+    {
+        juce::uint64 value = 0xcbf29ce484222325ull;
+
+        void add (const void* data, size_t size) noexcept
+        {
+            auto* p = static_cast<const juce::uint8*> (data);
+            for (size_t i = 0; i < size; ++i)
+                value = (value ^ p[i]) * 0x100000001b3ull;
+        }
+    };
+}
+
+//==============================================================================
+InputReplayer::Result InputReplayer::replay (const juce::File& file, double sampleRate, int blockSize)
+{
+    Result result;
+
+    InputRecorder::Session session;
+    const auto readResult = InputRecorder::read (file, session);
+    if (readResult.failed())
+    {
+        result.error = readResult.getErrorMessage();
+        return result;
+    }
+
+    const auto& header = session.header;
+    result.numRecords = (int) session.records.size();
+
+    // Fresh processor and input chain: nothing here shares state with the
+    // live editor.  Declaration order matters – the controller detaches from
+    // the expression and the processor's recorder before they go away.
+    auto processor = std::make_unique<StraDellaMIDI_pluginAudioProcessor>();
+    processor->setRateAndBufferSizeDetails (sampleRate, blockSize);
+    processor->prepareToPlay (sampleRate, blockSize);
+
+    // Replay runs faster than the wall clock the queue ages events by, so
+    // expiry is off to keep the output independent of machine speed.
+    processor->setPendingMaxAgeMs (0);
+
+    MouseMidiExpression     expression;
+    StradellaKeyboardMapper mapper;
+    GridInputController     input (*processor, expression);
+
+    expression.setScreenBounds (header.screenBounds);
+    input.buildKeyTable (mapper);
+    expression.resetPointerState (header.pointer);
+    processor->beginInputSession (header.randomSeed);
+
+    // The expression converts ticks with the local tick rate, so rescale the
+    // file's ticks if it was recorded on a machine with a different one.
+    const auto localTicksPerSecond = juce::Time::getHighResolutionTicksPerSecond();
+    auto toLocalTicks = [&] (juce::int64 ticks)
+    {
+        if (header.ticksPerSecond == localTicksPerSecond)
+            return ticks;
+
+        return header.startTicks + (juce::int64) ((double) (ticks - header.startTicks)
+                                                  * (double) localTicksPerSecond / (double) header.ticksPerSecond);
+    };
+
+    auto toSample = [&] (juce::int64 ticks)
+    {
+        return (juce::int64) ((double) (ticks - header.startTicks) / (double) header.ticksPerSecond * sampleRate);
+    };
+
+    // Block clock: every record is applied before the block that contains
+    // its sample position, as the live processor would pick it up.
+    juce::AudioBuffer<float> buffer (0, blockSize);
+    juce::MidiBuffer         midi;
+    juce::int64              blockStart = 0;
+    Fnv1a                    hash;
+
+    auto runBlock = [&]
+    {
+        midi.clear();
+        processor->processBlock (buffer, midi);
+
+        for (const auto metadata : midi)
+        {
+            const juce::int64 position = blockStart + metadata.samplePosition;
+            hash.add (&position, sizeof (position));
+            hash.add (metadata.data, (size_t) metadata.numBytes);
+            ++result.numEvents;
+        }
+
+        blockStart += blockSize;
+    };
+
+    const auto wallStart = juce::Time::getHighResolutionTicks();
+    const auto& records  = session.records;
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const auto& r = records[i];
+
+        while (toSample (r.ticks) >= blockStart + blockSize)
+            runBlock();
+
+        const auto ticks = toLocalTicks (r.ticks);
+
+        switch (r.type)
+        {
+            case Type::pointer:
+                input.replayPointerSample (InputRecorder::getPointer (r), InputRecorder::getButtons (r), ticks);
+                break;
+
+            case Type::mouseDown:
+            {
+                const int buttons = InputRecorder::getButtons (r);
+                input.mouseDown (InputRecorder::getRow (r), InputRecorder::getCol (r),
+                                 (buttons & InputRecorder::leftButton)  != 0,
+                                 (buttons & InputRecorder::rightButton) != 0, ticks);
+                break;
+            }
+
+            case Type::mouseUp:
+                input.mouseUp (ticks);
+                break;
+
+            case Type::buttons:
+                input.mouseButtonsChanged (InputRecorder::getButtons (r), ticks);
+                break;
+
+            case Type::keyDown:
+            {
+                const int buttons = InputRecorder::getButtons (r);
+                input.keyPressed (InputRecorder::getKeyCode (r),
+                                  (buttons & InputRecorder::leftButton)  != 0,
+                                  (buttons & InputRecorder::rightButton) != 0, ticks);
+                break;
+            }
+
+            case Type::keyUp:
+            {
+                // One release scan: every key released in it shares the ticks.
+                size_t end = i + 1;
+                while (end < records.size() && records[end].type == Type::keyUp && records[end].ticks == r.ticks)
+                    ++end;
+
+                input.keysReleased (ticks, [&] (int keyCode)
+                {
+                    for (size_t k = i; k < end; ++k)
+                        if (InputRecorder::getKeyCode (records[k]) == keyCode)
+                            return false;
+                    return true;
+                });
+
+                i = end - 1;
+                break;
+            }
+
+            case Type::panic:
+                input.panic (ticks);
+                break;
+
+            case Type::voicing:
+            {
+                auto s = processor->getVoicingSettings();
+                InputRecorder::readVoicing (r, s);
+                processor->setVoicingSettings (s);
+                break;
+            }
+
+            case Type::expression:
+            {
+                auto s = expression.getSettings();
+                InputRecorder::readExpression (r, s);
+                expression.applySettings (s);
+                break;
+            }
+
+            case Type::outputStage:
+                InputRecorder::applyOutputStage (r, *processor);
+                break;
+
+            case Type::modulation:
+            {
+                auto s = processor->getModulationSettings();
+                InputRecorder::readModulation (r, s);
+                processor->setModulationSettings (s);
+                break;
+            }
+
+            case Type::keyMap:
+            {
+                // One table: a starting record and the ones that follow it.
+                KeyboardInputEngine::KeyTable table;
+                size_t end = i;
+                do
+                {
+                    const auto& k = records[end];
+                    table.set (InputRecorder::getKeyCode (k), InputRecorder::getKeyMapRow (k), InputRecorder::getKeyMapCol (k));
+                    ++end;
+                }
+                while (end < records.size() && records[end].type == Type::keyMap
+                        && ! InputRecorder::startsKeyTable (records[end]));
+
+                input.setKeyTable (table, ticks);
+                i = end - 1;
+                break;
+            }
+
+            case Type::curvePoint:
+            {
+                // One drawn curve: point 0 and the points that follow it.
+                juce::Array<juce::Point<float>> points;
+                size_t end = i;
+                do
+                {
+                    points.add (InputRecorder::getCurvePoint (records[end]));
+                    ++end;
+                }
+                while (end < records.size() && records[end].type == Type::curvePoint
+                        && InputRecorder::getCurvePointIndex (records[end]) != 0);
+
+                processor->getCurveBank().setDrawnCurve (points);
+                i = end - 1;
+                break;
+            }
+
+            case Type::numTypes:
+            default:
+                break;
+        }
+    }
+
+    // Let rolled chord tones and pattern steps play out.
+    const auto tailEnd = blockStart + (juce::int64) (2.0 * sampleRate);
+    while (blockStart < tailEnd)
+        runBlock();
+
+    result.wallSeconds    = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - wallStart);
+    result.sessionSeconds = (double) blockStart / sampleRate;
+    result.hash           = hash.value;
+    result.ok             = true;
+
+    processor->releaseResources();
+    return result;
+}
@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Deterministic replay of a recorded input session.
+
+    Builds a private processor, expression and GridInputController, feeds
+    the session's records through them in order and runs processBlock on a
+    simulated block clock derived from the record timestamps.  The recorded
+    ticks are the only clock the input chain reads, and the processor's
+    random source is re-seeded from the session header, so replaying the
+    same file always produces the same MIDI output; the returned hash covers
+    every output event and its absolute sample position.
+
+    Replay runs as fast as the machine allows, so the ratio of session length
+    to wall time doubles as a benchmark of the whole input -> output path.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class InputReplayer
+{
+public:
+    struct Result
+    {
+        bool         ok             = false;
+        juce::String error;
+        int          numRecords     = 0;
+        juce::int64  numEvents      = 0;   ///< MIDI events produced
+        juce::uint64 hash           = 0;   ///< FNV-1a over (sample position, bytes) of every event
+        double       sessionSeconds = 0.0;
+        double       wallSeconds    = 0.0;
+
+        double realtimeFactor() const noexcept { return wallSeconds > 0.0 ? sessionSeconds / wallSeconds : 0.0; }
+    };
+
+    /** Replays a session file.  Message thread (the expression is a Timer). */
+    static Result replay (const juce::File& file, double sampleRate = 48000.0, int blockSize = 256);
+};
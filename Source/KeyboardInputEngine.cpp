@@ -0,0 +1,233 @@
+#include "KeyboardInputEngine.h"
+#include "AsyncLogger.h"
+
+//==============================================================================
+KeyboardInputEngine::KeyboardInputEngine() {}
+
+KeyboardInputEngine::~KeyboardInputEngine()
+{
+    delete publishedTable.exchange (nullptr);
+}
+
+//==============================================================================
+bool KeyboardInputEngine::KeyTable::set (int keyCode, int row, int col) noexcept
+{
+    const Cell cell { (juce::int8) row, (juce::int8) col };
+
+    if (juce::isPositiveAndBelow (keyCode, kMaxKeyCodes))
+    {
+        cells[keyCode] = cell;
+
+        if (keyCode >= 'a' && keyCode <= 'z')
+            cells[keyCode - ('a' - 'A')] = cell;
+
+        return true;
+    }
+
+    for (int i = 0; i < numExtended; ++i)
+    {
+        if (extended[i].keyCode == keyCode)
+        {
+            extended[i].cell = cell;
+            return true;
+        }
+    }
+
+    if (keyCode < 0 || numExtended == kMaxExtendedKeys)
+        return false;
+
+    extended[numExtended++] = { keyCode, cell };
+    return true;
+}
+
+std::unique_ptr<KeyboardInputEngine::KeyTable> KeyboardInputEngine::KeyTable::compile (const StradellaKeyboardMapper& mapper)
+{
+    auto table = std::make_unique<KeyTable>();
+
+    // One entry per mapped key; set() adds the upper-case aliases.  Past
+    // kMaxExtendedKeys extended keys the rest stay unmapped.
+    mapper.forEachMappedKey ([&table] (int keyCode, int row, int col)
+    {
+        table->set (keyCode, row, col);
+    });
+
+    return table;
+}
+
+//==============================================================================
+void KeyboardInputEngine::setTable (const KeyTable& table) noexcept
+{
+    std::copy (std::begin (table.cells), std::end (table.cells), slotCell);
+
+    // Extended slots of held keys stay theirs until they are released.
+    for (int i = 0; i < kMaxExtendedKeys; ++i)
+    {
+        slotCell[kMaxKeyCodes + i] = {};
+        if (! isSlotHeld (kMaxKeyCodes + i))
+            extendedKeyCodes[i] = 0;
+    }
+
+    for (int i = 0; i < table.numExtended; ++i)
+    {
+        const auto& key = table.extended[i];
+        int slot = slotFor (key.keyCode);
+
+        for (int free = 0; slot < 0 && free < kMaxExtendedKeys; ++free)
+        {
+            if (extendedKeyCodes[free] == 0)
+            {
+                extendedKeyCodes[free] = key.keyCode;
+                slot = kMaxKeyCodes + free;
+            }
+        }
+
+        if (slot >= 0)
+            slotCell[slot] = key.cell;
+    }
+}
+
+void KeyboardInputEngine::publishTable (std::unique_ptr<KeyTable> table)
+{
+    delete publishedTable.exchange (table.release(), std::memory_order_acq_rel);
+}
+
+bool KeyboardInputEngine::adoptPublishedTable()
+{
+    // Cheap enough to call on every key event: one atomic load when nothing
+    // was published.
+    if (publishedTable.load (std::memory_order_relaxed) == nullptr)
+        return false;
+
+    const std::unique_ptr<KeyTable> table (publishedTable.exchange (nullptr, std::memory_order_acq_rel));
+    if (table == nullptr)
+        return false;
+
+    setTable (*table);
+    return true;
+}
+
+int KeyboardInputEngine::slotFor (int keyCode) const noexcept
+{
+    if (juce::isPositiveAndBelow (keyCode, kMaxKeyCodes))
+        return keyCode;
+
+    if (keyCode <= 0)
+        return -1;
+
+    for (int i = 0; i < kMaxExtendedKeys; ++i)
+        if (extendedKeyCodes[i] == keyCode)
+            return kMaxKeyCodes + i;
+
+    return -1;
+}
+
+int KeyboardInputEngine::lowestBit (juce::uint64 bits) noexcept
+{
+    jassert (bits != 0);
+    int n = 0;
+    while ((bits & 1) == 0)
+    {
+        bits >>= 1;
+        ++n;
+    }
+    return n;
+}
+
+int KeyboardInputEngine::getNumHeldKeys() const noexcept
+{
+    int n = 0;
+    for (auto word : heldKeys)
+        for (auto bits = word; bits != 0; bits &= bits - 1)
+            ++n;
+    return n;
+}
+
+bool KeyboardInputEngine::isKeyHeld (int keyCode) const noexcept
+{
+    const int slot = slotFor (keyCode);
+    return slot >= 0 && isSlotHeld (slot);
+}
+
+void KeyboardInputEngine::setHeld (int slot, bool held) noexcept
+{
+    const auto bit = juce::uint64 (1) << (slot % 64);
+    auto& word = heldKeys[slot / 64];
+    word = held ? (word | bit) : (word & ~bit);
+}
+
+//==============================================================================
+bool KeyboardInputEngine::handleKeyPressed (int keyCode, juce::int64 ticks, int velocity,
+                                            bool leftMouseDown, bool rightMouseDown, IntentBatch& out)
+{
+    const int slot = slotFor (keyCode);
+    if (slot < 0)
+        return false;
+
+    // Auto-repeat of a key that is already down (possibly unmapped since).
+    if (isSlotHeld (slot))
+        return true;
+
+    if (slotCell[slot].row < 0)
+        return false;
+
+    const int heldBefore = getNumHeldKeys();
+    if (heldBefore >= rolloverLimit)
+    {
+        ++stats.rolloverEvents;
+        STRADELLA_LOG (AsyncLogger::Event::keyRollover, heldBefore + 1, keyCode);
+    }
+
+    setHeld (slot, true);
+    pressTicks[slot]  = ticks;
+    heldAtPress[slot] = heldBefore;
+    pressedCell[slot] = slotCell[slot];
+    ++stats.presses;
+    stats.maxSimultaneous = juce::jmax (stats.maxSimultaneous, heldBefore + 1);
+
+    CellIntent intent;
+    intent.ticks          = ticks;
+    intent.row            = pressedCell[slot].row;
+    intent.col            = pressedCell[slot].col;
+    intent.isPress        = true;
+    intent.velocity       = (juce::uint8) juce::jlimit (0, 127, velocity);
+    intent.leftMouseDown  = leftMouseDown;
+    intent.rightMouseDown = rightMouseDown;
+    out.add (intent);
+    return true;
+}
+
+int KeyboardInputEngine::handleKeyReleased (juce::int64 ticks, IntentBatch& out)
+{
+    return handleKeyReleased (ticks, out, [] (int keyCode) { return juce::KeyPress::isKeyCurrentlyDown (keyCode); });
+}
+
+void KeyboardInputEngine::releaseAll (juce::int64 ticks, IntentBatch& out)
+{
+    const int heldBefore = getNumHeldKeys();
+
+    for (int word = 0; word < kNumWords; ++word)
+        for (auto bits = heldKeys[word]; bits != 0; bits &= bits - 1)
+            addRelease (word * 64 + lowestBit (bits), ticks, heldBefore, out);
+}
+
+void KeyboardInputEngine::addRelease (int slot, juce::int64 ticks, int heldBefore, IntentBatch& out)
+{
+    setHeld (slot, false);
+    ++stats.releases;
+
+    // A very short press while two or more other keys were held is most
+    // likely a phantom key from the keyboard matrix.
+    const double heldMs = juce::Time::highResolutionTicksToSeconds (ticks - pressTicks[slot]) * 1000.0;
+    if (heldMs < kGhostMaxHoldMs && juce::jmax (heldAtPress[slot], heldBefore - 1) >= 2)
+    {
+        ++stats.ghostSuspects;
+        STRADELLA_LOG (AsyncLogger::Event::keyGhost, keyCodeOf (slot), juce::roundToInt (heldMs * 1000.0));
+    }
+
+    CellIntent intent;
+    intent.ticks   = ticks;
+    intent.row     = pressedCell[slot].row;
+    intent.col     = pressedCell[slot].col;
+    intent.isPress = false;
+    out.add (intent);
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "StradellaKeyboardMapper.h"
+
+//==============================================================================
+/**
+    Computer-keyboard input engine for the Stradella grid.
+
+    Key state lives in a fixed bit set with one slot per key, and each slot
+    maps straight to its grid cell through a flat table built from
+    StradellaKeyboardMapper, so no hashing happens on the input path.  Codes
+    below kMaxKeyCodes are their own slot; keys JUCE gives larger codes
+    (F-keys, numpad keys) get one of kMaxExtendedKeys further slots when a
+    table is applied, found by a short scan of the mapped ones.  Every
+    transition is stamped with juce::Time::getHighResolutionTicks() and
+    collected into an IntentBatch that the editor hands to the processor in
+    one call per key event.
+
+    Tables are compiled off the input path (KeyTable::compile(), any thread)
+    and handed over with publishTable(), a single atomic pointer exchange;
+    the input thread picks the newest one up with adoptPublishedTable(), so
+    a mapping reload never blocks a key event.  Each held key remembers the
+    cell it was pressed with and releases that cell, whatever the table in
+    force when it goes up.
+
+    The engine also watches for keyboard-matrix artefacts:
+      - rollover: a press arriving while rolloverLimit keys are already held
+        (typical USB boot-protocol keyboards stop reporting at six keys);
+      - ghosting: a key that is released again within kGhostMaxHoldMs while
+        two or more other keys are held, the signature of a phantom key
+        produced by the matrix rather than a finger.
+*/
+class KeyboardInputEngine
+{
+public:
+    //==============================================================================
+    static constexpr int kMaxKeyCodes     = 256;
+    static constexpr int kMaxExtendedKeys = 64;
+    static constexpr int kNumSlots        = kMaxKeyCodes + kMaxExtendedKeys;
+
+    /** Mappings are case-insensitive (StradellaKeyboardMapper keeps letters
+        lower-case), so an upper-case letter code is an alias of its
+        lower-case key rather than a key of its own. */
+    static constexpr bool isCaseAlias (int keyCode) noexcept   { return keyCode >= 'A' && keyCode <= 'Z'; }
+
+    struct Cell
+    {
+        juce::int8 row = -1;
+        juce::int8 col = -1;
+    };
+
+    /** A compiled key → cell lookup.  Plain data: built on any thread, then
+        copied into the engine by setTable(). */
+    struct KeyTable
+    {
+        struct ExtendedKey
+        {
+            int  keyCode = 0;
+            Cell cell;
+        };
+
+        Cell        cells[kMaxKeyCodes];          ///< indexed by key code
+        ExtendedKey extended[kMaxExtendedKeys];   ///< key codes kMaxKeyCodes and up
+        int         numExtended = 0;
+
+        /** Maps keyCode to a cell; false if there is no room for another
+            extended key.  A lower-case letter also maps its upper-case code
+            (see isCaseAlias()). */
+        bool set (int keyCode, int row, int col) noexcept;
+
+        /** Calls fn (keyCode, row, col) for every mapped key, once per key:
+            upper-case aliases are skipped. */
+        template <typename Fn>
+        void forEach (Fn&& fn) const
+        {
+            for (int keyCode = 0; keyCode < kMaxKeyCodes; ++keyCode)
+                if (cells[keyCode].row >= 0 && ! isCaseAlias (keyCode))
+                    fn (keyCode, (int) cells[keyCode].row, (int) cells[keyCode].col);
+
+            for (int i = 0; i < numExtended; ++i)
+                fn (extended[i].keyCode, (int) extended[i].cell.row, (int) extended[i].cell.col);
+        }
+
+        static std::unique_ptr<KeyTable> compile (const StradellaKeyboardMapper& mapper);
+    };
+
+    /** Presses/releases produced by one input event, applied in a single call.
+        Sized for a release + press pair per key (bellows retrigger). */
+    struct IntentBatch
+    {
+        static constexpr int kCapacity = 2 * kNumSlots + 2;
+
+        CellIntent intents[kCapacity];
+        int        size = 0;
+
+        void clear() noexcept { size = 0; }
+
+        void add (const CellIntent& intent) noexcept
+        {
+            if (size < kCapacity)
+                intents[size++] = intent;
+        }
+    };
+
+    /** Counters for diagnostics. */
+    struct Stats
+    {
+        juce::int64 presses         = 0;
+        juce::int64 releases        = 0;
+        juce::int64 rolloverEvents  = 0;
+        juce::int64 ghostSuspects   = 0;
+        int         maxSimultaneous = 0;
+    };
+
+    /** Keys released again within this time while others are held count as ghosts. */
+    static constexpr double kGhostMaxHoldMs = 10.0;
+
+    //==============================================================================
+    KeyboardInputEngine();
+    ~KeyboardInputEngine();
+
+    /** Rebuilds the key → cell table from the mapper. */
+    void buildTable (const StradellaKeyboardMapper& mapper)   { setTable (*KeyTable::compile (mapper)); }
+
+    /** Switches to table at once (input thread).  Held keys keep their slot
+        and the cell they were pressed with. */
+    void setTable (const KeyTable& table) noexcept;
+
+    /** Hands a table over from any thread without blocking.  A table that
+        was published but not adopted yet is replaced. */
+    void publishTable (std::unique_ptr<KeyTable> table);
+
+    /** Input thread: switches to the last published table, if there is one.
+        Returns true if it did. */
+    bool adoptPublishedTable();
+
+    /** Calls fn (keyCode, row, col) for every key of the table in force,
+        skipping upper-case aliases as KeyTable::forEach() does. */
+    template <typename Fn>
+    void forEachMappedKey (Fn&& fn) const
+    {
+        for (int slot = 0; slot < kNumSlots; ++slot)
+            if (slotCell[slot].row >= 0 && ! isCaseAlias (keyCodeOf (slot)))
+                fn (keyCodeOf (slot), (int) slotCell[slot].row, (int) slotCell[slot].col);
+    }
+
+    /** Handles a key-down.  Returns false if the key is not mapped; auto-repeat
+        of a held key is consumed without producing an intent. */
+    bool handleKeyPressed (int keyCode, juce::int64 ticks, int velocity,
+                           bool leftMouseDown, bool rightMouseDown, IntentBatch& out);
+
+    /** Handles a key-up notification by polling only the keys currently held.
+        Returns the number of releases added to out. */
+    int handleKeyReleased (juce::int64 ticks, IntentBatch& out);
+
+    /** As above, with the key-state probe supplied by the caller: isKeyDown
+        (keyCode) is asked once per held key (session recording and replay). */
+    template <typename IsKeyDown>
+    int handleKeyReleased (juce::int64 ticks, IntentBatch& out, IsKeyDown&& isKeyDown)
+    {
+        const int heldBefore = getNumHeldKeys();
+        const int sizeBefore = out.size;
+
+        // JUCE does not say which key went up, so poll only the held ones.
+        for (int word = 0; word < kNumWords; ++word)
+        {
+            for (auto bits = heldKeys[word]; bits != 0; bits &= bits - 1)
+            {
+                const int slot = word * 64 + lowestBit (bits);
+                if (! isKeyDown (keyCodeOf (slot)))
+                    addRelease (slot, ticks, heldBefore, out);
+            }
+        }
+
+        return out.size - sizeBefore;
+    }
+
+    /** Releases every held key (panic / focus loss). */
+    void releaseAll (juce::int64 ticks, IntentBatch& out);
+
+    /** Calls fn (row, col) for every cell currently held from the keyboard. */
+    template <typename Fn>
+    void forEachHeldCell (Fn&& fn) const
+    {
+        for (int word = 0; word < kNumWords; ++word)
+            for (auto bits = heldKeys[word]; bits != 0; bits &= bits - 1)
+            {
+                const auto cell = pressedCell[word * 64 + lowestBit (bits)];
+                fn ((int) cell.row, (int) cell.col);
+            }
+    }
+
+    int  getNumHeldKeys() const noexcept;
+    bool isKeyHeld (int keyCode) const noexcept;
+
+    void setRolloverLimit (int numKeys) noexcept  { rolloverLimit = juce::jmax (1, numKeys); }
+    int  getRolloverLimit() const noexcept        { return rolloverLimit; }
+
+    const Stats& getStats() const noexcept        { return stats; }
+
+private:
+    //==============================================================================
+    static constexpr int kNumWords = kNumSlots / 64;
+
+    static int lowestBit (juce::uint64 bits) noexcept;
+
+    /** Slot of a key code, -1 if it has none. */
+    int slotFor (int keyCode) const noexcept;
+    int keyCodeOf (int slot) const noexcept
+    {
+        return slot < kMaxKeyCodes ? slot : extendedKeyCodes[slot - kMaxKeyCodes];
+    }
+
+    void setHeld (int slot, bool held) noexcept;
+    void addRelease (int slot, juce::int64 ticks, int heldBefore, IntentBatch& out);
+
+    bool isSlotHeld (int slot) const noexcept   { return ((heldKeys[slot / 64] >> (slot % 64)) & 1) != 0; }
+
+    Cell         slotCell[kNumSlots];      ///< current mapping
+    Cell         pressedCell[kNumSlots];   ///< mapping a held key was pressed with
+    juce::uint64 heldKeys[kNumWords] {};
+    juce::int64  pressTicks[kNumSlots] {};
+    int          heldAtPress[kNumSlots] {};
+
+    int extendedKeyCodes[kMaxExtendedKeys] {};   ///< 0 = free slot
+
+    std::atomic<KeyTable*> publishedTable { nullptr };
+
+    int   rolloverLimit = 6;
+    Stats stats;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KeyboardInputEngine)
+};
@@ -0,0 +1,732 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Keyboard-mapping parser implementation.
+
+  ==============================================================================
+*/
+
+#include "KeyboardMappingParser.h"
+
+using Section = KeyboardMappingParser::Section;
+
+//==============================================================================
+namespace
+{
+    constexpr int kReadSize = 64 * 1024;
+
+    bool isSpace (char c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    bool isDigit (char c) noexcept
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    char toLower (char c) noexcept
+    {
+        return (c >= 'A' && c <= 'Z') ? (char) (c + ('a' - 'A')) : c;
+    }
+
+    bool equalsIgnoreCase (const char* text, int length, const char* name) noexcept
+    {
+        for (int i = 0; i < length; ++i, ++name)
+            if (*name == 0 || toLower (text[i]) != *name)
+                return false;
+
+        return *name == 0;
+    }
+
+    // Tokens are quoted in messages byte by byte, so a broken UTF-8 sequence
+    // cannot upset juce::String.
+    juce::String quote (const char* text, int length)
+    {
+        constexpr int kMaxQuoted = 24;
+
+        juce::String s ("'");
+        for (int i = 0; i < juce::jmin (length, kMaxQuoted); ++i)
+        {
+            const auto c = (juce::uint8) text[i];
+            if (c >= 0x20 && c < 0x7f)
+                s << (char) c;
+            else
+                s << "\\x" << juce::String::toHexString ((int) c).paddedLeft ('0', 2);
+        }
+
+        if (length > kMaxQuoted)
+            s << "...";
+
+        return s + "'";
+    }
+
+    // One UTF-8 code point of exactly length bytes, or -1.
+    int decodeSingleCodePoint (const char* text, int length) noexcept
+    {
+        const auto lead = (juce::uint8) text[0];
+        const int  expected = lead >= 0xf0 && lead < 0xf5 ? 4
+                            : lead >= 0xe0 ? 3
+                            : lead >= 0xc2 && lead < 0xe0 ? 2
+                            : 0;
+
+        if (expected != length || lead >= 0xf5)
+            return -1;
+
+        int codePoint = lead & (0x7f >> expected);
+        for (int i = 1; i < length; ++i)
+        {
+            const auto c = (juce::uint8) text[i];
+            if ((c & 0xc0) != 0x80)
+                return -1;
+
+            codePoint = (codePoint << 6) | (c & 0x3f);
+        }
+
+        // Overlong forms, surrogates and values past U+10FFFF.
+        const int minimum = length == 3 ? 0x800 : length == 4 ? 0x10000 : 0x80;
+        if (codePoint < minimum || (codePoint >= 0xd800 && codePoint < 0xe000) || codePoint > 0x10ffff)
+            return -1;
+
+        return codePoint;
+    }
+
+    struct KeyName
+    {
+        const char* name;
+        int         keyCode;
+    };
+
+    // Lower-case names; where one key has several, the first is the one
+    // getKeyName() gives back.
+    const std::vector<KeyName>& getKeyNames()
+    {
+        using K = juce::KeyPress;
+
+        static const std::vector<KeyName> names {
+            { "space",     K::spaceKey },        { "tab",       K::tabKey },
+            { "return",    K::returnKey },       { "enter",     K::returnKey },
+            { "escape",    K::escapeKey },       { "esc",       K::escapeKey },
+            { "backspace", K::backspaceKey },    { "delete",    K::deleteKey },
+            { "insert",    K::insertKey },       { "home",      K::homeKey },
+            { "end",       K::endKey },          { "pageup",    K::pageUpKey },
+            { "pagedown",  K::pageDownKey },     { "left",      K::leftKey },
+            { "right",     K::rightKey },        { "up",        K::upKey },
+            { "down",      K::downKey },         { "hash",      '#' },
+
+            { "f1",  K::F1Key },  { "f2",  K::F2Key },  { "f3",  K::F3Key },  { "f4",  K::F4Key },
+            { "f5",  K::F5Key },  { "f6",  K::F6Key },  { "f7",  K::F7Key },  { "f8",  K::F8Key },
+            { "f9",  K::F9Key },  { "f10", K::F10Key }, { "f11", K::F11Key }, { "f12", K::F12Key },
+            { "f13", K::F13Key }, { "f14", K::F14Key }, { "f15", K::F15Key }, { "f16", K::F16Key },
+            { "f17", K::F17Key }, { "f18", K::F18Key }, { "f19", K::F19Key }, { "f20", K::F20Key },
+            { "f21", K::F21Key }, { "f22", K::F22Key }, { "f23", K::F23Key }, { "f24", K::F24Key },
+
+            { "numpad0", K::numberPad0 }, { "numpad1", K::numberPad1 }, { "numpad2", K::numberPad2 },
+            { "numpad3", K::numberPad3 }, { "numpad4", K::numberPad4 }, { "numpad5", K::numberPad5 },
+            { "numpad6", K::numberPad6 }, { "numpad7", K::numberPad7 }, { "numpad8", K::numberPad8 },
+            { "numpad9", K::numberPad9 },
+
+            { "numpad+", K::numberPadAdd },          { "numpadplus",      K::numberPadAdd },
+            { "numpad-", K::numberPadSubtract },     { "numpadminus",     K::numberPadSubtract },
+            { "numpad*", K::numberPadMultiply },     { "numpadmultiply",  K::numberPadMultiply },
+            { "numpad/", K::numberPadDivide },       { "numpaddivide",    K::numberPadDivide },
+            { "numpad.", K::numberPadDecimalPoint }, { "numpaddecimal",   K::numberPadDecimalPoint },
+            { "numpad,", K::numberPadSeparator },    { "numpadseparator", K::numberPadSeparator },
+            { "numpadequals", K::numberPadEquals },  { "numpaddelete",    K::numberPadDelete },
+        };
+
+        return names;
+    }
+}
+
+//==============================================================================
+juce::String KeyboardMappingParser::Diagnostic::toString() const
+{
+    return juce::String (line) + ":" + juce::String (column) + (isError ? ": error: " : ": warning: ") + message;
+}
+
+KeyboardMappingParser::KeyboardMappingParser (EntrySink entrySink)
+    : sink (std::move (entrySink))
+{
+}
+
+void KeyboardMappingParser::report (int line, int column, bool isError, const juce::String& message)
+{
+    if (isError)
+        ++numErrors;
+    else
+        ++numWarnings;
+
+    if (diagnostics.size() < kMaxDiagnostics)
+        diagnostics.add ({ line, column, isError, message });
+}
+
+//==============================================================================
+void KeyboardMappingParser::feed (const void* data, size_t numBytes)
+{
+    auto*       p   = static_cast<const char*> (data);
+    const auto* end = p + numBytes;
+
+    while (p < end)
+    {
+        // The rest of a comment is only scanned for the newline.
+        if (inComment)
+        {
+            auto* newline = static_cast<const char*> (std::memchr (p, '\n', (size_t) (end - p)));
+            if (newline == nullptr)
+            {
+                lineBytes += (int) (end - p);
+                return;
+            }
+
+            lineBytes += (int) (newline - p);
+            p = newline;
+        }
+
+        const char c = *p++;
+
+        if (c == '\n')
+        {
+            endLine();
+            continue;
+        }
+
+        ++lineBytes;
+
+        if (c == '#')
+            inComment = true;
+        else if (lineLength < kMaxLineLength)
+            lineBuffer[lineLength++] = c;
+        else
+            lineTooLong = true;
+    }
+}
+
+void KeyboardMappingParser::finish()
+{
+    if (lineBytes > 0)
+        endLine();
+}
+
+void KeyboardMappingParser::parse (juce::InputStream& in)
+{
+    juce::HeapBlock<char> buffer (kReadSize);
+
+    for (;;)
+    {
+        const int numRead = in.read (buffer.get(), kReadSize);
+        if (numRead <= 0)
+            break;
+
+        feed (buffer.get(), (size_t) numRead);
+    }
+
+    finish();
+}
+
+void KeyboardMappingParser::endLine()
+{
+    ++lineNumber;
+
+    if (lineTooLong)
+    {
+        report (lineNumber, kMaxLineLength + 1, true,
+                "line is longer than " + juce::String (kMaxLineLength) + " bytes before its comment; skipped");
+    }
+    else
+    {
+        // A UTF-8 byte order mark may start the file.
+        if (lineNumber == 1 && lineLength >= 3 && std::memcmp (lineBuffer, "\xef\xbb\xbf", 3) == 0)
+        {
+            std::memmove (lineBuffer, lineBuffer + 3, (size_t) (lineLength - 3));
+            lineLength -= 3;
+        }
+
+        parseLine (lineBuffer, lineLength);
+    }
+
+    lineLength  = 0;
+    lineBytes   = 0;
+    inComment   = false;
+    lineTooLong = false;
+}
+
+//==============================================================================
+void KeyboardMappingParser::parseLine (const char* text, int length)
+{
+    int begin = 0, end = length;
+    while (begin < end && isSpace (text[begin]))   ++begin;
+    while (end > begin && isSpace (text[end - 1])) --end;
+
+    if (begin == end)
+        return;
+
+    if (text[begin] == '[')
+        parseSectionHeader (text, begin, end);
+    else if (section != Section::ignored)
+        parseMapping (text, begin, end);
+}
+
+void KeyboardMappingParser::parseSectionHeader (const char* text, int begin, int end)
+{
+    int close = begin + 1;
+    while (close < end && text[close] != ']')
+        ++close;
+
+    if (close == end)
+    {
+        report (lineNumber, end + 1, true, "missing ']'; lines up to the next section are ignored");
+        section = Section::ignored;
+        return;
+    }
+
+    if (close + 1 < end)
+        report (lineNumber, close + 2, false, "text after ']' is ignored");
+
+    int nameBegin = begin + 1, nameEnd = close;
+    while (nameBegin < nameEnd && isSpace (text[nameBegin]))  ++nameBegin;
+    while (nameEnd > nameBegin && isSpace (text[nameEnd - 1])) --nameEnd;
+
+    const auto* name = text + nameBegin;
+    const int   len  = nameEnd - nameBegin;
+
+    if      (equalsIgnoreCase (name, len, "bass"))        section = Section::bass;
+    else if (equalsIgnoreCase (name, len, "counterbass")
+          || equalsIgnoreCase (name, len, "third"))       section = Section::third;
+    else if (equalsIgnoreCase (name, len, "major"))       section = Section::major;
+    else if (equalsIgnoreCase (name, len, "minor"))       section = Section::minor;
+    else if (equalsIgnoreCase (name, len, "voicing"))     section = Section::ignored;
+    else
+    {
+        report (lineNumber, nameBegin + 1, false,
+                len == 0 ? juce::String ("empty section name; its lines are ignored")
+                         : "unknown section " + quote (name, len) + "; its lines are ignored");
+        section = Section::ignored;
+    }
+}
+
+void KeyboardMappingParser::parseMapping (const char* text, int begin, int end)
+{
+    // The key runs to the first blank or '='; its first byte always belongs
+    // to it, so "= = 50" maps the '=' key.
+    int p = begin + 1;
+    while (p < end && ! isSpace (text[p]) && text[p] != '=')
+        ++p;
+
+    const int keyLength = p - begin;
+
+    while (p < end && isSpace (text[p]))
+        ++p;
+
+    if (p == end || text[p] != '=')
+    {
+        report (lineNumber, p + 1, true, "expected '=' after key " + quote (text + begin, keyLength));
+        return;
+    }
+
+    const int keyCode = keyCodeForName (text + begin, keyLength);
+    if (keyCode < 0)
+    {
+        report (lineNumber, begin + 1, true, "unknown key " + quote (text + begin, keyLength));
+        return;
+    }
+
+    Entry e;
+    e.keyCode   = keyCode;
+    e.section   = section;
+    e.line      = lineNumber;
+    e.keyColumn = begin + 1;
+
+    ++p;
+
+    for (;;)
+    {
+        while (p < end && isSpace (text[p]))
+            ++p;
+
+        const int start = p;
+        int value = 0;
+        while (p < end && isDigit (text[p]))
+        {
+            if (value < 1000)
+                value = value * 10 + (text[p] - '0');
+            ++p;
+        }
+
+        if (p == start)
+        {
+            report (lineNumber, p + 1, true,
+                    p == end ? juce::String (e.numNotes == 0 ? "expected note numbers after '='"
+                                                             : "expected a note number after ','")
+                             : "expected a note number, found " + quote (text + p, 1));
+            return;
+        }
+
+        if (value > 127)
+        {
+            report (lineNumber, start + 1, true, "note " + quote (text + start, p - start) + " is outside 0-127");
+            return;
+        }
+
+        if (e.numNotes == kMaxNotes)
+        {
+            report (lineNumber, start + 1, true, "more than " + juce::String (kMaxNotes) + " notes");
+            return;
+        }
+
+        if (e.numNotes == 0)
+            e.notesColumn = start + 1;
+
+        e.notes[e.numNotes++] = (juce::uint8) value;
+
+        while (p < end && isSpace (text[p]))
+            ++p;
+
+        if (p == end)
+            break;
+
+        if (text[p] != ',')
+        {
+            report (lineNumber, p + 1, true, "expected ',' between notes, found " + quote (text + p, 1));
+            return;
+        }
+
+        ++p;
+    }
+
+    ++numEntries;
+
+    if (sink != nullptr)
+        sink (*this, e);
+}
+
+//==============================================================================
+int KeyboardMappingParser::keyCodeForName (const char* token, int length)
+{
+    if (length <= 0)
+        return -1;
+
+    if (length == 1)
+    {
+        const auto c = (juce::uint8) token[0];
+        if (c < 0x20 || c >= 0x7f)
+            return -1;
+
+        return (int) (juce::uint8) toLower ((char) c);
+    }
+
+    const int codePoint = decodeSingleCodePoint (token, length);
+    if (codePoint >= 0)
+        return (int) juce::CharacterFunctions::toLowerCase ((juce::juce_wchar) codePoint);
+
+    for (const auto& k : getKeyNames())
+        if (equalsIgnoreCase (token, length, k.name))
+            return k.keyCode;
+
+    return -1;
+}
+
+juce::String KeyboardMappingParser::getKeyName (int keyCode)
+{
+    for (const auto& k : getKeyNames())
+        if (k.keyCode == keyCode)
+            return k.name;
+
+    if (keyCode > 0x20 && keyCode != 0x7f && keyCode <= 0x10ffff)
+        return juce::String::charToString ((juce::juce_wchar) keyCode);
+
+    return "0x" + juce::String::toHexString (keyCode);
+}
+
+//==============================================================================
+namespace
+{
+    struct Run
+    {
+        std::vector<KeyboardMappingParser::Entry>      entries;
+        juce::Array<KeyboardMappingParser::Diagnostic> diagnostics;
+        int numLines = 0, numErrors = 0, numWarnings = 0;
+    };
+
+    template <typename Feed>
+    Run parseWith (Feed&& feedChunks)
+    {
+        Run run;
+        KeyboardMappingParser parser ([&run] (KeyboardMappingParser&, const KeyboardMappingParser::Entry& e)
+        {
+            run.entries.push_back (e);
+        });
+
+        feedChunks (parser);
+        parser.finish();
+
+        run.diagnostics = parser.getDiagnostics();
+        run.numLines    = parser.getNumLines();
+        run.numErrors   = parser.getNumErrors();
+        run.numWarnings = parser.getNumWarnings();
+        return run;
+    }
+
+    bool sameEntry (const KeyboardMappingParser::Entry& a, const KeyboardMappingParser::Entry& b) noexcept
+    {
+        return a.keyCode == b.keyCode && a.section == b.section && a.numNotes == b.numNotes
+            && a.line == b.line && a.keyColumn == b.keyColumn && a.notesColumn == b.notesColumn
+            && std::memcmp (a.notes, b.notes, sizeof (a.notes)) == 0;
+    }
+}
+
+juce::String KeyboardMappingParser::selfCheck (const void* data, size_t numBytes, juce::Random& random)
+{
+    const auto* bytes = static_cast<const char*> (data);
+
+    const auto whole = parseWith ([&] (KeyboardMappingParser& parser) { parser.feed (bytes, numBytes); });
+
+    const auto chunked = parseWith ([&] (KeyboardMappingParser& parser)
+    {
+        for (size_t pos = 0; pos < numBytes;)
+        {
+            const auto n = juce::jmin (numBytes - pos, (size_t) (random.nextBool() ? 1 + random.nextInt (4)
+                                                                                   : 1 + random.nextInt (300)));
+            parser.feed (bytes + pos, n);
+            pos += n;
+        }
+    });
+
+    // Streaming must not depend on where the chunks end.
+    if (whole.numLines != chunked.numLines || whole.numErrors != chunked.numErrors
+         || whole.numWarnings != chunked.numWarnings || whole.entries.size() != chunked.entries.size()
+         || whole.diagnostics.size() != chunked.diagnostics.size())
+        return "chunked parse disagrees with whole parse";
+
+    for (size_t i = 0; i < whole.entries.size(); ++i)
+        if (! sameEntry (whole.entries[i], chunked.entries[i]))
+            return "chunked parse gives a different entry on line " + juce::String (whole.entries[i].line);
+
+    for (int i = 0; i < whole.diagnostics.size(); ++i)
+    {
+        const auto& a = whole.diagnostics.getReference (i);
+        const auto& b = chunked.diagnostics.getReference (i);
+        if (a.line != b.line || a.column != b.column || a.isError != b.isError || a.message != b.message)
+            return "chunked parse gives a different diagnostic: " + a.toString();
+    }
+
+    int expectedLines = 0;
+    for (size_t i = 0; i < numBytes; ++i)
+        if (bytes[i] == '\n')
+            ++expectedLines;
+    if (numBytes > 0 && bytes[numBytes - 1] != '\n')
+        ++expectedLines;
+
+    if (whole.numLines != expectedLines)
+        return "counted " + juce::String (whole.numLines) + " lines, expected " + juce::String (expectedLines);
+
+    if (whole.numErrors + whole.numWarnings < whole.diagnostics.size()
+         || whole.diagnostics.size() > kMaxDiagnostics)
+        return "diagnostic counts are inconsistent";
+
+    int lastLine = 0;
+    for (const auto& e : whole.entries)
+    {
+        if (e.line <= lastLine || e.line > whole.numLines)
+            return "entry on line " + juce::String (e.line) + " is out of order";
+
+        if (e.numNotes < 1 || e.numNotes > kMaxNotes)
+            return "entry on line " + juce::String (e.line) + " has " + juce::String (e.numNotes) + " notes";
+
+        for (int n = 0; n < e.numNotes; ++n)
+            if (e.notes[n] > 127)
+                return "entry on line " + juce::String (e.line) + " has note " + juce::String (e.notes[n]);
+
+        if ((int) e.section < 0 || (int) e.section > 3)
+            return "entry on line " + juce::String (e.line) + " belongs to no row";
+
+        if (e.keyCode < 0 || e.keyColumn < 1 || e.notesColumn <= e.keyColumn || e.notesColumn > kMaxLineLength)
+            return "entry on line " + juce::String (e.line) + " has a bad key or column";
+
+        lastLine = e.line;
+    }
+
+    for (const auto& d : whole.diagnostics)
+    {
+        if (d.line < 1 || d.line > whole.numLines || d.column < 1 || d.column > kMaxLineLength + 1
+             || d.message.isEmpty())
+            return "malformed diagnostic " + d.toString();
+
+        // A line with an error must not have produced an entry.
+        if (d.isError)
+            for (const auto& e : whole.entries)
+                if (e.line == d.line)
+                    return "line " + juce::String (d.line) + " has both an error and an entry";
+    }
+
+    return {};
+}
+
+//==============================================================================
+juce::MemoryBlock KeyboardMappingParser::generateSample (size_t numBytes, juce::Random& random)
+{
+    static const char* const keys[] = {
+        "q", "w", "e", "r", "t", "y", "u", "i", "o", "p", "1", "2", "3", "4", "5", "6", "7", "8", "9", "0",
+        "a", "s", "d", "f", "g", "h", "j", "k", "l", ";", "z", "x", "c", "v", "b", "n", "m", ",", ".", "/",
+        "Q", "A", "Z", "F1", "F7", "F12", "f24", "numpad0", "numpad5", "numpad+", "numpad/", "pageup", "\xc3\xa4"
+    };
+    static const char* const headers[] = { "[bass]", "[counterbass]", "[major]", "[minor]", "[voicing]", "[Third]" };
+    static const char* const comments[] = { "", "      # Eb2", "  # C3 Major  (C3, E3, G3)", "\t# G#2 - major 3rd" };
+
+    juce::MemoryOutputStream out (numBytes + 256);
+    out << "# Generated mapping\r\n\n";
+
+    while (out.getDataSize() < numBytes)
+    {
+        const int h = random.nextInt (juce::numElementsInArray (headers));
+        out << "\n" << headers[h] << "\n";
+
+        for (int line = 0; line < 24; ++line)
+        {
+            if (h == 4)
+            {
+                out << "bass_octave = " << random.nextInt (5) - 2 << "\n";
+                continue;
+            }
+
+            const int root = 36 + random.nextInt (12);
+            out << keys[random.nextInt (juce::numElementsInArray (keys))] << " = ";
+
+            if (h < 2 || h == 5)
+                out << root + (h == 1 ? 4 : 0);
+            else
+                out << root + 12 << "," << root + (h == 2 ? 16 : 15) << ", " << root + 19;
+
+            out << comments[random.nextInt (juce::numElementsInArray (comments))] << "\n";
+        }
+    }
+
+    return out.getMemoryBlock();
+}
+
+KeyboardMappingParser::FuzzResult KeyboardMappingParser::fuzz (int iterations, juce::int64 seed)
+{
+    static const char* const tokens[] = {
+        "[", "]", "=", ",", "#", "\n", "\r\n", " ", "\t", "[bass]", "[voicing]", "[", "F13", "numpad+",
+        "numpad", "127", "128", "-1", "99999999999", "\xef\xbb\xbf", "\xc3", "\xc3\xa4", "\xed\xa0\x80", "\0"
+    };
+
+    FuzzResult result;
+    juce::Random random (seed);
+    const auto base = generateSample (4096, random);
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        juce::MemoryBlock input;
+
+        if (random.nextInt (8) == 0)
+        {
+            // Pure noise now and then.
+            input.setSize ((size_t) random.nextInt (2048));
+            random.fillBitsRandomly (input.getData(), input.getSize());
+        }
+        else
+        {
+            input = base;
+
+            for (int m = 1 + random.nextInt (8); --m >= 0;)
+            {
+                const auto size = input.getSize();
+                const auto pos  = size > 0 ? (size_t) random.nextInt ((int) size) : 0;
+
+                switch (random.nextInt (5))
+                {
+                    case 0:
+                        if (size > 0)
+                            static_cast<juce::uint8*> (input.getData())[pos] = (juce::uint8) random.nextInt (256);
+                        break;
+
+                    case 1:
+                    {
+                        const char* t = tokens[random.nextInt (juce::numElementsInArray (tokens))];
+                        input.insert (t, juce::jmax ((size_t) 1, std::strlen (t)), pos);
+                        break;
+                    }
+
+                    case 2:
+                        input.removeSection (pos, (size_t) random.nextInt (64));
+                        break;
+
+                    case 3:
+                    {
+                        // Duplicate a run, sometimes many times over (very long lines).
+                        const auto length = juce::jmin (size - pos, (size_t) random.nextInt (64));
+                        const juce::MemoryBlock run (static_cast<const char*> (input.getData()) + pos, length);
+                        for (int n = random.nextInt (4) == 0 ? 40 : 1; --n >= 0;)
+                            input.insert (run.getData(), run.getSize(), pos);
+                        break;
+                    }
+
+                    default:
+                        input.setSize (pos);
+                        break;
+                }
+            }
+        }
+
+        ++result.iterations;
+        result.bytes += (juce::int64) input.getSize();
+
+        result.failure = selfCheck (input.getData(), input.getSize(), random);
+        if (result.failure.isNotEmpty())
+        {
+            result.failingInput = input;
+            break;
+        }
+    }
+
+    return result;
+}
+
+KeyboardMappingParser::BenchmarkResult KeyboardMappingParser::benchmark (int megabytes)
+{
+    BenchmarkResult result;
+
+    juce::Random random (1);
+    const auto sample = generateSample ((size_t) juce::jmax (1, megabytes) * 1024 * 1024, random);
+    result.bytes = (juce::int64) sample.getSize();
+
+    for (int run = 0; run < 3; ++run)
+    {
+        int entries = 0;
+        KeyboardMappingParser parser ([&entries] (KeyboardMappingParser&, const Entry&) { ++entries; });
+        juce::MemoryInputStream in (sample, false);
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        parser.parse (in);
+        const auto seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+
+        if (run == 0 || seconds < result.bestSeconds)
+            result.bestSeconds = seconds;
+
+        result.lines   = parser.getNumLines();
+        result.entries = entries;
+    }
+
+    result.megabytesPerSecond = result.bestSeconds > 0.0 ? (double) result.bytes / (1024.0 * 1024.0) / result.bestSeconds
+                                                         : 0.0;
+    return result;
+}
+
+//==============================================================================
+#if STRADELLA_MAPPING_FUZZER
+extern "C" int LLVMFuzzerTestOneInput (const juce::uint8* data, size_t size)
+{
+    juce::Random random ((juce::int64) size);
+    const auto failure = KeyboardMappingParser::selfCheck (data, size, random);
+
+    if (failure.isNotEmpty())
+    {
+        std::fprintf (stderr, "%s\n", failure.toRawUTF8());
+        std::abort();
+    }
+
+    return 0;
+}
+#endif
@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Single-pass streaming parser for keyboard-mapping files.
+
+    Bytes are pushed in chunks of any size (a chunk may end mid-line or
+    mid-character) and every byte is looked at once.  Only the current line
+    up to its '#' comment is buffered, so memory is fixed whatever the file
+    size; a line whose content exceeds kMaxLineLength is reported and
+    skipped.  Each complete mapping line is handed to the sink as an Entry.
+
+    Format (see default_keyboard_mapping.txt):
+
+        [section]                     bass, counterbass / third, major, minor
+        key = note1[,note2,...]       # comment
+
+    Lines before the first header belong to [bass]; [voicing] and unknown
+    sections are skipped (unknown ones with a warning).  A key is either a
+    single character (UTF-8, letters case-insensitive) or a name such as
+    F1-F24, numpad0-numpad9, numpad+, space or pageup, so the mapping can
+    use keys that do not type a character.  Notes are integers 0-127, at
+    most kMaxNotes per key.
+
+    Problems are reported as Diagnostics with 1-based line and column
+    (columns count bytes).  A line with an error produces no entry; parsing
+    always carries on with the next line.
+
+    selfCheck() is the fuzz target: it parses an arbitrary input whole and
+    in random chunk sizes and checks the invariants.  fuzz() drives it with
+    mutated mapping text, and benchmark() measures throughput on generated
+    multi-megabyte files; Benchmarks/MappingBenchmark runs both headless.
+    Builds that define STRADELLA_MAPPING_FUZZER=1 also get a libFuzzer
+    entry point (LLVMFuzzerTestOneInput) calling it, as
+    Benchmarks/MappingFuzzer does; leave it off in plugin builds.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef STRADELLA_MAPPING_FUZZER
+ #define STRADELLA_MAPPING_FUZZER 0
+#endif
+
+//==============================================================================
+class KeyboardMappingParser
+{
+public:
+    //==============================================================================
+    static constexpr int kMaxNotes      = 8;
+    static constexpr int kMaxLineLength = 512;    ///< bytes before any comment
+
+    /** Grid rows as in PluginProcessor's RowType, plus sections whose lines
+        are skipped. */
+    enum class Section : juce::int8
+    {
+        ignored = -1,
+        third   = 0,
+        bass    = 1,
+        major   = 2,
+        minor   = 3
+    };
+
+    struct Entry
+    {
+        int         keyCode     = 0;       ///< juce::KeyPress code; letters lower-case
+        Section     section     = Section::bass;
+        juce::uint8 notes[kMaxNotes] {};
+        int         numNotes    = 0;
+        int         line        = 0;
+        int         keyColumn   = 0;
+        int         notesColumn = 0;       ///< column of the first note
+    };
+
+    struct Diagnostic
+    {
+        int          line    = 0;
+        int          column  = 0;
+        bool         isError = true;       ///< false = warning (the line still counts)
+        juce::String message;
+
+        /** "line:column: error: message". */
+        juce::String toString() const;
+    };
+
+    /** Receives each entry as soon as its line is complete; the sink may
+        report() problems it finds with the entry. */
+    using EntrySink = std::function<void (KeyboardMappingParser&, const Entry&)>;
+
+    //==============================================================================
+    explicit KeyboardMappingParser (EntrySink sink);
+
+    /** Parses the next chunk of the file. */
+    void feed (const void* data, size_t numBytes);
+
+    /** Flushes the last line (a file need not end with a newline).  Call once
+        after the last feed(). */
+    void finish();
+
+    /** Streams the rest of in through feed() in 64 KB reads, then finish(). */
+    void parse (juce::InputStream& in);
+
+    /** Adds a diagnostic; also used by callers for checks made on entries. */
+    void report (int line, int column, bool isError, const juce::String& message);
+
+    /** At most kMaxDiagnostics are kept; the counts include the dropped ones. */
+    static constexpr int kMaxDiagnostics = 100;
+
+    const juce::Array<Diagnostic>& getDiagnostics() const noexcept { return diagnostics; }
+    int getNumErrors() const noexcept                              { return numErrors; }
+    int getNumWarnings() const noexcept                            { return numWarnings; }
+    int getNumEntries() const noexcept                             { return numEntries; }
+    int getNumLines() const noexcept                               { return lineNumber; }
+
+    //==============================================================================
+    /** Key code for a key token (one character or a key name); -1 if unknown. */
+    static int keyCodeForName (const char* token, int length);
+
+    /** Readable name of a key code, as accepted by keyCodeForName(). */
+    static juce::String getKeyName (int keyCode);
+
+    //==============================================================================
+    /** Fuzz target.  Parses data whole, then again in chunks of random size,
+        and checks that both runs agree and that every entry and diagnostic
+        is well formed.  Returns an empty string or the first broken invariant. */
+    static juce::String selfCheck (const void* data, size_t numBytes, juce::Random& random);
+
+    struct FuzzResult
+    {
+        int               iterations = 0;
+        juce::int64       bytes      = 0;
+        juce::String      failure;           ///< empty = every input passed
+        juce::MemoryBlock failingInput;
+    };
+
+    /** Runs selfCheck() on iterations inputs mutated from generated mapping text. */
+    static FuzzResult fuzz (int iterations, juce::int64 seed);
+
+    struct BenchmarkResult
+    {
+        juce::int64 bytes              = 0;
+        int         lines              = 0;
+        int         entries            = 0;
+        double      bestSeconds        = 0.0;
+        double      megabytesPerSecond = 0.0;
+    };
+
+    /** Parses a generated file of the given size, best of a few runs. */
+    static BenchmarkResult benchmark (int megabytes);
+
+    /** Well-formed mapping text of about numBytes bytes, cycling through every
+        section and a mix of character keys, key names and comments. */
+    static juce::MemoryBlock generateSample (size_t numBytes, juce::Random& random);
+
+private:
+    //==============================================================================
+    void endLine();
+    void parseLine (const char* text, int length);
+    void parseSectionHeader (const char* text, int begin, int end);
+    void parseMapping (const char* text, int begin, int end);
+
+    EntrySink sink;
+
+    char        lineBuffer[kMaxLineLength];
+    int         lineLength   = 0;
+    int         lineBytes    = 0;      ///< including the comment
+    int         lineNumber   = 0;      ///< lines completed so far
+    bool        inComment    = false;
+    bool        lineTooLong  = false;
+    Section     section      = Section::bass;
+
+    juce::Array<Diagnostic> diagnostics;
+    int numErrors   = 0;
+    int numWarnings = 0;
+    int numEntries  = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KeyboardMappingParser)
+};
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Keyboard-mapping hot reload implementation.
+
+  ==============================================================================
+*/
+
+#include "KeyboardMappingWatcher.h"
+
+//==============================================================================
+juce::String KeyboardMappingWatcher::Report::getSummary() const
+{
+    juce::String s (file.getFileName() + ": ");
+
+    if (! fileFound)
+        return s + "not found, built-in mapping";
+
+    s << numKeys << " keys";
+    if (numErrors > 0)   s << ", " << numErrors   << (numErrors   == 1 ? " error"   : " errors");
+    if (numWarnings > 0) s << ", " << numWarnings << (numWarnings == 1 ? " warning" : " warnings");
+    if (! published)     s << ", previous mapping kept";
+    return s;
+}
+
+//==============================================================================
+KeyboardMappingWatcher::KeyboardMappingWatcher (GridInputController& inputToUpdate)
+    : juce::Thread ("StraDella mapping watcher"),
+      input (inputToUpdate)
+{
+}
+
+KeyboardMappingWatcher::~KeyboardMappingWatcher()
+{
+    stop();
+    cancelPendingUpdate();
+}
+
+juce::File KeyboardMappingWatcher::getDefaultFile()
+{
+    return juce::File::getSpecialLocation (juce::File::userDocumentsDirectory)
+               .getChildFile ("StraDella Mappings")
+               .getChildFile ("keyboard_mapping.txt");
+}
+
+bool KeyboardMappingWatcher::seedDefaultFile()
+{
+    const auto file = getDefaultFile();
+    if (file.exists())
+        return true;
+
+    return file.getParentDirectory().createDirectory()
+        && file.replaceWithData (BinaryData::default_keyboard_mapping_txt,
+                                 (size_t) BinaryData::default_keyboard_mapping_txtSize);
+}
+
+void KeyboardMappingWatcher::watch (const juce::File& file)
+{
+    {
+        const juce::ScopedLock sl (lock);
+        watchedFile = file;
+    }
+
+    if (isThreadRunning())
+        notify();
+    else
+        startThread (juce::Thread::Priority::low);
+}
+
+void KeyboardMappingWatcher::stop()
+{
+    stopThread (2000);
+}
+
+//==============================================================================
+void KeyboardMappingWatcher::run()
+{
+    // What was last loaded; any difference (including the file appearing or
+    // disappearing) triggers a reload.
+    juce::File  loadedFile;
+    juce::Time  loadedTime;
+    juce::int64 loadedSize = -1;
+    bool        loaded     = false;
+
+    // Once per watcher, before the first load: only a first run gets the file.
+    {
+        const juce::ScopedLock sl (lock);
+        if (watchedFile == getDefaultFile())
+            seedDefaultFile();
+    }
+
+    while (! threadShouldExit())
+    {
+        juce::File file;
+        {
+            const juce::ScopedLock sl (lock);
+            file = watchedFile;
+        }
+
+        const bool exists = file.existsAsFile();
+        const auto time   = exists ? file.getLastModificationTime() : juce::Time();
+        const auto size   = exists ? file.getSize() : (juce::int64) -1;
+
+        if (! loaded || file != loadedFile || time != loadedTime || size != loadedSize)
+        {
+            loadedFile = file;
+            loadedTime = time;
+            loadedSize = size;
+            loaded     = true;
+
+            load (file);
+        }
+
+        wait (kPollMs);
+    }
+}
+
+// Watcher thread.  A file caught half-written parses with errors, and is
+// loaded again on the next poll once its size or time settles; until then
+// the keys keep the table they had.
+void KeyboardMappingWatcher::load (const juce::File& file)
+{
+    auto report = std::make_unique<Report>();
+    report->file = file;
+
+    StradellaKeyboardMapper mapper;
+    if (file.existsAsFile())
+        report->fileFound = mapper.loadConfiguration (file, &report->diagnostics);
+
+    for (const auto& d : report->diagnostics)
+        ++(d.isError ? report->numErrors : report->numWarnings);
+
+    mapper.forEachMappedKey ([&report] (int, int, int) { ++report->numKeys; });
+
+    if (report->numErrors == 0)
+    {
+        input.publishKeyTable (KeyboardInputEngine::KeyTable::compile (mapper));
+        report->published = true;
+    }
+
+    {
+        const juce::ScopedLock sl (lock);
+        pendingReport = std::move (report);
+    }
+
+    triggerAsyncUpdate();
+}
+
+void KeyboardMappingWatcher::handleAsyncUpdate()
+{
+    std::unique_ptr<Report> report;
+    {
+        const juce::ScopedLock sl (lock);
+        report = std::move (pendingReport);
+    }
+
+    if (report == nullptr)
+        return;
+
+    lastReport = *report;
+
+    if (onReload != nullptr)
+        onReload (lastReport);
+}
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Hot reload of the keyboard-mapping file.
+
+    A background thread checks the file's modification time and size every
+    kPollMs.  When they change it parses the file there (on top of the
+    built-in mapping, as StradellaKeyboardMapper::loadConfiguration() does),
+    compiles a KeyboardInputEngine::KeyTable and publishes it through
+    GridInputController::publishKeyTable(): one atomic pointer exchange, so
+    the message thread is never blocked and no key event waits for a parse.
+    The input side switches tables on its next key event; keys held across
+    the switch release the cells they were pressed with.
+
+    When the default file does not exist yet, the watcher first writes the
+    shipped default_keyboard_mapping.txt (BinaryData) there, so there is a
+    file to edit.  A file deleted later falls back to the built-in mapping
+    rather than being written again.
+
+    Each load produces a Report (keys, warnings and errors with line and
+    column), delivered to onReload on the message thread.  A file that
+    parses with errors (typically caught half-written) is only reported:
+    the previous table stays live until the next clean parse.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "GridInputController.h"
+#include "KeyboardMappingParser.h"
+
+//==============================================================================
+class KeyboardMappingWatcher : private juce::Thread,
+                               private juce::AsyncUpdater
+{
+public:
+    //==============================================================================
+    static constexpr int kPollMs = 500;
+
+    struct Report
+    {
+        juce::File   file;
+        bool         fileFound   = false;   ///< false = built-in mapping in force
+        int          numKeys     = 0;
+        int          numErrors   = 0;
+        int          numWarnings = 0;
+        bool         published   = false;   ///< false = errors, the previous mapping stays live
+        juce::Array<KeyboardMappingParser::Diagnostic> diagnostics;
+
+        /** One line, e.g. "keyboard_mapping.txt: 40 keys, 1 error". */
+        juce::String getSummary() const;
+    };
+
+    //==============================================================================
+    explicit KeyboardMappingWatcher (GridInputController& input);
+    ~KeyboardMappingWatcher() override;
+
+    /** Starts watching file (message thread); it is loaded straight away on
+        the watcher thread. */
+    void watch (const juce::File& file);
+    void stop();
+
+    /** Called on the message thread after every load. */
+    std::function<void (const Report&)> onReload;
+
+    /** The last load's report (message thread). */
+    const Report& getLastReport() const noexcept   { return lastReport; }
+
+    /** Documents/StraDella Mappings/keyboard_mapping.txt */
+    static juce::File getDefaultFile();
+
+    /** Writes the shipped mapping to getDefaultFile() if nothing is there.
+        Returns false if the file was missing and could not be written. */
+    static bool seedDefaultFile();
+
+private:
+    //==============================================================================
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    void load (const juce::File& file);
+
+    GridInputController& input;
+
+    juce::CriticalSection lock;            // guards watchedFile and pendingReport
+    juce::File            watchedFile;
+    std::unique_ptr<Report> pendingReport;
+
+    Report lastReport;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KeyboardMappingWatcher)
+};
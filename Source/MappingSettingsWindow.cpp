@@ -24,19 +24,20 @@ int MappingSettingsWindow::octaveBoxToOffset (int id)     { return juce::jlimit
 int MappingSettingsWindow::offsetToOctaveBoxId (int offset) { return juce::jlimit (1, 5, offset + 3); }
 
 //==============================================================================
-MappingSettingsWindow::MappingSettingsWindow (StraDellaMIDI_pluginAudioProcessor& processor)
+MappingSettingsWindow::MappingSettingsWindow (StraDellaMIDI_pluginAudioProcessor& processor,
+                                              const KeyboardMappingWatcher::Report& keyboardFileReport)
     : audioProcessor (processor)
 {
-    setupUI();
-    setSize (440, 420);
+    setupUI (keyboardFileReport);
+    setSize (440, 792);
 }
 
 MappingSettingsWindow::~MappingSettingsWindow() {}
 
 //==============================================================================
-void MappingSettingsWindow::setupUI()
+void MappingSettingsWindow::setupUI (const KeyboardMappingWatcher::Report& keyboardFileReport)
 {
-    const auto& vs = audioProcessor.getVoicingSettings();
+    const auto vs = audioProcessor.getVoicingSettings();
 
     // ── Title ─────────────────────────────────────────────────────────────────
     titleLabel.setText ("Voicing Settings", juce::dontSendNotification);
@@ -55,6 +56,10 @@ void MappingSettingsWindow::setupUI()
     makeSectionHeader (voicingSectionLabel, "Voicing",    juce::Colours::lightgrey);
     makeSectionHeader (majorRowLabel,       "Major Row",  juce::Colour (0xffffb347));
     makeSectionHeader (minorRowLabel,       "Minor Row",  juce::Colour (0xff6699ff));
+    makeSectionHeader (voiceLeadingLabel,   "Voice Leading", juce::Colours::lightgrey);
+    makeSectionHeader (strumSectionLabel,   "Chord Roll",    juce::Colours::lightgrey);
+    makeSectionHeader (patternSectionLabel, "Bass Pattern",  juce::Colours::lightgrey);
+    makeSectionHeader (keyboardSectionLabel, "Keyboard Mapping File", juce::Colours::lightgrey);
 
     // ── Third row octave ──────────────────────────────────────────────────────
     thirdOctLabel.setText ("Third row octave:", juce::dontSendNotification);
@@ -62,9 +67,10 @@ void MappingSettingsWindow::setupUI()
     populateOctaveBox (thirdOctaveBox, vs.octaveOffset[StraDellaMIDI_pluginAudioProcessor::COUNTERBASS]);
     thirdOctaveBox.onChange = [this]
     {
-        auto s = audioProcessor.getVoicingSettings();
-        s.octaveOffset[StraDellaMIDI_pluginAudioProcessor::COUNTERBASS] = octaveBoxToOffset (thirdOctaveBox.getSelectedId());
-        audioProcessor.setVoicingSettings (s);
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.octaveOffset[StraDellaMIDI_pluginAudioProcessor::COUNTERBASS] = octaveBoxToOffset (thirdOctaveBox.getSelectedId());
+        });
     };
     addAndMakeVisible (thirdOctaveBox);
 
@@ -74,21 +80,36 @@ void MappingSettingsWindow::setupUI()
     populateOctaveBox (bassOctaveBox, vs.octaveOffset[StraDellaMIDI_pluginAudioProcessor::BASS]);
     bassOctaveBox.onChange = [this]
     {
-        auto s = audioProcessor.getVoicingSettings();
-        s.octaveOffset[StraDellaMIDI_pluginAudioProcessor::BASS] = octaveBoxToOffset (bassOctaveBox.getSelectedId());
-        audioProcessor.setVoicingSettings (s);
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.octaveOffset[StraDellaMIDI_pluginAudioProcessor::BASS] = octaveBoxToOffset (bassOctaveBox.getSelectedId());
+        });
     };
     addAndMakeVisible (bassOctaveBox);
 
+    // ── Bass register ─────────────────────────────────────────────────────────
+    // Item IDs are register indices + 1 (the plugin's programs, in order).
+    registerLabel.setText ("Register:", juce::dontSendNotification);
+    addAndMakeVisible (registerLabel);
+    for (int i = 0; i < BassRegisters::kNumRegisters; ++i)
+        registerBox.addItem (BassRegisters::getName (i), i + 1);
+    registerBox.setSelectedId (audioProcessor.getBassRegister() + 1, juce::dontSendNotification);
+    registerBox.onChange = [this]
+    {
+        audioProcessor.setBassRegister (registerBox.getSelectedId() - 1);
+    };
+    addAndMakeVisible (registerBox);
+
     // ── Major row ─────────────────────────────────────────────────────────────
     majorOctLabel.setText ("Octave:", juce::dontSendNotification);
     addAndMakeVisible (majorOctLabel);
     populateOctaveBox (majorOctaveBox, vs.octaveOffset[StraDellaMIDI_pluginAudioProcessor::MAJOR]);
     majorOctaveBox.onChange = [this]
     {
-        auto s = audioProcessor.getVoicingSettings();
-        s.octaveOffset[StraDellaMIDI_pluginAudioProcessor::MAJOR] = octaveBoxToOffset (majorOctaveBox.getSelectedId());
-        audioProcessor.setVoicingSettings (s);
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.octaveOffset[StraDellaMIDI_pluginAudioProcessor::MAJOR] = octaveBoxToOffset (majorOctaveBox.getSelectedId());
+        });
     };
     addAndMakeVisible (majorOctaveBox);
 
@@ -97,9 +118,10 @@ void MappingSettingsWindow::setupUI()
     populateInversionBox (majorInversionBox, vs.majorInversion);
     majorInversionBox.onChange = [this]
     {
-        auto s = audioProcessor.getVoicingSettings();
-        s.majorInversion = juce::jlimit (0, 2, majorInversionBox.getSelectedId() - 1);
-        audioProcessor.setVoicingSettings (s);
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.majorInversion = juce::jlimit (0, 2, majorInversionBox.getSelectedId() - 1);
+        });
     };
     addAndMakeVisible (majorInversionBox);
 
@@ -108,9 +130,10 @@ void MappingSettingsWindow::setupUI()
     majorLmbToggle.setToggleState (vs.majorLeftMouseAdds7, juce::dontSendNotification);
     majorLmbToggle.onClick = [this]
     {
-        auto s = audioProcessor.getVoicingSettings();
-        s.majorLeftMouseAdds7 = majorLmbToggle.getToggleState();
-        audioProcessor.setVoicingSettings (s);
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.majorLeftMouseAdds7 = majorLmbToggle.getToggleState();
+        });
     };
     addAndMakeVisible (majorLmbToggle);
 
@@ -119,9 +142,10 @@ void MappingSettingsWindow::setupUI()
     majorRmbToggle.setToggleState (vs.majorRightMouseAdds9, juce::dontSendNotification);
     majorRmbToggle.onClick = [this]
     {
-        auto s = audioProcessor.getVoicingSettings();
-        s.majorRightMouseAdds9 = majorRmbToggle.getToggleState();
-        audioProcessor.setVoicingSettings (s);
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.majorRightMouseAdds9 = majorRmbToggle.getToggleState();
+        });
     };
     addAndMakeVisible (majorRmbToggle);
 
@@ -131,9 +155,10 @@ void MappingSettingsWindow::setupUI()
     populateOctaveBox (minorOctaveBox, vs.octaveOffset[StraDellaMIDI_pluginAudioProcessor::MINOR]);
     minorOctaveBox.onChange = [this]
     {
-        auto s = audioProcessor.getVoicingSettings();
-        s.octaveOffset[StraDellaMIDI_pluginAudioProcessor::MINOR] = octaveBoxToOffset (minorOctaveBox.getSelectedId());
-        audioProcessor.setVoicingSettings (s);
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.octaveOffset[StraDellaMIDI_pluginAudioProcessor::MINOR] = octaveBoxToOffset (minorOctaveBox.getSelectedId());
+        });
     };
     addAndMakeVisible (minorOctaveBox);
 
@@ -142,9 +167,10 @@ void MappingSettingsWindow::setupUI()
     populateInversionBox (minorInversionBox, vs.minorInversion);
     minorInversionBox.onChange = [this]
     {
-        auto s = audioProcessor.getVoicingSettings();
-        s.minorInversion = juce::jlimit (0, 2, minorInversionBox.getSelectedId() - 1);
-        audioProcessor.setVoicingSettings (s);
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.minorInversion = juce::jlimit (0, 2, minorInversionBox.getSelectedId() - 1);
+        });
     };
     addAndMakeVisible (minorInversionBox);
 
@@ -153,9 +179,10 @@ void MappingSettingsWindow::setupUI()
     minorLmbToggle.setToggleState (vs.minorLeftMouseAdds7, juce::dontSendNotification);
     minorLmbToggle.onClick = [this]
     {
-        auto s = audioProcessor.getVoicingSettings();
-        s.minorLeftMouseAdds7 = minorLmbToggle.getToggleState();
-        audioProcessor.setVoicingSettings (s);
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.minorLeftMouseAdds7 = minorLmbToggle.getToggleState();
+        });
     };
     addAndMakeVisible (minorLmbToggle);
 
@@ -164,12 +191,145 @@ void MappingSettingsWindow::setupUI()
     minorRmbToggle.setToggleState (vs.minorRightMouseAdds9, juce::dontSendNotification);
     minorRmbToggle.onClick = [this]
     {
-        auto s = audioProcessor.getVoicingSettings();
-        s.minorRightMouseAdds9 = minorRmbToggle.getToggleState();
-        audioProcessor.setVoicingSettings (s);
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.minorRightMouseAdds9 = minorRmbToggle.getToggleState();
+        });
     };
     addAndMakeVisible (minorRmbToggle);
 
+    // ── Auto inversion ────────────────────────────────────────────────────────
+    autoInversionLabel.setText ("Auto inversion (smoothest move from previous chord):", juce::dontSendNotification);
+    addAndMakeVisible (autoInversionLabel);
+    autoInversionToggle.setToggleState (vs.autoInversion, juce::dontSendNotification);
+    autoInversionToggle.onClick = [this]
+    {
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.autoInversion = autoInversionToggle.getToggleState();
+        });
+    };
+    addAndMakeVisible (autoInversionToggle);
+
+    // Range IDs are the lowest allowed chord tone (MIDI note); the range spans one octave.
+    autoRangeLabel.setText ("Lowest chord tone:", juce::dontSendNotification);
+    addAndMakeVisible (autoRangeLabel);
+    for (int low : { 41, 45, 48, 52, 55 })
+        autoRangeBox.addItem (juce::MidiMessage::getMidiNoteName (low,      true, true, 4) + " - "
+                            + juce::MidiMessage::getMidiNoteName (low + 12, true, true, 4), low);
+    autoRangeBox.setSelectedId (vs.autoInversionLowNote, juce::dontSendNotification);
+    autoRangeBox.onChange = [this]
+    {
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.autoInversionLowNote = autoRangeBox.getSelectedId();
+        });
+    };
+    addAndMakeVisible (autoRangeBox);
+
+    // ── Chord roll ────────────────────────────────────────────────────────────
+    // Item IDs are VoicingSettings::StrumDirection values + 1.
+    strumDirectionLabel.setText ("Roll:", juce::dontSendNotification);
+    addAndMakeVisible (strumDirectionLabel);
+    strumDirectionBox.addItem ("Off (all notes together)", VoicingSettings::strumOff    + 1);
+    strumDirectionBox.addItem ("Up",                       VoicingSettings::strumUp     + 1);
+    strumDirectionBox.addItem ("Down",                     VoicingSettings::strumDown   + 1);
+    strumDirectionBox.addItem ("Random",                   VoicingSettings::strumRandom + 1);
+    strumDirectionBox.setSelectedId (vs.strumDirection + 1, juce::dontSendNotification);
+    strumDirectionBox.onChange = [this]
+    {
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.strumDirection = strumDirectionBox.getSelectedId() - 1;
+        });
+    };
+    addAndMakeVisible (strumDirectionBox);
+
+    auto setupRollSlider = [this](juce::Slider& slider, juce::Label& lbl, const juce::String& text,
+                                  double min, double max, const juce::String& suffix, double value)
+    {
+        lbl.setText (text, juce::dontSendNotification);
+        addAndMakeVisible (lbl);
+        slider.setSliderStyle (juce::Slider::LinearHorizontal);
+        slider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 50, 20);
+        slider.setRange (min, max, 1.0);
+        slider.setTextValueSuffix (suffix);
+        slider.setValue (value, juce::dontSendNotification);
+        addAndMakeVisible (slider);
+    };
+
+    setupRollSlider (strumSpreadSlider, strumSpreadLabel, "Roll time:", 0.0, 50.0, " ms", vs.strumSpreadMs);
+    strumSpreadSlider.onValueChange = [this]
+    {
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.strumSpreadMs = (float) strumSpreadSlider.getValue();
+        });
+    };
+
+    setupRollSlider (strumTiltSlider, strumTiltLabel, "Velocity tilt:", -40.0, 40.0, {}, vs.strumVelocityTilt);
+    strumTiltSlider.onValueChange = [this]
+    {
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            s.strumVelocityTilt = (int) strumTiltSlider.getValue();
+        });
+    };
+
+    // ── Bass pattern ──────────────────────────────────────────────────────────
+    // Item IDs are BassPatternEngine::Pattern values + 1.
+    const auto ps = audioProcessor.getPatternSettings();
+
+    patternLabel.setText ("Pattern:", juce::dontSendNotification);
+    addAndMakeVisible (patternLabel);
+    for (int p = 0; p < (int) BassPatternEngine::Pattern::numPatterns; ++p)
+        patternBox.addItem (BassPatternEngine::getPatternName ((BassPatternEngine::Pattern) p), p + 1);
+    patternBox.setSelectedId ((int) ps.pattern + 1, juce::dontSendNotification);
+    patternBox.onChange = [this]
+    {
+        auto s = audioProcessor.getPatternSettings();
+        s.pattern = (BassPatternEngine::Pattern) (patternBox.getSelectedId() - 1);
+        audioProcessor.setPatternSettings (s);
+    };
+    addAndMakeVisible (patternBox);
+
+    gateLabel.setText ("Note length:", juce::dontSendNotification);
+    addAndMakeVisible (gateLabel);
+    gateSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    gateSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 50, 20);
+    gateSlider.setRange (10.0, 95.0, 1.0);
+    gateSlider.setTextValueSuffix (" %");
+    gateSlider.setValue (ps.gate * 100.0, juce::dontSendNotification);
+    gateSlider.onValueChange = [this]
+    {
+        auto s = audioProcessor.getPatternSettings();
+        s.gate = (float) gateSlider.getValue() / 100.0f;
+        audioProcessor.setPatternSettings (s);
+    };
+    addAndMakeVisible (gateSlider);
+
+    // ── Keyboard mapping file (reloaded automatically when saved) ────────────
+    keyboardFile = keyboardFileReport.file;
+
+    auto fileText = keyboardFile.getFullPathName() + "\n" + keyboardFileReport.getSummary();
+    if (! keyboardFileReport.diagnostics.isEmpty())
+        fileText << "  -  " << keyboardFileReport.diagnostics.getReference (0).toString();
+
+    keyboardFileLabel.setText (fileText, juce::dontSendNotification);
+    keyboardFileLabel.setFont (juce::Font (juce::FontOptions (12.0f)));
+    keyboardFileLabel.setColour (juce::Label::textColourId,
+                                 keyboardFileReport.numErrors > 0 ? juce::Colour (0xffff7766) : juce::Colours::lightgrey);
+    keyboardFileLabel.setMinimumHorizontalScale (0.7f);
+    addAndMakeVisible (keyboardFileLabel);
+
+    keyboardFolderButton.onClick = [this]
+    {
+        const auto dir = keyboardFile.getParentDirectory();
+        dir.createDirectory();
+        dir.startAsProcess();
+    };
+    addAndMakeVisible (keyboardFolderButton);
+
     // ── Close button ──────────────────────────────────────────────────────────
     closeButton.setButtonText ("Close");
     closeButton.onClick = [this]
@@ -207,7 +367,7 @@ void MappingSettingsWindow::resized()
     voicingSectionLabel.setBounds (area.removeFromTop (sh));
     area.removeFromTop (4);
 
-    auto makeOctRow = [&](juce::Label& lbl, juce::ComboBox& box)
+    auto makeOctRow = [&](juce::Label& lbl, juce::Component& box)
     {
         auto row = area.removeFromTop (rh);
         lbl.setBounds (row.removeFromLeft (130));
@@ -216,6 +376,7 @@ void MappingSettingsWindow::resized()
     };
     makeOctRow (thirdOctLabel, thirdOctaveBox);
     makeOctRow (bassOctLabel,  bassOctaveBox);
+    makeOctRow (registerLabel, registerBox);
 
     area.removeFromTop (8);
 
@@ -265,6 +426,42 @@ void MappingSettingsWindow::resized()
     makeCheckRow (minorLmbToggle, minorLmbLabel);
     makeCheckRow (minorRmbToggle, minorRmbLabel);
 
+    area.removeFromTop (8);
+
+    // ── Voice Leading ─────────────────────────────────────────────────────────
+    voiceLeadingLabel.setBounds (area.removeFromTop (sh));
+    area.removeFromTop (4);
+    makeCheckRow (autoInversionToggle, autoInversionLabel);
+    makeOctRow   (autoRangeLabel, autoRangeBox);
+
+    area.removeFromTop (8);
+
+    // ── Chord Roll ────────────────────────────────────────────────────────────
+    strumSectionLabel.setBounds (area.removeFromTop (sh));
+    area.removeFromTop (4);
+    makeOctRow (strumDirectionLabel, strumDirectionBox);
+    makeOctRow (strumSpreadLabel,    strumSpreadSlider);
+    makeOctRow (strumTiltLabel,      strumTiltSlider);
+
+    area.removeFromTop (8);
+
+    // ── Bass Pattern ──────────────────────────────────────────────────────────
+    patternSectionLabel.setBounds (area.removeFromTop (sh));
+    area.removeFromTop (4);
+    makeOctRow (patternLabel, patternBox);
+    makeOctRow (gateLabel,    gateSlider);
+
+    area.removeFromTop (8);
+
+    // ── Keyboard Mapping File ─────────────────────────────────────────────────
+    keyboardSectionLabel.setBounds (area.removeFromTop (sh));
+    area.removeFromTop (4);
+    {
+        auto row = area.removeFromTop (36);
+        keyboardFolderButton.setBounds (row.removeFromRight (100).withSizeKeepingCentre (96, rh));
+        keyboardFileLabel.setBounds (row);
+    }
+
     // ── Close button ──────────────────────────────────────────────────────────
     area.removeFromTop (12);
     closeButton.setBounds (area.removeFromTop (30).withSizeKeepingCentre (100, 28));
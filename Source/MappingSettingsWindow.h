@@ -2,18 +2,23 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "KeyboardMappingWatcher.h"
 
 //==============================================================================
 /**
     Settings window for chord voicing.  Allows the user to choose per-row octave
     offsets, chord inversions, and toggle the left/right mouse button chord
-    extensions for the Major and Minor rows.
+    extensions for the Major and Minor rows.  Auto inversion (voice leading)
+    and its register range are configured here as well, as are the chord roll
+    and the automatic bass pattern.  The last keyboard-mapping file load is
+    shown at the bottom, with its first problem if it had any.
 */
 class MappingSettingsWindow : public juce::Component
 {
 public:
     //==============================================================================
-    explicit MappingSettingsWindow (StraDellaMIDI_pluginAudioProcessor& processor);
+    MappingSettingsWindow (StraDellaMIDI_pluginAudioProcessor& processor,
+                           const KeyboardMappingWatcher::Report& keyboardFile);
     ~MappingSettingsWindow() override;
 
     void paint  (juce::Graphics& g) override;
@@ -36,6 +41,10 @@ private:
     juce::ComboBox minorOctaveBox;
     juce::Label    thirdOctLabel, bassOctLabel, majorOctLabel, minorOctLabel;
 
+    // ── Bass register switch ─────────────────────────────────────────────────
+    juce::ComboBox registerBox;
+    juce::Label    registerLabel;
+
     // ── Major row voicing ─────────────────────────────────────────────────────
     juce::ComboBox     majorInversionBox;
     juce::Label        majorInvLabel;
@@ -52,10 +61,39 @@ private:
     juce::ToggleButton minorRmbToggle;
     juce::Label        minorRmbLabel;
 
+    // ── Auto inversion (voice leading) ──────────────────────────────────────
+    juce::Label        voiceLeadingLabel;
+    juce::ToggleButton autoInversionToggle;
+    juce::Label        autoInversionLabel;
+    juce::ComboBox     autoRangeBox;
+    juce::Label        autoRangeLabel;
+
+    // ── Chord roll ───────────────────────────────────────────────────────────
+    juce::Label        strumSectionLabel;
+    juce::ComboBox     strumDirectionBox;
+    juce::Label        strumDirectionLabel;
+    juce::Slider       strumSpreadSlider;
+    juce::Label        strumSpreadLabel;
+    juce::Slider       strumTiltSlider;
+    juce::Label        strumTiltLabel;
+
+    // ── Bass pattern ─────────────────────────────────────────────────────────
+    juce::Label        patternSectionLabel;
+    juce::ComboBox     patternBox;
+    juce::Label        patternLabel;
+    juce::Slider       gateSlider;
+    juce::Label        gateLabel;
+
+    // ── Keyboard mapping file ────────────────────────────────────────────────
+    juce::Label        keyboardSectionLabel;
+    juce::Label        keyboardFileLabel;
+    juce::TextButton   keyboardFolderButton { "Open folder" };
+    juce::File         keyboardFile;
+
     juce::TextButton closeButton;
 
     //==============================================================================
-    void setupUI();
+    void setupUI (const KeyboardMappingWatcher::Report& keyboardFileReport);
 
     static void populateOctaveBox    (juce::ComboBox& box, int currentOffset);
     static void populateInversionBox (juce::ComboBox& box, int currentInversion);
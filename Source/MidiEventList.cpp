@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Generated-event list implementation.
+
+  ==============================================================================
+*/
+
+#include "MidiEventList.h"
+
+//==============================================================================
+void MidiEventList::reserve (int capacity)
+{
+    events.resize ((size_t) juce::jmax (1, capacity));
+    numEvents = 0;
+}
+
+bool MidiEventList::add (const juce::uint8* data, int size, int sampleOffset, int priority) noexcept
+{
+    if (numEvents >= (int) events.size() || size <= 0 || size > 3)
+    {
+        ++numDropped;
+        return false;
+    }
+
+    auto& e = events[(size_t) numEvents];
+    e.sampleOffset = sampleOffset;
+    e.order        = (juce::uint32) numEvents;
+    e.size         = (juce::uint8) size;
+    e.priority     = (juce::uint8) juce::jlimit (0, 255, priority);
+    std::memcpy (e.data, data, (size_t) size);
+
+    ++numEvents;
+    return true;
+}
+
+void MidiEventList::sort() noexcept
+{
+    // std::sort with a unique (offset, order) key: stable result, no allocation.
+    std::sort (events.begin(), events.begin() + numEvents, [] (const Event& a, const Event& b)
+    {
+        return a.sampleOffset != b.sampleOffset ? a.sampleOffset < b.sampleOffset
+                                                : a.order < b.order;
+    });
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Fixed-capacity list of generated short MIDI events for one block.
+
+    The generators inside processBlock (UI queue, chord roll, bass pattern)
+    append to this list instead of inserting into the host's MidiBuffer one
+    event at a time.  At the end of the block the list is sorted once and
+    merged with the host input in a single linear pass (see
+    StraDellaMIDI_pluginAudioProcessor::processBlock) into a MidiBuffer
+    whose storage was reserved in prepareToPlay.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class MidiEventList
+{
+public:
+    //==============================================================================
+    struct Event
+    {
+        int          sampleOffset = 0;
+        juce::uint32 order        = 0;   ///< insertion order, keeps the sort stable
+        juce::uint8  size         = 0;
+        juce::uint8  data[3]      {};
+        juce::uint8  priority     = 1;   ///< steal priority of a note-on (see VoiceLimiter)
+    };
+
+    //==============================================================================
+    MidiEventList() = default;
+
+    /** Allocates room for `capacity` events.  Not real-time safe. */
+    void reserve (int capacity);
+
+    void clear() noexcept                      { numEvents = 0; }
+
+    /** Appends a short message.  Returns false (and counts a drop) when the
+        list is full or the message is longer than 3 bytes. */
+    bool add (const juce::uint8* data, int size, int sampleOffset, int priority = 1) noexcept;
+    bool add (const juce::MidiMessage& message, int sampleOffset, int priority = 1) noexcept
+    {
+        return add (message.getRawData(), message.getRawDataSize(), sampleOffset, priority);
+    }
+
+    /** Sorts by sample offset, preserving insertion order for equal offsets. */
+    void sort() noexcept;
+
+    const Event* begin() const noexcept        { return events.data(); }
+    const Event* end()   const noexcept        { return events.data() + numEvents; }
+    int          size()  const noexcept        { return numEvents; }
+    int          getCapacity() const noexcept  { return (int) events.size(); }
+    juce::int64  getNumDropped() const noexcept { return numDropped; }
+
+    //==============================================================================
+    /** Bytes a MidiBuffer needs per stored event of `numBytes` data bytes. */
+    static constexpr size_t bytesPerEvent (size_t numBytes) noexcept
+    {
+        return sizeof (juce::int32) + sizeof (juce::uint16) + numBytes;
+    }
+
+private:
+    //==============================================================================
+    std::vector<Event> events;
+    int                numEvents  = 0;
+    juce::int64        numDropped = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiEventList)
+};
@@ -0,0 +1,347 @@
+#include "MidiMonitorWindow.h"
+
+//==============================================================================
+MidiMonitorWindow::MidiMonitorWindow (StraDellaMIDI_pluginAudioProcessor& processor)
+    : audioProcessor (processor),
+      outputTap (processor.getOutputTap()),
+      inputRecorder (processor.getInputRecorder())
+{
+    // Discard anything left over from a previous monitor session, then start
+    // capturing.  The tap is only written to while it is enabled.
+    while (outputTap.read (readBuffer, kReadChunk) > 0) {}
+    outputTap.setEnabled (true);
+
+    setupUI();
+    setSize (520, 500);
+    startTimerHz (30);
+}
+
+MidiMonitorWindow::~MidiMonitorWindow()
+{
+    stopTimer();
+    outputTap.setEnabled (false);
+}
+
+//==============================================================================
+void MidiMonitorWindow::setupUI()
+{
+    titleLabel.setText ("MIDI Output Monitor", juce::dontSendNotification);
+    titleLabel.setFont (juce::Font (juce::FontOptions (17.0f, juce::Font::bold)));
+    titleLabel.setJustificationType (juce::Justification::centred);
+    addAndMakeVisible (titleLabel);
+
+    statusLabel.setColour (juce::Label::textColourId, juce::Colours::lightgrey);
+    addAndMakeVisible (statusLabel);
+
+    eventList.setModel (this);
+    eventList.setRowHeight (18);
+    eventList.setColour (juce::ListBox::backgroundColourId, juce::Colour (0xff1a1a2e));
+    addAndMakeVisible (eventList);
+
+    followToggle.setToggleState (true, juce::dontSendNotification);
+    addAndMakeVisible (followToggle);
+
+    clearButton.onClick = [this]
+    {
+        history.clearQuick();
+        cappedBefore = -1;
+        eventList.updateContent();
+        eventList.repaint();
+    };
+    addAndMakeVisible (clearButton);
+
+    // Export range: IDs are minutes.
+    for (int minutes : { 1, 5, 10, kHistoryMinutes })
+        exportMinutesBox.addItem ("Last " + juce::String (minutes) + " min", minutes);
+    exportMinutesBox.setSelectedId (5, juce::dontSendNotification);
+    addAndMakeVisible (exportMinutesBox);
+
+    exportButton.onClick = [this] { exportToMidiFile(); };
+    addAndMakeVisible (exportButton);
+
+    // ── Input session recording ───────────────────────────────────────────────
+    recordToggle.setTooltip ("Record every pointer sample, click, key and settings change to "
+                             "Documents/StraDella Sessions for deterministic replay "
+                             "(Benchmarks/InputReplay).");
+    recordToggle.setToggleState (inputRecorder.isRecording(), juce::dontSendNotification);
+    recordToggle.onClick = [this] { toggleInputRecording(); };
+    addAndMakeVisible (recordToggle);
+
+    sessionLabel.setColour (juce::Label::textColourId, juce::Colours::lightgrey);
+    addAndMakeVisible (sessionLabel);
+
+    closeButton.onClick = [this]
+    {
+        if (auto* dw = findParentComponentOfClass<juce::DialogWindow>())
+            dw->closeButtonPressed();
+        else
+            setVisible (false);
+    };
+    addAndMakeVisible (closeButton);
+}
+
+//==============================================================================
+void MidiMonitorWindow::timerCallback()
+{
+    bool added = false;
+
+    for (;;)
+    {
+        const int n = outputTap.read (readBuffer, kReadChunk);
+        if (n == 0)
+            break;
+
+        history.addArray (readBuffer, n);
+        added = true;
+    }
+
+    if (added)
+    {
+        // Drop what no export range reaches, then apply the cap.  Trim in
+        // large chunks so the O(n) removal happens rarely.
+        const double sr     = outputTap.getSampleRate();
+        const auto   oldest = history.getLast().getSamplePosition()
+                            - (juce::int64) ((kHistoryMinutes + 1) * 60.0 * sr);
+
+        if (sr > 0.0 && history.getFirst().getSamplePosition() < oldest - (juce::int64) (60.0 * sr))
+        {
+            int expired = 0;
+            while (expired < history.size() && history.getReference (expired).getSamplePosition() < oldest)
+                ++expired;
+
+            history.removeRange (0, expired);
+        }
+
+        if (history.size() > kMaxHistory)
+        {
+            const int excess = history.size() - kMaxHistory + kMaxHistory / 10;
+            cappedBefore = history.getReference (excess - 1).getSamplePosition();
+            history.removeRange (0, excess);
+        }
+
+        eventList.updateContent();
+        if (followToggle.getToggleState())
+            eventList.scrollToEnsureRowIsOnscreen (history.size() - 1);
+        eventList.repaint();
+    }
+
+    // Refreshed every tick; setText() ignores unchanged text.
+    const auto& limiter = audioProcessor.getVoiceLimiter();
+    auto status = juce::String (history.size()) + " events   dropped: "
+                + juce::String (outputTap.getNumDropped())
+                + "   voices: " + juce::String (limiter.getNumActive())
+                + "   stolen: " + juce::String ((juce::int64) limiter.getNumStolen());
+
+    const auto bs = audioProcessor.getBoundaryStats();
+    if (bs.eventsOverflowed > 0 || bs.eventsExpired > 0)
+        status << "   queue overflow: " << juce::String ((juce::int64) bs.eventsOverflowed)
+               << " expired: " << juce::String ((juce::int64) bs.eventsExpired);
+
+    const auto& direct = audioProcessor.getDirectOutput();
+    if (direct.isActive())
+    {
+        const auto ds = direct.getLatencyStats();
+        status << "   direct: " << juce::String (ds.meanUs, 0) << "/" << juce::String (ds.maxUs, 0)
+               << " us";
+        if (ds.dropped > 0)
+            status << " (" << juce::String ((juce::int64) ds.dropped) << " dropped)";
+    }
+
+    statusLabel.setText (status, juce::dontSendNotification);
+
+    if (inputRecorder.isRecording())
+        sessionLabel.setText ("Recording: " + juce::String (inputRecorder.getNumRecorded()) + " records"
+                                + (inputRecorder.getNumDropped() > 0
+                                     ? "   dropped: " + juce::String (inputRecorder.getNumDropped())
+                                     : juce::String()),
+                              juce::dontSendNotification);
+}
+
+//==============================================================================
+void MidiMonitorWindow::toggleInputRecording()
+{
+    if (! recordToggle.getToggleState())
+    {
+        inputRecorder.stop();
+        sessionLabel.setText ("Saved " + inputRecorder.getFile().getFileName(), juce::dontSendNotification);
+        return;
+    }
+
+    const auto file = juce::File::getSpecialLocation (juce::File::userDocumentsDirectory)
+                          .getChildFile ("StraDella Sessions")
+                          .getChildFile ("session-" + juce::Time::getCurrentTime().formatted ("%Y%m%d-%H%M%S") + ".sdis");
+
+    if (! inputRecorder.start (file))
+    {
+        recordToggle.setToggleState (false, juce::dontSendNotification);
+        sessionLabel.setText ("Could not start recording", juce::dontSendNotification);
+    }
+}
+
+//==============================================================================
+int MidiMonitorWindow::getNumRows()
+{
+    return history.size();
+}
+
+void MidiMonitorWindow::paintListBoxItem (int rowNumber, juce::Graphics& g,
+                                          int width, int height, bool rowIsSelected)
+{
+    if (! juce::isPositiveAndBelow (rowNumber, history.size()))
+        return;
+
+    if (rowIsSelected)
+        g.fillAll (juce::Colour (0xff3a3a5e));
+
+    const auto& e  = history.getReference (rowNumber);
+    const double sr = outputTap.getSampleRate();
+
+    const juce::String description = e.size > 0
+        ? juce::MidiMessage (e.data, (int) e.size).getDescription()
+        : juce::String ("SysEx / long message");
+
+    g.setColour (juce::Colours::lightgrey);
+    g.setFont (juce::FontOptions (12.0f));
+    g.drawText (juce::String ((double) e.getSamplePosition() / sr, 3) + " s",
+                4, 0, 80, height, juce::Justification::centredLeft, false);
+    g.drawText ("+" + juce::String (e.sampleOffset),
+                88, 0, 50, height, juce::Justification::centredLeft, false);
+
+    g.setColour (juce::Colours::white);
+    g.drawText (description, 142, 0, width - 146, height, juce::Justification::centredLeft, true);
+}
+
+//==============================================================================
+void MidiMonitorWindow::exportToMidiFile()
+{
+    const double minutes = (double) exportMinutesBox.getSelectedId();
+
+    fileChooser = std::make_unique<juce::FileChooser> (
+        "Export MIDI output",
+        juce::File::getSpecialLocation (juce::File::userDocumentsDirectory).getChildFile ("straDella_output.mid"),
+        "*.mid");
+
+    fileChooser->launchAsync (juce::FileBrowserComponent::saveMode
+                                | juce::FileBrowserComponent::canSelectFiles
+                                | juce::FileBrowserComponent::warnAboutOverwriting,
+        [safeThis = juce::Component::SafePointer<MidiMonitorWindow> (this), minutes] (const juce::FileChooser& fc)
+        {
+            if (safeThis == nullptr)
+                return;
+
+            const auto file = fc.getResult();
+            if (file == juce::File())
+                return;
+
+            bool truncated = false;
+            const auto result = safeThis->writeMidiFile (file.withFileExtension ("mid"), minutes, truncated);
+
+            if (result.failed())
+                juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon, "Export failed",
+                                                        result.getErrorMessage());
+            else if (truncated)
+                juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon, "Export truncated",
+                    "The monitor history holds at most " + juce::String (kMaxHistory)
+                    + " events, so the export starts later than the last "
+                    + juce::String ((int) minutes) + " min.");
+        });
+}
+
+juce::Result MidiMonitorWindow::writeMidiFile (const juce::File& file, double minutes, bool& truncated) const
+{
+    truncated = false;
+
+    if (history.isEmpty())
+        return juce::Result::fail ("The monitor has not captured any events yet.");
+
+    const double sr      = outputTap.getSampleRate();
+    const auto   lastPos = history.getLast().getSamplePosition();
+    const auto   first   = lastPos - (juce::int64) (minutes * 60.0 * sr);
+
+    // SMPTE 25 fps × 40 ticks per frame = 1000 ticks per second (1 tick = 1 ms).
+    juce::MidiMessageSequence sequence;
+    juce::int64 startPos = -1;
+
+    for (const auto& e : history)
+    {
+        if (e.size == 0 || e.getSamplePosition() < first)
+            continue;
+
+        if (startPos < 0)
+            startPos = e.getSamplePosition();
+
+        const double ms = (double) (e.getSamplePosition() - startPos) * 1000.0 / sr;
+        sequence.addEvent (juce::MidiMessage (e.data, (int) e.size, ms));
+    }
+
+    juce::MidiFile midiFile;
+    midiFile.setSmpteTimeFormat (25, 40);
+    midiFile.addTrack (sequence);
+
+    juce::FileOutputStream out (file);
+    if (! out.openedOk())
+        return juce::Result::fail ("Cannot open " + file.getFullPathName() + ": "
+                                     + out.getStatus().getErrorMessage());
+
+    // Replace any previous contents of the file.
+    out.setPosition (0);
+    const auto cleared = out.truncate();
+    if (cleared.failed())
+        return cleared;
+
+    if (! midiFile.writeTo (out))
+        return juce::Result::fail ("Cannot write " + file.getFullPathName() + ".");
+
+    out.flush();
+    if (out.getStatus().failed())
+        return juce::Result::fail ("Cannot write " + file.getFullPathName() + ": "
+                                     + out.getStatus().getErrorMessage());
+
+    truncated = cappedBefore >= first;
+    return juce::Result::ok();
+}
+
+//==============================================================================
+void MidiMonitorWindow::paint (juce::Graphics& g)
+{
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+    g.setColour (juce::Colours::grey);
+    g.drawRect (getLocalBounds(), 2);
+}
+
+void MidiMonitorWindow::resized()
+{
+    const int m  = 15;   // outer margin
+    const int rh = 22;   // standard row height
+    const int g  =  6;   // gap between rows
+
+    auto area = getLocalBounds().reduced (m);
+
+    titleLabel.setBounds (area.removeFromTop (28));
+    area.removeFromTop (8);
+
+    closeButton.setBounds (area.removeFromBottom (30).withSizeKeepingCentre (100, 28));
+    area.removeFromBottom (g);
+
+    {
+        auto row = area.removeFromBottom (rh);
+        followToggle.setBounds     (row.removeFromLeft (80));
+        clearButton.setBounds      (row.removeFromLeft (70).reduced (2, 0));
+        exportButton.setBounds     (row.removeFromRight (100).reduced (2, 0));
+        exportMinutesBox.setBounds (row.removeFromRight (110).reduced (2, 0));
+    }
+    area.removeFromBottom (g);
+
+    {
+        auto row = area.removeFromBottom (rh);
+        recordToggle.setBounds (row.removeFromLeft (110));
+        row.removeFromLeft (10);
+        sessionLabel.setBounds (row);
+    }
+    area.removeFromBottom (g);
+
+    statusLabel.setBounds (area.removeFromBottom (rh));
+    area.removeFromBottom (g);
+
+    eventList.setBounds (area);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "MidiOutputTap.h"
+
+//==============================================================================
+/**
+    MIDI monitor for the events leaving processBlock.
+
+    While open, the window enables the processor's MidiOutputTap and drains it
+    at 30 Hz into a history buffer.  The list is a virtualised juce::ListBox,
+    so only the visible rows are formatted and painted.  "Export .mid" writes
+    the last N minutes of history to a Standard MIDI File (millisecond ticks).
+
+    The status line shows the output stage's counters (voices, steals, queue
+    overflow, direct-output latency); its settings are in
+    OutputSettingsWindow.  "Record input" captures a raw input session
+    (InputRecorder) for Benchmarks/InputReplay.
+*/
+class MidiMonitorWindow : public juce::Component,
+                          private juce::ListBoxModel,
+                          private juce::Timer
+{
+public:
+    //==============================================================================
+    explicit MidiMonitorWindow (StraDellaMIDI_pluginAudioProcessor& processor);
+    ~MidiMonitorWindow() override;
+
+    void paint  (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    //==============================================================================
+    // ListBoxModel
+    int  getNumRows() override;
+    void paintListBoxItem (int rowNumber, juce::Graphics& g,
+                           int width, int height, bool rowIsSelected) override;
+
+    // Timer: drains the output tap.
+    void timerCallback() override;
+
+    void exportToMidiFile();
+
+    /** Writes the last `minutes` of history.  `truncated` is set when the
+        history no longer reaches back that far (the event cap cut it). */
+    juce::Result writeMidiFile (const juce::File& file, double minutes, bool& truncated) const;
+
+    void toggleInputRecording();
+
+    //==============================================================================
+    StraDellaMIDI_pluginAudioProcessor& audioProcessor;
+    MidiOutputTap&                      outputTap;
+
+    // History keeps the longest export range; the event cap (about 32 MB)
+    // stops an open monitor growing without limit on very busy sessions.
+    static constexpr int kHistoryMinutes = 30;
+    static constexpr int kMaxHistory     = 2000000;
+    static constexpr int kReadChunk      = 1024;
+
+    juce::Array<MidiOutputTap::Event> history;
+
+    // Sample position of the newest event the cap removed; -1 = none.
+    juce::int64 cappedBefore = -1;
+    MidiOutputTap::Event              readBuffer[kReadChunk];
+
+    juce::Label      titleLabel;
+    juce::Label      statusLabel;
+    juce::ListBox    eventList;
+    juce::ToggleButton followToggle { "Follow" };
+    juce::TextButton clearButton    { "Clear" };
+    juce::ComboBox   exportMinutesBox;
+    juce::TextButton exportButton   { "Export .mid" };
+    juce::TextButton closeButton    { "Close" };
+
+    InputRecorder&     inputRecorder;
+    juce::ToggleButton recordToggle { "Record input" };
+    juce::Label        sessionLabel;
+
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
+    //==============================================================================
+    void setupUI();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiMonitorWindow)
+};
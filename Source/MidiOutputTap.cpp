@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Lock-free MIDI output tap implementation.
+
+  ==============================================================================
+*/
+
+#include "MidiOutputTap.h"
+
+//==============================================================================
+void MidiOutputTap::capture (const juce::MidiBuffer& buffer, juce::int64 blockStartSample) noexcept
+{
+    const int numEvents = buffer.getNumEvents();
+    if (numEvents == 0)
+        return;
+
+    const int numToWrite = juce::jmin (numEvents, fifo.getFreeSpace());
+    if (numToWrite < numEvents)
+        dropped.fetch_add (numEvents - numToWrite, std::memory_order_relaxed);
+
+    auto it = buffer.cbegin();
+    fifo.write (numToWrite).forEach ([&] (int index)
+    {
+        const auto metadata = *it;
+        ++it;
+
+        auto& e = events[index];
+        e.blockStartSample = blockStartSample;
+        e.sampleOffset     = metadata.samplePosition;
+        e.size             = (juce::uint8) (metadata.numBytes <= 3 ? metadata.numBytes : 0);
+        std::memcpy (e.data, metadata.data, e.size);
+    });
+}
+
+int MidiOutputTap::read (Event* dest, int maxEvents) noexcept
+{
+    const int numToRead = juce::jmin (maxEvents, fifo.getNumReady());
+    int n = 0;
+
+    fifo.read (numToRead).forEach ([&] (int index)
+    {
+        dest[n++] = events[index];
+    });
+
+    return n;
+}
@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Lock-free tap on the processor's MIDI output.
+
+    The audio thread copies every event leaving processBlock (with the sample
+    position of its block) into a fixed-size single-producer/single-consumer
+    FIFO; the MIDI monitor window drains it on the message thread.  When no
+    monitor is open the tap is disabled and processBlock only pays for one
+    relaxed atomic load.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class MidiOutputTap
+{
+public:
+    //==============================================================================
+    /** One captured output event.  Messages longer than three bytes (SysEx)
+        are recorded with size 0 so gaps remain visible in the monitor. */
+    struct Event
+    {
+        juce::int64 blockStartSample = 0;   // running sample position of the block
+        int         sampleOffset     = 0;   // offset within the block
+        juce::uint8 size             = 0;
+        juce::uint8 data[3]          {};
+
+        juce::int64 getSamplePosition() const noexcept { return blockStartSample + sampleOffset; }
+    };
+
+    static constexpr int kCapacity = 8192;
+
+    //==============================================================================
+    MidiOutputTap() = default;
+
+    void setEnabled (bool shouldBeEnabled) noexcept  { enabled.store (shouldBeEnabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept                  { return enabled.load (std::memory_order_relaxed); }
+
+    void   setSampleRate (double newRate) noexcept   { sampleRate.store (newRate, std::memory_order_relaxed); }
+    double getSampleRate() const noexcept            { return sampleRate.load (std::memory_order_relaxed); }
+
+    /** Audio thread: copies every event in buffer.  Never blocks or allocates;
+        events that do not fit are counted as dropped. */
+    void capture (const juce::MidiBuffer& buffer, juce::int64 blockStartSample) noexcept;
+
+    /** Message thread: moves up to maxEvents captured events into dest.
+        Returns the number of events read. */
+    int read (Event* dest, int maxEvents) noexcept;
+
+    /** Number of events lost because the monitor did not drain the FIFO in time. */
+    juce::int64 getNumDropped() const noexcept       { return dropped.load (std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    juce::AbstractFifo fifo { kCapacity };
+    Event              events[kCapacity];
+
+    std::atomic<bool>        enabled    { false };
+    std::atomic<double>      sampleRate { 44100.0 };
+    std::atomic<juce::int64> dropped    { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiOutputTap)
+};
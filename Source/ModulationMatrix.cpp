@@ -0,0 +1,265 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Modulation matrix implementation.
+
+  ==============================================================================
+*/
+
+#include "ModulationMatrix.h"
+
+namespace
+{
+    // Bellows pressure follower: builds quickly, leaks away slowly.
+    constexpr double kPressureAttackSeconds  = 0.08;
+    constexpr double kPressureReleaseSeconds = 0.4;
+}
+
+//==============================================================================
+juce::String ModulationMatrix::getSourceName (Source s)
+{
+    switch (s)
+    {
+        case Source::pointerY:        return "Pointer Y";
+        case Source::bellowsSpeed:    return "Bellows speed";
+        case Source::bellowsPressure: return "Bellows pressure";
+        case Source::hostCC:          return "Host CC";
+        case Source::velocity:        return "Velocity";
+        case Source::lfo:             return "LFO";
+        case Source::numSources:
+        default:                      return {};
+    }
+}
+
+juce::String ModulationMatrix::getDestinationName (Destination d)
+{
+    switch (d)
+    {
+        case Destination::off:             return "Off";
+        case Destination::cc:              return "CC";
+        case Destination::pitchBend:       return "Pitch bend";
+        case Destination::channelPressure: return "Pressure";
+        case Destination::noteVelocity:    return "Velocity";
+        case Destination::numDestinations:
+        default:                           return {};
+    }
+}
+
+bool ModulationMatrix::Route::operator== (const Route& other) const noexcept
+{
+    return source == other.source && sourceCC == other.sourceCC
+        && destination == other.destination && destCC == other.destCC
+        && depth == other.depth && curve == other.curve;
+}
+
+ModulationMatrix::Settings::Settings() noexcept
+{
+    routes[0].destination = Destination::noteVelocity;
+
+    routes[1].destination = Destination::cc;
+    routes[1].destCC      = 1;     // modulation wheel
+
+    routes[2].destination = Destination::cc;
+    routes[2].destCC      = 11;    // expression
+}
+
+bool ModulationMatrix::Settings::operator== (const Settings& other) const noexcept
+{
+    for (int i = 0; i < kMaxRoutes; ++i)
+        if (routes[i] != other.routes[i])
+            return false;
+
+    return lfoRateHz == other.lfoRateHz;
+}
+
+//==============================================================================
+ModulationMatrix::ModulationMatrix()
+{
+    std::fill (std::begin (destSlot), std::end (destSlot), -1);
+    std::fill (std::begin (lastSent), std::end (lastSent), -1);
+}
+
+void ModulationMatrix::prepare (double newSampleRate) noexcept
+{
+    sampleRate   = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+    lfoPhase     = 0.0;
+    noteVelocity = -1;
+    recentreBend = false;
+
+    std::fill (std::begin (sourceValues), std::end (sourceValues), 0.0f);
+    std::fill (std::begin (lastSent), std::end (lastSent), -1);
+}
+
+void ModulationMatrix::setPointerSources (float pointerY, float bellowsSpeed) noexcept
+{
+    pointerYValue.store     (juce::jlimit (0.0f, 1.0f, pointerY),     std::memory_order_relaxed);
+    bellowsSpeedValue.store (juce::jlimit (0.0f, 1.0f, bellowsSpeed), std::memory_order_relaxed);
+}
+
+int ModulationMatrix::sourceIndexFor (const Route& r) noexcept
+{
+    switch (r.source)
+    {
+        case Source::bellowsSpeed:    return kBellowsSpeed;
+        case Source::bellowsPressure: return kBellowsPressure;
+        case Source::hostCC:          return kFirstHostCC + juce::jlimit (0, 127, r.sourceCC);
+        case Source::velocity:        return kVelocity;
+        case Source::lfo:             return kLfo;
+        case Source::pointerY:
+        case Source::numSources:
+        default:                      return kPointerY;
+    }
+}
+
+int ModulationMatrix::slotFor (const Route& r) noexcept
+{
+    switch (r.destination)
+    {
+        case Destination::cc:              return juce::jlimit (0, 127, r.destCC);
+        case Destination::pitchBend:       return kPitchBendSlot;
+        case Destination::channelPressure: return kPressureSlot;
+        case Destination::noteVelocity:    return kVelocitySlot;
+        case Destination::off:
+        case Destination::numDestinations:
+        default:                           return -1;
+    }
+}
+
+void ModulationMatrix::setSettings (const Settings& s) noexcept
+{
+    lfoRateHz = juce::jlimit (0.05f, 20.0f, s.lfoRateHz);
+
+    int previousSlots[kMaxRoutes];
+    const int numPrevious = numUsedSlots;
+    std::copy (usedSlots, usedSlots + numPrevious, previousSlots);
+
+    auto isUsed = [this] (int slot)
+    {
+        return std::find (usedSlots, usedSlots + numUsedSlots, slot) != usedSlots + numUsedSlots;
+    };
+
+    numUsedSlots = 0;
+
+    for (int i = 0; i < kMaxRoutes; ++i)
+    {
+        const auto& r    = s.routes[i];
+        const int   slot = slotFor (r);
+        const float d    = slot < 0 ? 0.0f : juce::jlimit (-1.0f, 1.0f, r.depth);
+
+        destSlot[i]     = slot;
+        sourceIndex[i]  = slot < 0 ? kPointerY : sourceIndexFor (r);
+        depth[i]        = d;
+        bias[i]         = (d < 0.0f && slot != kPitchBendSlot) ? -d : 0.0f;
+        curveRow[i]     = juce::jlimit (0, CurveBank::kNumCurves - 1, (int) r.curve) * CurveBank::kStride;
+
+        if (slot >= 0 && ! isUsed (slot))
+            usedSlots[numUsedSlots++] = slot;
+    }
+
+    // A destination that is no longer driven is sent afresh if a route picks
+    // it up again; pitch bend is also returned to the centre.
+    for (int k = 0; k < numPrevious; ++k)
+    {
+        const int slot = previousSlots[k];
+        if (isUsed (slot))
+            continue;
+
+        if (slot == kPitchBendSlot && lastSent[slot] >= 0 && lastSent[slot] != 8192)
+            recentreBend = true;
+
+        lastSent[slot] = -1;
+    }
+
+    if (isUsed (kPitchBendSlot))
+        recentreBend = false;
+}
+
+void ModulationMatrix::handleInput (const juce::uint8* data, int size) noexcept
+{
+    if (size != 3)
+        return;
+
+    const auto status = data[0] & 0xf0;
+
+    if (status == 0xb0)
+        sourceValues[kFirstHostCC + (data[1] & 0x7f)] = (float) data[2] / 127.0f;
+    else if (status == 0x90 && data[2] > 0)
+        sourceValues[kVelocity] = (float) data[2] / 127.0f;
+}
+
+//==============================================================================
+void ModulationMatrix::process (int numSamples, const CurveBank::Tables& curves, MidiEventList& out) noexcept
+{
+    const double seconds = (double) numSamples / sampleRate;
+
+    // Sources that move every block, evaluated whether or not a route uses
+    // them so they are already settled when one is added.
+    const float speed = bellowsSpeedValue.load (std::memory_order_relaxed);
+    auto& pressure    = sourceValues[kBellowsPressure];
+    const double tau  = speed > pressure ? kPressureAttackSeconds : kPressureReleaseSeconds;
+
+    sourceValues[kPointerY]     = pointerYValue.load (std::memory_order_relaxed);
+    sourceValues[kBellowsSpeed] = speed;
+    pressure += (speed - pressure) * (float) (1.0 - std::exp (-seconds / tau));
+
+    sourceValues[kLfo] = 0.5f + 0.5f * (float) std::sin (juce::MathConstants<double>::twoPi * lfoPhase);
+    lfoPhase += (double) lfoRateHz * seconds;
+    lfoPhase -= std::floor (lfoPhase);
+
+    noteVelocity = -1;
+
+    if (recentreBend)
+    {
+        send (kPitchBendSlot, 8192, out);
+        lastSent[kPitchBendSlot] = -1;
+        recentreBend = false;
+    }
+
+    if (numUsedSlots == 0)
+        return;
+
+    for (int i = 0; i < kMaxRoutes; ++i)
+        input[i] = sourceValues[sourceIndex[i]];
+
+    // Fixed trip count, no branches (unused lanes have zero depth).
+    curves.evaluate (curveRow, input, output, kMaxRoutes);
+
+    for (int i = 0; i < kMaxRoutes; ++i)
+        output[i] = bias[i] + depth[i] * output[i];
+
+    for (int k = 0; k < numUsedSlots; ++k)
+        sums[usedSlots[k]] = 0.0f;
+
+    for (int i = 0; i < kMaxRoutes; ++i)
+        if (destSlot[i] >= 0)
+            sums[destSlot[i]] += output[i];
+
+    for (int k = 0; k < numUsedSlots; ++k)
+    {
+        const int   slot = usedSlots[k];
+        const float v    = sums[slot];
+
+        if (slot == kVelocitySlot)
+            noteVelocity = juce::jlimit (1, 127, juce::roundToInt (v * 127.0f));
+        else if (slot == kPitchBendSlot)
+            send (slot, juce::jlimit (0, 16383, 8192 + juce::roundToInt (v * 8191.0f)), out);
+        else
+            send (slot, juce::jlimit (0, 127, juce::roundToInt (v * 127.0f)), out);
+    }
+}
+
+void ModulationMatrix::send (int slot, int value, MidiEventList& out) noexcept
+{
+    if (lastSent[slot] == value)
+        return;
+
+    lastSent[slot] = value;
+
+    if (slot == kPitchBendSlot)
+        out.add (juce::MidiMessage::pitchWheel (1, value), 0);
+    else if (slot == kPressureSlot)
+        out.add (juce::MidiMessage::channelPressureChange (1, value), 0);
+    else
+        out.add (juce::MidiMessage::controllerEvent (1, slot, value), 0);
+}
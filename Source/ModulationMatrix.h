@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Modulation matrix: expression sources routed to MIDI destinations.
+
+    Each route takes one source (pointer Y, bellows speed, bellows pressure,
+    a host CC, the last note velocity or the LFO), shapes it with its own
+    curve and depth, and adds it to one destination (any CC, pitch bend,
+    channel pressure, or the velocity of grid note-ons).  Routes sharing a
+    destination are summed.  The default settings route pointer Y to note
+    velocity, CC1 and CC11: the matrix is the only source of those.
+
+    The routes are compiled into fixed-size arrays, one per field, with
+    kMaxRoutes lanes; unused lanes have zero depth.  process() runs once per
+    block on the audio thread: one gather of the source values, one batch
+    lookup in the CurveBank tables, then a fixed-length loop of multiplies
+    and adds the compiler can vectorise, then a pass over the destinations
+    in use that sends the values that changed.
+    A negative depth inverts the route; on the one-sided destinations the
+    route then falls from |depth| to 0 instead of rising from 0.
+
+    Bellows pressure is the bellows speed through an attack/release
+    follower, so it builds while the bellows move and leaks away when they
+    stop.
+
+    Nothing here locks or allocates.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MidiEventList.h"
+#include "CurveBank.h"
+
+//==============================================================================
+class ModulationMatrix
+{
+public:
+    //==============================================================================
+    static constexpr int kMaxRoutes = 8;
+
+    enum class Source : juce::uint8
+    {
+        pointerY = 0,       ///< filtered pointer height, 1 at the top of the screen
+        bellowsSpeed,       ///< horizontal pointer speed
+        bellowsPressure,    ///< bellows speed through an attack/release follower
+        hostCC,             ///< a CC arriving on the host MIDI input
+        velocity,           ///< velocity of the last note-on (grid or host)
+        lfo,                ///< sine LFO
+        numSources
+    };
+
+    enum class Destination : juce::uint8
+    {
+        off = 0,
+        cc,
+        pitchBend,
+        channelPressure,
+        noteVelocity,       ///< replaces the velocity of the grid's note-ons
+        numDestinations
+    };
+
+    using Curve = CurveBank::Curve;
+
+    static juce::String getSourceName      (Source s);
+    static juce::String getDestinationName (Destination d);
+
+    struct Route
+    {
+        Source      source      = Source::pointerY;
+        int         sourceCC    = 1;       ///< hostCC source only
+        Destination destination = Destination::off;
+        int         destCC      = 1;       ///< cc destination only
+        float       depth       = 1.0f;    ///< -1 .. 1
+        Curve       curve       = Curve::linear;
+
+        bool operator== (const Route& other) const noexcept;
+        bool operator!= (const Route& other) const noexcept   { return ! (*this == other); }
+    };
+
+    /** User settings (copied to the audio thread when they change). */
+    struct Settings
+    {
+        Settings() noexcept;   ///< pointer Y -> velocity, CC1 and CC11; the rest off
+
+        Route routes[kMaxRoutes];
+        float lfoRateHz = 1.0f;            ///< 0.05 - 20 Hz
+
+        bool operator== (const Settings& other) const noexcept;
+        bool operator!= (const Settings& other) const noexcept   { return ! (*this == other); }
+    };
+
+    //==============================================================================
+    ModulationMatrix();
+
+    /** Forgets every source and sent value; the LFO restarts at phase 0. */
+    void prepare (double sampleRate) noexcept;
+
+    /** Pointer sources, published by the mouse expression (0 - 1 each).
+        Wait-free; any thread. */
+    void setPointerSources (float pointerY, float bellowsSpeed) noexcept;
+
+    /** Audio thread.  Compiles settings into the route arrays. */
+    void setSettings (const Settings& settings) noexcept;
+
+    /** Audio thread.  Takes host CC values and note-on velocities as sources;
+        call for every input event before process(). */
+    void handleInput (const juce::uint8* data, int size) noexcept;
+
+    /** Audio thread, once per block.  Evaluates every route through curves
+        (see CurveBank::acquire()) and adds the destinations whose value
+        changed to out, at sample 0. */
+    void process (int numSamples, const CurveBank::Tables& curves, MidiEventList& out) noexcept;
+
+    /** Velocity for the grid's note-ons this block (1 - 127), or -1 when no
+        route targets note velocity.  Valid after process(). */
+    int getNoteVelocity() const noexcept   { return noteVelocity; }
+
+private:
+    //==============================================================================
+    // Flat source values: the fixed sources, then one slot per host CC.
+    enum { kPointerY = 0, kBellowsSpeed, kBellowsPressure, kVelocity, kLfo, kFirstHostCC,
+           kNumSourceValues = kFirstHostCC + 128 };
+
+    // Destination slots: one per CC, then the channel-wide ones.
+    enum { kPitchBendSlot = 128, kPressureSlot, kVelocitySlot, kNumSlots };
+
+    static int sourceIndexFor (const Route& r) noexcept;
+    static int slotFor        (const Route& r) noexcept;
+
+    void send (int slot, int value, MidiEventList& out) noexcept;
+
+    // Compiled routes, one array per field.
+    alignas (32) float depth[kMaxRoutes] {};
+    alignas (32) float bias[kMaxRoutes] {};           ///< |depth| for inverted one-sided routes
+    alignas (32) float input[kMaxRoutes] {};
+    alignas (32) float output[kMaxRoutes] {};
+    alignas (32) int   curveRow[kMaxRoutes] {};       ///< curve index * CurveBank::kStride
+    int                sourceIndex[kMaxRoutes] {};
+    int                destSlot[kMaxRoutes] {};       ///< -1 = unused lane
+
+    int usedSlots[kMaxRoutes] {};
+    int numUsedSlots = 0;
+
+    float sourceValues[kNumSourceValues] {};
+    float sums[kNumSlots] {};
+    int   lastSent[kNumSlots] {};                     ///< -1 = nothing sent yet
+    bool  recentreBend = false;
+
+    std::atomic<float> pointerYValue      { 0.0f };
+    std::atomic<float> bellowsSpeedValue  { 0.0f };
+
+    double sampleRate = 44100.0;
+    double lfoPhase   = 0.0;
+    float  lfoRateHz  = 1.0f;
+    int    noteVelocity = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModulationMatrix)
+};
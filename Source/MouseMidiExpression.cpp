@@ -1,18 +1,18 @@
 #include "MouseMidiExpression.h"
+#include "AsyncLogger.h"
 
 //==============================================================================
 MouseMidiExpression::MouseMidiExpression()
 {
-    // Initialize positions
-    lastMousePosition = juce::Desktop::getInstance().getMainMouseSource().getScreenPosition().toInt();
-    currentMousePosition = lastMousePosition;
-    lastMouseTime = juce::Time::currentTimeMillis();
+    filterX.setParameters(jitterMinCutoffHz, jitterBeta);
+    filterY.setParameters(jitterMinCutoffHz, jitterBeta);
     
     // Get desktop bounds for expression calculation
-    screenBounds = juce::Desktop::getInstance().getDisplays().getPrimaryDisplay()->totalArea;
+    if (auto* display = juce::Desktop::getInstance().getDisplays().getPrimaryDisplay())
+        screenBounds = display->totalArea;
     
-    // Initialize note velocity based on starting Y position
-    currentNoteVelocity = calculateVelocityFromYPosition(lastMousePosition.y);
+    // Initialize positions and note velocity from the starting pointer position
+    resetPointerState(juce::Desktop::getInstance().getMainMouseSource().getScreenPosition().toInt());
 }
 
 MouseMidiExpression::~MouseMidiExpression()
@@ -36,88 +36,208 @@ void MouseMidiExpression::timerCallback()
     // Poll mouse position globally
     auto mousePos = juce::Desktop::getInstance().getMainMouseSource().getScreenPosition().toInt();
     
-    if (mousePos != currentMousePosition)
+    // Keep feeding the filter after the pointer stops so the filtered
+    // position settles on the resting point instead of freezing mid-way,
+    // and send one more sample so the bellows speed returns to zero.
+    if (mousePos != currentMousePosition || !isPointerSettled() || bellowsSpeed > 0.0f)
     {
-        processMouseMovement(mousePos);
+        const auto ticks = juce::Time::getHighResolutionTicks();
+        
+        if (onPointerSample)
+            onPointerSample(mousePos, ticks);
+        
+        processPointerSample(mousePos, ticks);
     }
 }
 
-//==============================================================================
-void MouseMidiExpression::processMouseMovement(const juce::Point<int>& mousePos)
+void MouseMidiExpression::resetPointerState(juce::Point<int> pos)
 {
-    currentMousePosition = mousePos;
-    juce::int64 currentTime = juce::Time::currentTimeMillis();
-    juce::int64 timeDelta = currentTime - lastMouseTime;
+    lastMousePosition = pos;
+    currentMousePosition = pos;
+    lastMouseTime = 0;
+    filteredMousePosition = pos.toFloat();
+    filterX.reset();
+    filterY.reset();
+    
+    bellowsDirection = BellowsDirection::Unknown;
+    directionAnchorX = filteredMousePosition.x;
+    lastDirectionChangeMs = 0.0;
+    lastRawDeltaXSign = 0;
     
-    // Avoid division by zero
-    if (timeDelta <= 0)
-        timeDelta = 1;
+    pointerY = calculatePointerY(filteredMousePosition.y);
+    currentNoteVelocity = curvedMidiValue(pointerY);
+    bellowsSpeed = 0.0f;
+}
+
+bool MouseMidiExpression::Settings::operator==(const Settings& other) const
+{
+    return retrigger == other.retrigger && jitterFilter == other.jitterFilter
+        && curve == other.curve && deadZonePixels == other.deadZonePixels
+        && minHoldMs == other.minHoldMs && minCutoffHz == other.minCutoffHz
+        && beta == other.beta;
+}
+
+MouseMidiExpression::Settings MouseMidiExpression::getSettings() const
+{
+    Settings s;
+    s.retrigger = retriggerOnDirectionChangeEnabled;
+    s.jitterFilter = jitterFilterEnabled;
+    s.curve = curveType;
+    s.deadZonePixels = directionDeadZonePixels;
+    s.minHoldMs = directionMinHoldMs;
+    s.minCutoffHz = jitterMinCutoffHz;
+    s.beta = jitterBeta;
+    return s;
+}
+
+void MouseMidiExpression::applySettings(const Settings& s)
+{
+    setRetriggerOnDirectionChange(s.retrigger);
+    setCurveType(s.curve);
+    setDirectionDeadZone(s.deadZonePixels);
+    setDirectionMinHoldMs(s.minHoldMs);
+    setJitterFilterParameters(s.minCutoffHz, s.beta);
+    
+    if (s.jitterFilter != jitterFilterEnabled)
+        setJitterFilterEnabled(s.jitterFilter);
+}
+
+void MouseMidiExpression::setJitterFilterEnabled(bool enabled)
+{
+    jitterFilterEnabled = enabled;
+    filterX.reset();
+    filterY.reset();
+}
+
+void MouseMidiExpression::setJitterFilterParameters(float minCutoffHz, float beta)
+{
+    jitterMinCutoffHz = minCutoffHz;
+    jitterBeta = beta;
+    filterX.setParameters(minCutoffHz, beta);
+    filterY.setParameters(minCutoffHz, beta);
+}
+
+bool MouseMidiExpression::isPointerSettled() const
+{
+    if (!jitterFilterEnabled)
+        return true;
     
-    // Calculate note velocity from Y position (127 at top, 0 at bottom)
-    currentNoteVelocity = calculateVelocityFromYPosition(mousePos.y);
+    return std::abs(filteredMousePosition.x - (float)currentMousePosition.x) < 0.5f
+        && std::abs(filteredMousePosition.y - (float)currentMousePosition.y) < 0.5f;
+}
+
+//==============================================================================
+void MouseMidiExpression::processPointerSample(juce::Point<int> mousePos, juce::int64 ticks)
+{
+    currentMousePosition = mousePos;
     
-    // Calculate X movement for direction-change detection
-    int deltaX = currentMousePosition.x - lastMousePosition.x;
-    bool isMovingInX = std::abs(deltaX) > 0;
+    // The sample's own timestamp is the only clock used below.
+    const double timeMs = juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+    juce::int64 currentTime = (juce::int64)timeMs;
     
-    // Detect direction changes and optionally retrigger notes
-    if (isMovingInX)
+    // Filter the raw pointer position (1€ filter, one instance per axis)
+    if (jitterFilterEnabled)
     {
-        bool isMovingRightNow = (deltaX > 0);
-        
-        if (retriggerOnDirectionChangeEnabled && wasMovingInLastFrame && isMovingRightNow != isMovingRight)
-        {
-            if (onDirectionChange)
-                onDirectionChange();
-        }
-        
-        isMovingRight = isMovingRightNow;
-        wasMovingInLastFrame = true;
+        filteredMousePosition = { filterX.process((float)mousePos.x, timeMs),
+                                  filterY.process((float)mousePos.y, timeMs) };
     }
     else
     {
-        wasMovingInLastFrame = false;
+        filteredMousePosition = mousePos.toFloat();
     }
+    ++jitterStats.samplesProcessed;
     
-    // CC values always track Y position
-    float normalized = (float)currentNoteVelocity / 127.0f;
-    float curved = applyCurve(normalized);
-    int ccValue = (int)(curved * 127.0f);
+    // Calculate note velocity from Y position (127 at top, 0 at bottom).
+    // The curve reads the unquantised position; only its output is 7-bit.
+    pointerY = calculatePointerY(filteredMousePosition.y);
+    currentNoteVelocity = curvedMidiValue(pointerY);
     
-    // Send CC1 (Modulation Wheel) if enabled and value changed
-    if (modulationEnabled && std::abs(ccValue - lastModulationValue) >= 1)
+    // Bellows speed from the raw X travel since the previous sample
+    if (lastMouseTime > 0 && currentTime > lastMouseTime)
+        bellowsSpeed = juce::jlimit(0.0f, 1.0f, calculateXVelocity(lastMousePosition, currentMousePosition,
+                                                                   currentTime - lastMouseTime)
+                                                / maxVelocityPixelsPerSecond);
+    else
+        bellowsSpeed = 0.0f;
+    
+    // A raw X reversal is what used to retrigger notes; count the ones the
+    // direction state machine now holds back.
+    const int deltaX = currentMousePosition.x - lastMousePosition.x;
+    const int rawSign = (deltaX > 0) - (deltaX < 0);
+    const bool rawReversal = rawSign != 0 && lastRawDeltaXSign != 0 && rawSign != lastRawDeltaXSign;
+    if (rawSign != 0)
+        lastRawDeltaXSign = rawSign;
+    
+    // Detect direction changes and optionally retrigger notes
+    if (updateBellowsDirection(filteredMousePosition.x, timeMs))
     {
-        sendModulationCC(ccValue);
-        lastModulationValue = ccValue;
+        STRADELLA_LOG(AsyncLogger::Event::directionChange,
+                      bellowsDirection == BellowsDirection::Right ? 1 : -1);
+        
+        if (retriggerOnDirectionChangeEnabled && onDirectionChange)
+            onDirectionChange();
     }
-    
-    // Send CC11 (Expression) if enabled and value changed
-    if (expressionEnabled && std::abs(ccValue - lastExpressionValue) >= 1)
+    else if (rawReversal)
     {
-        sendExpressionCC(ccValue);
-        lastExpressionValue = ccValue;
+        ++jitterStats.rejectedDirectionFlips;
     }
     
+    // The modulation matrix turns these into CCs (and may replace velocity)
+    if (onPointerSources)
+        onPointerSources(pointerY, bellowsSpeed);
+    
     // Update tracking variables
     lastMousePosition = currentMousePosition;
     lastMouseTime = currentTime;
 }
 
-int MouseMidiExpression::calculateVelocityFromYPosition(int yPos) const
+bool MouseMidiExpression::updateBellowsDirection(float filteredX, double timeMs)
 {
-    // Map Y position to velocity: top of screen (y=0) = 127, bottom = 0
-    int screenHeight = screenBounds.getHeight();
+    // Dead-zone/hysteresis state machine.  directionAnchorX follows the furthest
+    // point reached in the current stroke; the direction only flips once the
+    // pointer has travelled back more than the dead-zone from that point and
+    // the previous direction has been held for at least directionMinHoldMs.
+    const float deadZone = (float)directionDeadZonePixels;
     
-    // Guard against division by zero (edge case with unusual display configurations)
-    if (screenHeight <= 0)
-        screenHeight = 1;
+    if (bellowsDirection == BellowsDirection::Unknown)
+    {
+        if (std::abs(filteredX - directionAnchorX) > deadZone)
+        {
+            bellowsDirection = filteredX > directionAnchorX ? BellowsDirection::Right
+                                                            : BellowsDirection::Left;
+            directionAnchorX = filteredX;
+            lastDirectionChangeMs = timeMs;
+        }
+        return false;
+    }
+    
+    const bool movingRight = (bellowsDirection == BellowsDirection::Right);
+    
+    // Still travelling in the current direction: extend the stroke.
+    if (movingRight ? filteredX >= directionAnchorX : filteredX <= directionAnchorX)
+    {
+        directionAnchorX = filteredX;
+        return false;
+    }
     
-    float normalizedY = (float)yPos / (float)screenHeight;
-    normalizedY = juce::jlimit(0.0f, 1.0f, normalizedY);
+    if (std::abs(filteredX - directionAnchorX) <= deadZone)
+        return false;
     
-    // Invert: top = 127, bottom = 0
-    int velocity = (int)((1.0f - normalizedY) * 127.0f);
-    return juce::jlimit(0, 127, velocity);
+    if (timeMs - lastDirectionChangeMs < (double)directionMinHoldMs)
+        return false;
+    
+    bellowsDirection = movingRight ? BellowsDirection::Left : BellowsDirection::Right;
+    directionAnchorX = filteredX;
+    lastDirectionChangeMs = timeMs;
+    return true;
+}
+
+float MouseMidiExpression::calculatePointerY(float yPos) const
+{
+    // Map Y position: top of screen (y=0) = 1, bottom = 0.  The max() guards
+    // against division by zero with unusual display configurations.
+    const int screenHeight = juce::jmax(1, screenBounds.getHeight());
+    return 1.0f - juce::jlimit(0.0f, 1.0f, yPos / (float)screenHeight);
 }
 
 float MouseMidiExpression::calculateXVelocity(const juce::Point<int>& from, 
@@ -138,62 +258,14 @@ float MouseMidiExpression::calculateXVelocity(const juce::Point<int>& from,
 
 float MouseMidiExpression::applyCurve(float normalizedValue) const
 {
-    normalizedValue = juce::jlimit(0.0f, 1.0f, normalizedValue);
+    static_assert((int)CurveType::Drawn == (int)CurveBank::Curve::drawn,
+                  "CurveType must follow CurveBank::Curve");
     
-    switch (curveType)
-    {
-        case CurveType::Linear:
-            return normalizedValue;
-            
-        case CurveType::Exponential:
-            // Exponential curve: x^2
-            return normalizedValue * normalizedValue;
-            
-        case CurveType::Logarithmic:
-            // Logarithmic curve: approximated with sqrt
-            return std::sqrt(normalizedValue);
-            
-        default:
-            return normalizedValue;
-    }
+    const auto& tables = curveBank != nullptr ? curveBank->getTables() : CurveBank::getDefaultTables();
+    return tables.evaluate((CurveBank::Curve)curveType, normalizedValue);
 }
 
-void MouseMidiExpression::sendModulationCC(int value)
+int MouseMidiExpression::curvedMidiValue(float normalizedValue) const
 {
-    value = juce::jlimit(0, 127, value);
-    
-    if (onMidiMessage)
-    {
-        // CC1 = Modulation Wheel, using channel 1 (MIDI channels are 1-based in the API)
-        auto message = juce::MidiMessage::controllerEvent(1, 1, value);
-        
-        #if JUCE_DEBUG
-        juce::Logger::writeToLog("Sending CC1 (Modulation): value=" + juce::String(value) + 
-                                  " channel=" + juce::String(message.getChannel()) +
-                                  " controller=" + juce::String(message.getControllerNumber()) +
-                                  " controllerValue=" + juce::String(message.getControllerValue()));
-        #endif
-        
-        onMidiMessage(message);
-    }
-}
-
-void MouseMidiExpression::sendExpressionCC(int value)
-{
-    value = juce::jlimit(0, 127, value);
-    
-    if (onMidiMessage)
-    {
-        // CC11 = Expression, using channel 1 (MIDI channels are 1-based in the API)
-        auto message = juce::MidiMessage::controllerEvent(1, 11, value);
-        
-        #if JUCE_DEBUG
-        juce::Logger::writeToLog("Sending CC11 (Expression): value=" + juce::String(value) + 
-                                  " channel=" + juce::String(message.getChannel()) +
-                                  " controller=" + juce::String(message.getControllerNumber()) +
-                                  " controllerValue=" + juce::String(message.getControllerValue()));
-        #endif
-        
-        onMidiMessage(message);
-    }
+    return juce::jlimit(0, 127, juce::roundToInt(applyCurve(normalizedValue) * 127.0f));
 }
@@ -1,13 +1,23 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "OneEuroFilter.h"
+#include "CurveBank.h"
 
 //==============================================================================
 /**
     Handles mouse-based MIDI expression control, emulating accordion bellows.
-    - Mouse Y position determines note velocity (127 at top, 0 at bottom)
-    - Mouse Y position determines CC1 and CC11 continuously as the mouse moves
+    - Mouse Y position determines note velocity (127 at top, 0 at bottom),
+      through the response curve, a CurveBank lookup table read at full
+      input resolution
     - X direction changes optionally trigger note off/on for all pressed keys
+    - Y position and X speed are handed on as modulation matrix sources; the
+      matrix's routes turn them into CCs (CC1 and CC11 by default) and may
+      replace the note velocity
+
+    The raw pointer stream is passed through a 1€ filter and bellows direction
+    is decided by a dead-zone/hysteresis state machine, so tremor and trackpad
+    noise neither retrigger notes nor make the pointer sources shake.
     
     Uses global mouse tracking to monitor movement across the entire desktop.
 */
@@ -15,35 +25,62 @@ class MouseMidiExpression : private juce::Timer
 {
 public:
     //==============================================================================
-    /** Curve types for mapping mouse movement to MIDI values */
+    /** Curve types for mapping mouse movement to MIDI values (same order as CurveBank::Curve) */
     enum class CurveType
     {
         Linear,
         Exponential,
-        Logarithmic
+        Logarithmic,
+        SCurve,
+        Drawn
+    };
+    
+    /** Counters describing how much pointer noise the jitter filter rejected */
+    struct JitterFilterStats
+    {
+        juce::int64 samplesProcessed = 0;        // pointer samples fed through the filter
+        juce::int64 rejectedDirectionFlips = 0;  // raw X reversals that did not change bellows direction
+    };
+    
+    /** Every setting that shapes the expression output (recorded with input sessions) */
+    struct Settings
+    {
+        bool retrigger = true;
+        bool jitterFilter = true;
+        CurveType curve = CurveType::Linear;
+        int deadZonePixels = 6;
+        int minHoldMs = 40;
+        float minCutoffHz = 1.5f;
+        float beta = 0.01f;
+        
+        bool operator==(const Settings& other) const;
+        bool operator!=(const Settings& other) const { return !(*this == other); }
     };
     
     //==============================================================================
     MouseMidiExpression();
     ~MouseMidiExpression() override;
     
-    /** Sets whether CC1 (Modulation Wheel) is enabled */
-    void setModulationEnabled(bool enabled) { modulationEnabled = enabled; }
-    
-    /** Sets whether CC11 (Expression) is enabled */
-    void setExpressionEnabled(bool enabled) { expressionEnabled = enabled; }
-    
     /** Sets the curve type for mapping */
     void setCurveType(CurveType type) { curveType = type; }
     
+    /** Sets the curve tables to read (message thread side); nullptr uses the presets */
+    void setCurveBank(const CurveBank* bank) { curveBank = bank; }
+    
     /** Sets whether a direction reversal retriggers held notes */
     void setRetriggerOnDirectionChange(bool enabled) { retriggerOnDirectionChangeEnabled = enabled; }
     
-    /** Gets the current modulation enabled state */
-    bool isModulationEnabled() const { return modulationEnabled; }
+    /** Enables the 1€ pointer filter */
+    void setJitterFilterEnabled(bool enabled);
+    
+    /** Sets the 1€ filter minimum cutoff (Hz) and speed coefficient (beta) */
+    void setJitterFilterParameters(float minCutoffHz, float beta);
+    
+    /** Sets how far (pixels) X must travel back before the bellows direction flips */
+    void setDirectionDeadZone(int pixels) { directionDeadZonePixels = juce::jmax(0, pixels); }
     
-    /** Gets the current expression enabled state */
-    bool isExpressionEnabled() const { return expressionEnabled; }
+    /** Sets the minimum time (ms) a bellows direction is held before it may flip again */
+    void setDirectionMinHoldMs(int ms) { directionMinHoldMs = juce::jmax(0, ms); }
     
     /** Gets the current curve type */
     CurveType getCurveType() const { return curveType; }
@@ -51,15 +88,59 @@ public:
     /** Gets whether direction-change retrigger is enabled */
     bool isRetriggerOnDirectionChangeEnabled() const { return retriggerOnDirectionChangeEnabled; }
     
+    /** Gets whether the 1€ pointer filter is enabled */
+    bool isJitterFilterEnabled() const { return jitterFilterEnabled; }
+    
+    /** Gets the bellows direction dead-zone in pixels */
+    int getDirectionDeadZone() const { return directionDeadZonePixels; }
+    
+    /** Gets the minimum bellows direction hold time in milliseconds */
+    int getDirectionMinHoldMs() const { return directionMinHoldMs; }
+    
+    /** Gets all settings at once */
+    Settings getSettings() const;
+    
+    /** Applies all settings at once */
+    void applySettings(const Settings& s);
+    
+    /** Gets the jitter filter counters */
+    const JitterFilterStats& getJitterFilterStats() const { return jitterStats; }
+    
+    /** Resets the jitter filter counters */
+    void resetJitterFilterStats() { jitterStats = {}; }
+    
     /** Gets the current note velocity based on mouse Y position (127 at top, 0 at bottom) */
     int getCurrentNoteVelocity() const { return currentNoteVelocity; }
     
-    /** Callback for MIDI message output */
-    std::function<void(const juce::MidiMessage&)> onMidiMessage;
+    /** Gets the filtered Y position, normalised (1.0 at top, 0.0 at bottom) */
+    float getPointerY() const { return pointerY; }
+    
+    /** Gets the horizontal pointer speed, normalised to maxVelocityPixelsPerSecond (0.0 - 1.0) */
+    float getBellowsSpeed() const { return bellowsSpeed; }
     
     /** Callback when X direction changes (bellows direction change) */
     std::function<void()> onDirectionChange;
     
+    /** Called with every polled pointer sample just before it is processed */
+    std::function<void(juce::Point<int>, juce::int64)> onPointerSample;
+    
+    /** Called after every processed sample with getPointerY() and getBellowsSpeed()
+        (modulation matrix sources) */
+    std::function<void(float, float)> onPointerSources;
+    
+    /** Feeds one pointer sample (screen position) through the filter and
+        direction chain.  ticks is juce::Time::getHighResolutionTicks() at the
+        sample and is the only clock the chain reads, so a recorded sample
+        stream replays to exactly the same output. */
+    void processPointerSample(juce::Point<int> mousePos, juce::int64 ticks);
+    
+    /** Forgets all pointer history and restarts from pos (session start / replay) */
+    void resetPointerState(juce::Point<int> pos);
+    
+    /** Sets the area whose height maps Y position to velocity (defaults to the primary display) */
+    void setScreenBounds(juce::Rectangle<int> bounds) { screenBounds = bounds; }
+    juce::Rectangle<int> getScreenBounds() const { return screenBounds; }
+    
     /** Starts global mouse tracking */
     void startTracking();
     
@@ -72,16 +153,30 @@ private:
     void timerCallback() override;
     
     //==============================================================================
-    bool modulationEnabled = true;      // CC1 enabled by default
-    bool expressionEnabled = true;      // CC11 enabled by default
     bool retriggerOnDirectionChangeEnabled = true; // Retrigger notes on direction change by default
     CurveType curveType = CurveType::Linear;
+    const CurveBank* curveBank = nullptr;
     
     int currentNoteVelocity = 0;        // Current velocity based on Y position
-    
-    // Direction tracking
-    bool isMovingRight = true;          // Track horizontal direction
-    bool wasMovingInLastFrame = false;  // Track if mouse was moving in X
+    float pointerY = 0.0f;              // Filtered Y position, 1 at top
+    float bellowsSpeed = 0.0f;          // Normalised X speed of the last sample
+    
+    // Jitter filtering
+    bool jitterFilterEnabled = true;    // 1€ filter enabled by default
+    float jitterMinCutoffHz = 1.5f;
+    float jitterBeta = 0.01f;
+    OneEuroFilter filterX, filterY;
+    juce::Point<float> filteredMousePosition;
+    JitterFilterStats jitterStats;
+    
+    // Bellows direction state machine
+    enum class BellowsDirection { Unknown, Right, Left };
+    BellowsDirection bellowsDirection = BellowsDirection::Unknown;
+    float directionAnchorX = 0.0f;      // Furthest X reached in the current stroke
+    double lastDirectionChangeMs = 0.0;
+    int lastRawDeltaXSign = 0;          // Sign of the last non-zero raw X delta
+    int directionDeadZonePixels = 6;
+    int directionMinHoldMs = 40;
     
     // Velocity scaling constants
     static constexpr float maxVelocityPixelsPerSecond = 2000.0f;  // Max velocity for normalization
@@ -90,17 +185,17 @@ private:
     juce::Point<int> currentMousePosition;
     juce::int64 lastMouseTime = 0;
     
-    int lastModulationValue = 64;   // Last sent CC1 value (0-127)
-    int lastExpressionValue = 64;   // Last sent CC11 value (0-127)
-    
     juce::Rectangle<int> screenBounds;
     
     //==============================================================================
-    /** Processes mouse movement and generates MIDI messages */
-    void processMouseMovement(const juce::Point<int>& mousePos);
+    /** Advances the bellows direction state machine; returns true when the direction flipped */
+    bool updateBellowsDirection(float filteredX, double timeMs);
+    
+    /** Returns true once the filtered position has caught up with the raw pointer */
+    bool isPointerSettled() const;
     
-    /** Calculates velocity from mouse Y position (127 at top, 0 at bottom) */
-    int calculateVelocityFromYPosition(int yPos) const;
+    /** Normalises a Y position (1.0 at top, 0.0 at bottom) */
+    float calculatePointerY(float yPos) const;
     
     /** Calculates X movement velocity */
     float calculateXVelocity(const juce::Point<int>& from, const juce::Point<int>& to, 
@@ -109,11 +204,8 @@ private:
     /** Applies curve to a normalized value (0.0 to 1.0) */
     float applyCurve(float normalizedValue) const;
     
-    /** Sends CC1 (Modulation Wheel) MIDI message */
-    void sendModulationCC(int value);
-    
-    /** Sends CC11 (Expression) MIDI message */
-    void sendExpressionCC(int value);
+    /** Curved pointer Y as a 7-bit MIDI velocity */
+    int curvedMidiValue(float normalizedValue) const;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MouseMidiExpression)
 };
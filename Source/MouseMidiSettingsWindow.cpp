@@ -6,10 +6,14 @@ MouseMidiSettingsWindow::MouseMidiSettingsWindow (MouseMidiExpression& midiExpre
     : mouseMidiExpression (midiExpression), audioProcessor (processor)
 {
     setupUI();
-    setSize (440, 240);
+    setSize (440, 824);
+    startTimer (500);
 }
 
-MouseMidiSettingsWindow::~MouseMidiSettingsWindow() {}
+MouseMidiSettingsWindow::~MouseMidiSettingsWindow()
+{
+    stopTimer();
+}
 
 //==============================================================================
 void MouseMidiSettingsWindow::setupUI()
@@ -26,20 +30,6 @@ void MouseMidiSettingsWindow::setupUI()
     expressionSectionLabel.setColour (juce::Label::textColourId, juce::Colours::lightgrey);
     addAndMakeVisible (expressionSectionLabel);
 
-    // ── CC1 (Modulation Wheel) ─────────────────────────────────────────────────
-    modulationLabel.setText ("CC1 (Modulation) — Y position while moving:", juce::dontSendNotification);
-    addAndMakeVisible (modulationLabel);
-    modulationCheckbox.setToggleState (mouseMidiExpression.isModulationEnabled(), juce::dontSendNotification);
-    modulationCheckbox.onClick = [this] { mouseMidiExpression.setModulationEnabled (modulationCheckbox.getToggleState()); };
-    addAndMakeVisible (modulationCheckbox);
-
-    // ── CC11 (Expression) ─────────────────────────────────────────────────────
-    expressionLabel.setText ("CC11 (Expression) — Y position while moving:", juce::dontSendNotification);
-    addAndMakeVisible (expressionLabel);
-    expressionCheckbox.setToggleState (mouseMidiExpression.isExpressionEnabled(), juce::dontSendNotification);
-    expressionCheckbox.onClick = [this] { mouseMidiExpression.setExpressionEnabled (expressionCheckbox.getToggleState()); };
-    addAndMakeVisible (expressionCheckbox);
-
     // ── Retrigger ─────────────────────────────────────────────────────────────
     retriggerLabel.setText ("Retrigger notes on bellows direction change:", juce::dontSendNotification);
     addAndMakeVisible (retriggerLabel);
@@ -50,26 +40,154 @@ void MouseMidiSettingsWindow::setupUI()
     // ── Curve selector ────────────────────────────────────────────────────────
     curveLabel.setText ("Response Curve:", juce::dontSendNotification);
     addAndMakeVisible (curveLabel);
+    // Item id = CurveType + 1 (the CurveType order matches CurveBank::Curve).
     curveSelector.addItem ("Linear",      1);
     curveSelector.addItem ("Exponential", 2);
     curveSelector.addItem ("Logarithmic", 3);
-    switch (mouseMidiExpression.getCurveType())
-    {
-        case MouseMidiExpression::CurveType::Exponential: curveSelector.setSelectedId (2, juce::dontSendNotification); break;
-        case MouseMidiExpression::CurveType::Logarithmic: curveSelector.setSelectedId (3, juce::dontSendNotification); break;
-        default:                                          curveSelector.setSelectedId (1, juce::dontSendNotification); break;
-    }
+    curveSelector.addItem ("S-Curve",     4);
+    curveSelector.addItem ("Drawn",       5);
+    curveSelector.setSelectedId ((int) mouseMidiExpression.getCurveType() + 1, juce::dontSendNotification);
+    // The curve also goes to every pointer Y route (CC1 and CC11 by default),
+    // so velocity and the pointer CCs keep sharing one response.
     curveSelector.onChange = [this]
     {
-        switch (curveSelector.getSelectedId())
-        {
-            case 2:  mouseMidiExpression.setCurveType (MouseMidiExpression::CurveType::Exponential); break;
-            case 3:  mouseMidiExpression.setCurveType (MouseMidiExpression::CurveType::Logarithmic); break;
-            default: mouseMidiExpression.setCurveType (MouseMidiExpression::CurveType::Linear);      break;
-        }
+        const int index = juce::jmax (0, curveSelector.getSelectedId() - 1);
+        mouseMidiExpression.setCurveType ((MouseMidiExpression::CurveType) index);
+        curveEditor.setCurve ((CurveBank::Curve) index);
+
+        for (auto& row : routeRows)
+            if (row.source.getSelectedId() - 1 == (int) ModulationMatrix::Source::pointerY)
+                row.curve.setSelectedId (index + 1, juce::dontSendNotification);
+
+        applyModulationSettings();
     };
     addAndMakeVisible (curveSelector);
 
+    // Click / drag / double-click edits the points of the Drawn curve.
+    curveEditor.setCurve ((CurveBank::Curve) mouseMidiExpression.getCurveType());
+    addAndMakeVisible (curveEditor);
+
+    // ── Jitter filter ─────────────────────────────────────────────────────────
+    jitterSectionLabel.setText ("Jitter Filter", juce::dontSendNotification);
+    jitterSectionLabel.setFont (juce::Font (juce::FontOptions (12.0f, juce::Font::bold)));
+    jitterSectionLabel.setColour (juce::Label::textColourId, juce::Colours::lightgrey);
+    addAndMakeVisible (jitterSectionLabel);
+
+    jitterLabel.setText ("Smooth pointer tremor:", juce::dontSendNotification);
+    addAndMakeVisible (jitterLabel);
+    jitterCheckbox.setToggleState (mouseMidiExpression.isJitterFilterEnabled(), juce::dontSendNotification);
+    jitterCheckbox.onClick = [this] { mouseMidiExpression.setJitterFilterEnabled (jitterCheckbox.getToggleState()); };
+    addAndMakeVisible (jitterCheckbox);
+
+    deadZoneLabel.setText ("Direction dead-zone (px):", juce::dontSendNotification);
+    addAndMakeVisible (deadZoneLabel);
+    deadZoneSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    deadZoneSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 40, 20);
+    deadZoneSlider.setRange (0.0, 40.0, 1.0);
+    deadZoneSlider.setValue (mouseMidiExpression.getDirectionDeadZone(), juce::dontSendNotification);
+    deadZoneSlider.onValueChange = [this] { mouseMidiExpression.setDirectionDeadZone ((int) deadZoneSlider.getValue()); };
+    addAndMakeVisible (deadZoneSlider);
+
+    jitterStatsLabel.setColour (juce::Label::textColourId, juce::Colours::lightgrey);
+    addAndMakeVisible (jitterStatsLabel);
+
+    // ── Modulation matrix ─────────────────────────────────────────────────────
+    modulationSectionLabel.setText ("Modulation Matrix", juce::dontSendNotification);
+    modulationSectionLabel.setFont (juce::Font (juce::FontOptions (12.0f, juce::Font::bold)));
+    modulationSectionLabel.setColour (juce::Label::textColourId, juce::Colours::lightgrey);
+    addAndMakeVisible (modulationSectionLabel);
+
+    const auto modulation = audioProcessor.getModulationSettings();
+
+    auto setupCCEditor = [this] (juce::Label& editor, int cc)
+    {
+        editor.setText (juce::String (cc), juce::dontSendNotification);
+        editor.setEditable (true);
+        editor.setJustificationType (juce::Justification::centred);
+        editor.setColour (juce::Label::outlineColourId, juce::Colours::grey);
+        editor.onTextChange = [this] { applyModulationSettings(); };
+        addAndMakeVisible (editor);
+    };
+
+    for (int i = 0; i < ModulationMatrix::kMaxRoutes; ++i)
+    {
+        auto&       row   = routeRows[i];
+        const auto& route = modulation.routes[i];
+
+        for (int s = 0; s < (int) ModulationMatrix::Source::numSources; ++s)
+            row.source.addItem (ModulationMatrix::getSourceName ((ModulationMatrix::Source) s), s + 1);
+        row.source.setSelectedId ((int) route.source + 1, juce::dontSendNotification);
+        row.source.onChange = [this] { applyModulationSettings(); };
+        addAndMakeVisible (row.source);
+
+        for (int d = 0; d < (int) ModulationMatrix::Destination::numDestinations; ++d)
+            row.destination.addItem (ModulationMatrix::getDestinationName ((ModulationMatrix::Destination) d), d + 1);
+        row.destination.setSelectedId ((int) route.destination + 1, juce::dontSendNotification);
+        row.destination.onChange = [this] { applyModulationSettings(); };
+        addAndMakeVisible (row.destination);
+
+        setupCCEditor (row.sourceCC, route.sourceCC);
+        setupCCEditor (row.destCC,   route.destCC);
+
+        row.depth.setSliderStyle (juce::Slider::LinearBar);
+        row.depth.setRange (-1.0, 1.0, 0.01);
+        row.depth.setValue (route.depth, juce::dontSendNotification);
+        row.depth.onValueChange = [this] { applyModulationSettings(); };
+        addAndMakeVisible (row.depth);
+
+        for (int c = 0; c < CurveBank::kNumCurves; ++c)
+            row.curve.addItem (CurveBank::getShortName ((CurveBank::Curve) c), c + 1);
+        row.curve.setSelectedId ((int) route.curve + 1, juce::dontSendNotification);
+        row.curve.onChange = [this] { applyModulationSettings(); };
+        addAndMakeVisible (row.curve);
+
+        row.sourceCC.setEnabled (route.source == ModulationMatrix::Source::hostCC);
+        row.destCC.setEnabled   (route.destination == ModulationMatrix::Destination::cc);
+    }
+
+    lfoRateLabel.setText ("LFO rate (Hz):", juce::dontSendNotification);
+    addAndMakeVisible (lfoRateLabel);
+    lfoRateSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    lfoRateSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 50, 20);
+    lfoRateSlider.setRange (0.05, 20.0, 0.01);
+    lfoRateSlider.setSkewFactorFromMidPoint (2.0);
+    lfoRateSlider.setValue (modulation.lfoRateHz, juce::dontSendNotification);
+    lfoRateSlider.onValueChange = [this] { applyModulationSettings(); };
+    addAndMakeVisible (lfoRateSlider);
+
+    // ── OSC remote control ────────────────────────────────────────────────────
+    auto& osc = audioProcessor.getOscReceiver();
+
+    oscSectionLabel.setText ("Remote Control (OSC)", juce::dontSendNotification);
+    oscSectionLabel.setFont (juce::Font (juce::FontOptions (12.0f, juce::Font::bold)));
+    oscSectionLabel.setColour (juce::Label::textColourId, juce::Colours::lightgrey);
+    addAndMakeVisible (oscSectionLabel);
+
+    oscLabel.setText ("Listen for OSC messages over UDP", juce::dontSendNotification);
+    addAndMakeVisible (oscLabel);
+    oscCheckbox.setToggleState (osc.isRunning(), juce::dontSendNotification);
+    oscCheckbox.onClick = [this] { applyOscSettings(); };
+    addAndMakeVisible (oscCheckbox);
+
+    oscNetworkLabel.setText ("Accept from other machines (default: this one only)", juce::dontSendNotification);
+    addAndMakeVisible (oscNetworkLabel);
+    oscNetworkCheckbox.setToggleState (! osc.isLocalhostOnly(), juce::dontSendNotification);
+    oscNetworkCheckbox.onClick = [this] { applyOscSettings(); };
+    addAndMakeVisible (oscNetworkCheckbox);
+
+    oscPortLabel.setText ("UDP port:", juce::dontSendNotification);
+    addAndMakeVisible (oscPortLabel);
+    oscPortEditor.setText (juce::String (osc.getPort()), juce::dontSendNotification);
+    oscPortEditor.setEditable (true);
+    oscPortEditor.setColour (juce::Label::outlineColourId, juce::Colours::grey);
+    oscPortEditor.onTextChange = [this] { applyOscSettings(); };
+    addAndMakeVisible (oscPortEditor);
+
+    oscStatsLabel.setColour (juce::Label::textColourId, juce::Colours::lightgrey);
+    addAndMakeVisible (oscStatsLabel);
+
+    timerCallback();
+
     // ── Close button ──────────────────────────────────────────────────────────
     closeButton.setButtonText ("Close");
     closeButton.onClick = [this]
@@ -82,6 +200,75 @@ void MouseMidiSettingsWindow::setupUI()
     addAndMakeVisible (closeButton);
 }
 
+void MouseMidiSettingsWindow::timerCallback()
+{
+    const auto& stats = mouseMidiExpression.getJitterFilterStats();
+    jitterStatsLabel.setText ("Samples: "            + juce::String (stats.samplesProcessed)
+                              + "   Flips rejected: " + juce::String (stats.rejectedDirectionFlips),
+                              juce::dontSendNotification);
+
+    const auto& osc = audioProcessor.getOscReceiver();
+    const auto  oscStats = osc.getStats();
+
+    juce::String text = osc.isRunning() ? "Messages: " + juce::String (oscStats.received)
+                                            + "   rejected: " + juce::String (oscStats.rejected)
+                                        : juce::String ("Not listening");
+    // Filled by stamped press/release, e.g. from Benchmarks/OscSender.
+    if (oscStats.stamped > 0)
+        text << "   queued in " << juce::String (oscStats.meanQueueUs, 0) << " us avg, "
+             << juce::String (oscStats.maxQueueUs, 0) << " us max, "
+             << juce::String (oscStats.ratePerS / 1000.0, 1) << "k msg/s";
+
+    oscStatsLabel.setText (text, juce::dontSendNotification);
+}
+
+void MouseMidiSettingsWindow::applyModulationSettings()
+{
+    ModulationMatrix::Settings s;
+
+    for (int i = 0; i < ModulationMatrix::kMaxRoutes; ++i)
+    {
+        auto& row   = routeRows[i];
+        auto& route = s.routes[i];
+
+        route.source      = (ModulationMatrix::Source)      (row.source.getSelectedId() - 1);
+        route.destination = (ModulationMatrix::Destination) (row.destination.getSelectedId() - 1);
+        route.curve       = (ModulationMatrix::Curve)       (row.curve.getSelectedId() - 1);
+        route.sourceCC    = juce::jlimit (0, 127, row.sourceCC.getText().getIntValue());
+        route.destCC      = juce::jlimit (0, 127, row.destCC.getText().getIntValue());
+        route.depth       = (float) row.depth.getValue();
+
+        row.sourceCC.setText (juce::String (route.sourceCC), juce::dontSendNotification);
+        row.destCC.setText   (juce::String (route.destCC),   juce::dontSendNotification);
+        row.sourceCC.setEnabled (route.source == ModulationMatrix::Source::hostCC);
+        row.destCC.setEnabled   (route.destination == ModulationMatrix::Destination::cc);
+    }
+
+    s.lfoRateHz = (float) lfoRateSlider.getValue();
+    audioProcessor.setModulationSettings (s);
+}
+
+void MouseMidiSettingsWindow::applyOscSettings()
+{
+    auto& osc = audioProcessor.getOscReceiver();
+    const int port = juce::jlimit (1024, 65535, oscPortEditor.getText().getIntValue());
+    oscPortEditor.setText (juce::String (port), juce::dontSendNotification);
+
+    if (! oscCheckbox.getToggleState())
+    {
+        osc.stop();
+    }
+    else if (! osc.start (port, ! oscNetworkCheckbox.getToggleState()))
+    {
+        // Port in use: leave the toggle off so the state shown is the real one.
+        oscCheckbox.setToggleState (false, juce::dontSendNotification);
+        oscStatsLabel.setText ("Could not open UDP port " + juce::String (port), juce::dontSendNotification);
+        return;
+    }
+
+    timerCallback();
+}
+
 //==============================================================================
 void MouseMidiSettingsWindow::paint (juce::Graphics& g)
 {
@@ -114,8 +301,6 @@ void MouseMidiSettingsWindow::resized()
         lbl.setBounds (row);
         area.removeFromTop (g);
     };
-    makeCheckRow (modulationCheckbox, modulationLabel);
-    makeCheckRow (expressionCheckbox, expressionLabel);
     makeCheckRow (retriggerCheckbox,  retriggerLabel);
 
     {
@@ -125,6 +310,64 @@ void MouseMidiSettingsWindow::resized()
         area.removeFromTop (g);
     }
 
+    curveEditor.setBounds (area.removeFromTop (110).withTrimmedLeft (120).reduced (2, 0));
+
+    // ── Jitter filter section ─────────────────────────────────────────────────
+    area.removeFromTop (8);
+    jitterSectionLabel.setBounds (area.removeFromTop (sh));
+    area.removeFromTop (4);
+    makeCheckRow (jitterCheckbox, jitterLabel);
+
+    {
+        auto row = area.removeFromTop (rh);
+        deadZoneLabel.setBounds  (row.removeFromLeft (170));
+        deadZoneSlider.setBounds (row.reduced (2, 0));
+        area.removeFromTop (g);
+    }
+
+    jitterStatsLabel.setBounds (area.removeFromTop (rh));
+
+    // ── Modulation matrix section ─────────────────────────────────────────────
+    area.removeFromTop (8);
+    modulationSectionLabel.setBounds (area.removeFromTop (sh));
+    area.removeFromTop (4);
+
+    for (auto& route : routeRows)
+    {
+        auto row = area.removeFromTop (rh);
+        route.source.setBounds      (row.removeFromLeft (104).reduced (1, 0));
+        route.sourceCC.setBounds    (row.removeFromLeft (34).reduced (1, 0));
+        row.removeFromLeft (6);
+        route.destination.setBounds (row.removeFromLeft (94).reduced (1, 0));
+        route.destCC.setBounds      (row.removeFromLeft (34).reduced (1, 0));
+        route.curve.setBounds       (row.removeFromRight (64).reduced (1, 0));
+        route.depth.setBounds       (row.reduced (2, 0));
+        area.removeFromTop (4);
+    }
+
+    {
+        auto row = area.removeFromTop (rh);
+        lfoRateLabel.setBounds  (row.removeFromLeft (120));
+        lfoRateSlider.setBounds (row.reduced (2, 0));
+        area.removeFromTop (g);
+    }
+
+    // ── OSC remote control section ────────────────────────────────────────────
+    area.removeFromTop (8);
+    oscSectionLabel.setBounds (area.removeFromTop (sh));
+    area.removeFromTop (4);
+    makeCheckRow (oscCheckbox,        oscLabel);
+    makeCheckRow (oscNetworkCheckbox, oscNetworkLabel);
+
+    {
+        auto row = area.removeFromTop (rh);
+        oscPortLabel.setBounds  (row.removeFromLeft (70));
+        oscPortEditor.setBounds (row.removeFromLeft (70).reduced (2, 0));
+        area.removeFromTop (g);
+    }
+
+    oscStatsLabel.setBounds (area.removeFromTop (rh));
+
     // ── Close button ──────────────────────────────────────────────────────────
     area.removeFromTop (12);
     closeButton.setBounds (area.removeFromTop (30).withSizeKeepingCentre (100, 28));
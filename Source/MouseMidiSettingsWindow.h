@@ -3,17 +3,23 @@
 #include <JuceHeader.h>
 #include "MouseMidiExpression.h"
 #include "PluginProcessor.h"
+#include "CurveEditorComponent.h"
 
 //==============================================================================
 /**
     Settings window for configuring mouse MIDI expression behaviour.
-    Allows the user to enable/disable CC1/CC11, select the response curve,
-    and toggle the retrigger-on-direction-change behaviour.
+    Allows the user to select and draw the response curve (for the velocity
+    and every pointer Y route), toggle the retrigger-on-direction-change
+    behaviour, and tune the pointer jitter filter (with live counters of the
+    events it rejected).  The modulation matrix routes, which send CC1/CC11
+    by default, are edited here, one row per route.  The OSC
+    remote control input is switched on and tested here as well.
 
     Chord voicing settings (octave, inversion, etc.) have moved to the
     Mapping settings window.
 */
-class MouseMidiSettingsWindow : public juce::Component
+class MouseMidiSettingsWindow : public juce::Component,
+                                private juce::Timer
 {
 public:
     //==============================================================================
@@ -34,22 +40,63 @@ private:
     juce::Label expressionSectionLabel;
 
     // ── Mouse Expression section ─────────────────────────────────────────────
-    juce::ToggleButton modulationCheckbox;
-    juce::Label        modulationLabel;
-
-    juce::ToggleButton expressionCheckbox;
-    juce::Label        expressionLabel;
-
     juce::ToggleButton retriggerCheckbox;
     juce::Label        retriggerLabel;
 
     juce::ComboBox curveSelector;
     juce::Label    curveLabel;
 
+    // Shows the selected curve; edits the Drawn one.
+    CurveEditorComponent curveEditor { audioProcessor.getCurveBank() };
+
+    // ── Jitter filter section ────────────────────────────────────────────────
+    juce::Label        jitterSectionLabel;
+    juce::ToggleButton jitterCheckbox;
+    juce::Label        jitterLabel;
+    juce::Slider       deadZoneSlider;
+    juce::Label        deadZoneLabel;
+    juce::Label        jitterStatsLabel;
+
+    // ── Modulation matrix section ────────────────────────────────────────────
+    // sourceCC applies to the Host CC source, destCC to the CC destination.
+    struct RouteRow
+    {
+        juce::ComboBox source;
+        juce::Label    sourceCC;
+        juce::ComboBox destination;
+        juce::Label    destCC;
+        juce::Slider   depth;
+        juce::ComboBox curve;
+    };
+
+    juce::Label  modulationSectionLabel;
+    RouteRow     routeRows[ModulationMatrix::kMaxRoutes];
+    juce::Slider lfoRateSlider;
+    juce::Label  lfoRateLabel;
+
+    // ── OSC remote control section ───────────────────────────────────────────
+    juce::Label        oscSectionLabel;
+    juce::ToggleButton oscCheckbox;
+    juce::Label        oscLabel;
+    juce::ToggleButton oscNetworkCheckbox;
+    juce::Label        oscNetworkLabel;
+    juce::Label        oscPortLabel;
+    juce::Label        oscPortEditor;
+    juce::Label        oscStatsLabel;
+
     juce::TextButton closeButton;
 
     //==============================================================================
     void setupUI();
 
+    // Refreshes the jitter filter and OSC counters.
+    void timerCallback() override;
+
+    // (Re)starts or stops the OSC receiver from the current controls.
+    void applyOscSettings();
+
+    // Sends the route rows and LFO rate to the processor.
+    void applyModulationSettings();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MouseMidiSettingsWindow)
 };
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    A set of MIDI notes, one bit per pitch.
+
+    A held cell's voicing is kept as one of these, so a voicing change is two
+    word-wise differences (the notes to stop and the notes to start; common
+    tones appear in neither), and octave doubling is a handful of shifted
+    ORs whatever the number of notes.  Duplicates cannot occur.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+struct NoteMask
+{
+    juce::uint64 bits[2] {};
+
+    void set (int note) noexcept                { bits[(note >> 6) & 1] |= juce::uint64 (1) << (note & 63); }
+    bool contains (int note) const noexcept     { return ((bits[(note >> 6) & 1] >> (note & 63)) & 1) != 0; }
+    bool isEmpty() const noexcept               { return (bits[0] | bits[1]) == 0; }
+    int  size() const noexcept                  { return juce::countNumberOfBits (bits[0]) + juce::countNumberOfBits (bits[1]); }
+
+    /** The notes of this mask that are not in other. */
+    NoteMask without (const NoteMask& other) const noexcept
+    {
+        NoteMask m;
+        m.bits[0] = bits[0] & ~other.bits[0];
+        m.bits[1] = bits[1] & ~other.bits[1];
+        return m;
+    }
+
+    /** Every note moved by semitones; notes pushed outside 0-127 are dropped. */
+    NoteMask shiftedBy (int semitones) const noexcept
+    {
+        NoteMask m;
+
+        if (semitones == 0)
+            return *this;
+
+        if (semitones >= 128 || semitones <= -128)
+            return m;
+
+        if (semitones >= 64)
+        {
+            m.bits[1] = bits[0] << (semitones - 64);
+        }
+        else if (semitones > 0)
+        {
+            m.bits[1] = (bits[1] << semitones) | (bits[0] >> (64 - semitones));
+            m.bits[0] = bits[0] << semitones;
+        }
+        else if (semitones <= -64)
+        {
+            m.bits[0] = bits[1] >> (-semitones - 64);
+        }
+        else
+        {
+            m.bits[0] = (bits[0] >> -semitones) | (bits[1] << (64 + semitones));
+            m.bits[1] = bits[1] >> -semitones;
+        }
+
+        return m;
+    }
+
+    NoteMask& operator|= (const NoteMask& o) noexcept  { bits[0] |= o.bits[0]; bits[1] |= o.bits[1]; return *this; }
+
+    bool operator== (const NoteMask& o) const noexcept { return bits[0] == o.bits[0] && bits[1] == o.bits[1]; }
+    bool operator!= (const NoteMask& o) const noexcept { return ! (*this == o); }
+
+    /** Calls fn (note) for every note, lowest first. */
+    template <typename Fn>
+    void forEach (Fn&& fn) const
+    {
+        for (int word = 0; word < 2; ++word)
+            for (auto b = bits[word]; b != 0; b &= b - 1)
+                fn (word * 64 + juce::countNumberOfBits ((b & (~b + 1)) - 1));
+    }
+};
@@ -0,0 +1,45 @@
+#include "OneEuroFilter.h"
+
+//==============================================================================
+void OneEuroFilter::setParameters(float minCutoffHz, float beta, float derivateCutoffHz)
+{
+    minCutoff = juce::jmax(0.01f, minCutoffHz);
+    betaCoeff = juce::jmax(0.0f, beta);
+    derivateCutoff = juce::jmax(0.01f, derivateCutoffHz);
+}
+
+float OneEuroFilter::smoothingFactor(float cutoffHz, float periodSeconds)
+{
+    // Exponential smoothing coefficient for a first-order low-pass:
+    //   tau = 1 / (2 pi fc),  alpha = 1 / (1 + tau / Te)
+    const float tau = 1.0f / (juce::MathConstants<float>::twoPi * cutoffHz);
+    return 1.0f / (1.0f + tau / periodSeconds);
+}
+
+float OneEuroFilter::process(float value, double timeMs)
+{
+    if (!initialised)
+    {
+        initialised = true;
+        lastRaw = value;
+        lastValue = value;
+        lastDerivative = 0.0f;
+        lastTimeMs = timeMs;
+        return value;
+    }
+
+    // Guard against identical or out-of-order timestamps.
+    const float period = (float)juce::jmax(0.001, (timeMs - lastTimeMs) / 1000.0);
+    lastTimeMs = timeMs;
+
+    // Smoothed speed estimate drives the adaptive cutoff.
+    const float rawDerivative = (value - lastRaw) / period;
+    const float derivativeAlpha = smoothingFactor(derivateCutoff, period);
+    lastDerivative += derivativeAlpha * (rawDerivative - lastDerivative);
+    lastRaw = value;
+
+    const float cutoff = minCutoff + betaCoeff * std::abs(lastDerivative);
+    const float alpha = smoothingFactor(cutoff, period);
+    lastValue += alpha * (value - lastValue);
+    return lastValue;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Adaptive low-pass filter for noisy pointer coordinates (the "1€ filter",
+    Casiez / Roussel / Vogel 2012).
+
+    At low speeds the cutoff stays near minCutoffHz, which removes hand tremor
+    and trackpad noise.  As the pointer speeds up the cutoff rises by
+    beta × |speed|, so fast bellows strokes pass through with almost no lag.
+
+    One instance filters one axis.  Timestamps are in milliseconds.
+*/
+class OneEuroFilter
+{
+public:
+    //==============================================================================
+    OneEuroFilter() = default;
+
+    /** Sets the filter parameters.
+        @param minCutoffHz      cutoff used while the pointer is (nearly) still
+        @param beta             cutoff increase per pixel/second of speed
+        @param derivateCutoffHz cutoff applied to the speed estimate itself
+    */
+    void setParameters(float minCutoffHz, float beta, float derivateCutoffHz = 1.0f);
+
+    /** Filters one sample.  The first sample after reset() passes through unchanged. */
+    float process(float value, double timeMs);
+
+    /** Forgets all history; the next sample initialises the filter. */
+    void reset() { initialised = false; }
+
+    /** Returns the last filtered value. */
+    float getLastValue() const { return lastValue; }
+
+    /** Returns the last speed estimate in units per second. */
+    float getLastSpeed() const { return lastDerivative; }
+
+private:
+    //==============================================================================
+    static float smoothingFactor(float cutoffHz, float periodSeconds);
+
+    float minCutoff = 1.5f;
+    float betaCoeff = 0.01f;
+    float derivateCutoff = 1.0f;
+
+    bool   initialised = false;
+    float  lastRaw = 0.0f;
+    float  lastValue = 0.0f;
+    float  lastDerivative = 0.0f;
+    double lastTimeMs = 0.0;
+};
@@ -0,0 +1,317 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    OSC remote control implementation.
+
+  ==============================================================================
+*/
+
+#include "OscControlReceiver.h"
+#include "PluginProcessor.h"
+
+//==============================================================================
+namespace
+{
+    // Reads argument i as an integer, accepting int32 or float32.
+    static bool getIntArg (const juce::OSCMessage& m, int i, int& out)
+    {
+        if (i >= m.size())
+            return false;
+
+        const auto& a = m[i];
+        if (a.isInt32())   { out = a.getInt32();                    return true; }
+        if (a.isFloat32()) { out = juce::roundToInt (a.getFloat32()); return true; }
+        return false;
+    }
+
+    static int getIntArgOr (const juce::OSCMessage& m, int i, int fallback)
+    {
+        int v = fallback;
+        return getIntArg (m, i, v) ? v : fallback;
+    }
+
+    // Reads a high-resolution tick count sent as two int32s (high word first).
+    static bool getTicksArg (const juce::OSCMessage& m, int i, juce::int64& out)
+    {
+        if (i + 1 >= m.size() || ! m[i].isInt32() || ! m[i + 1].isInt32())
+            return false;
+
+        out = (juce::int64) (((juce::uint64) (juce::uint32) m[i].getInt32() << 32)
+                             | (juce::uint32) m[i + 1].getInt32());
+        return true;
+    }
+}
+
+//==============================================================================
+OscControlReceiver::OscControlReceiver (StraDellaMIDI_pluginAudioProcessor& processor)
+    : audioProcessor (processor)
+{
+    receiver.addListener (this);
+}
+
+OscControlReceiver::~OscControlReceiver()
+{
+    stop();
+    receiver.removeListener (this);
+}
+
+bool OscControlReceiver::start (int newPort, bool newLocalhostOnly)
+{
+    stop();
+
+    auto s = std::make_unique<juce::DatagramSocket> (false);
+    if (! s->bindToPort (newPort, newLocalhostOnly ? juce::String ("127.0.0.1") : juce::String()))
+        return false;
+
+    socket        = std::move (s);
+    port          = newPort;
+    localhostOnly = newLocalhostOnly;
+
+    if (! receiver.connectToSocket (*socket))
+    {
+        socket.reset();
+        return false;
+    }
+
+    return true;
+}
+
+void OscControlReceiver::stop()
+{
+    if (socket == nullptr)
+        return;
+
+    // Stops and joins the receive thread before the socket goes away.
+    receiver.disconnect();
+    socket.reset();
+}
+
+//==============================================================================
+void OscControlReceiver::oscMessageReceived (const juce::OSCMessage& message)
+{
+    const auto now = juce::Time::getHighResolutionTicks();
+
+    if (handleMessage (message, now))
+        numReceived.fetch_add (1, std::memory_order_relaxed);
+    else
+        numRejected.fetch_add (1, std::memory_order_relaxed);
+}
+
+void OscControlReceiver::oscBundleReceived (const juce::OSCBundle& bundle)
+{
+    for (const auto& element : bundle)
+    {
+        if (element.isMessage())
+            oscMessageReceived (element.getMessage());
+        else if (element.isBundle())
+            oscBundleReceived (element.getBundle());
+    }
+}
+
+// Receive thread.  Returns false for anything that is not a well-formed
+// message in the address space documented in the header.
+bool OscControlReceiver::handleMessage (const juce::OSCMessage& message, juce::int64 receiveTicks)
+{
+    using Processor = StraDellaMIDI_pluginAudioProcessor;
+
+    const auto address = message.getAddressPattern().toString();
+    int row = 0, col = 0;
+
+    auto isCell = [&]
+    {
+        return getIntArg (message, 0, row) && getIntArg (message, 1, col)
+            && juce::isPositiveAndBelow (row, Processor::NUM_ROWS)
+            && juce::isPositiveAndBelow (col, Processor::NUM_COLUMNS);
+    };
+
+    if (address == "/stradella/press" || address == "/stradella/release")
+    {
+        if (! isCell())
+            return false;
+
+        CellIntent intent;
+        intent.ticks   = receiveTicks;
+        intent.row     = (juce::int8) row;
+        intent.col     = (juce::int8) col;
+        intent.isPress = address == "/stradella/press";
+
+        if (intent.isPress)
+        {
+            intent.velocity       = (juce::uint8) juce::jlimit (1, 127, getIntArgOr (message, 2, 100));
+            intent.leftMouseDown  = getIntArgOr (message, 3, 0) != 0;
+            intent.rightMouseDown = getIntArgOr (message, 4, 0) != 0;
+        }
+
+        audioProcessor.applyCellIntents (&intent, 1);
+
+        juce::int64 sent = 0;
+        if (getTicksArg (message, intent.isPress ? 5 : 2, sent))
+            recordStamped (sent, receiveTicks);
+
+        return true;
+    }
+
+    if (address == "/stradella/bellows")
+    {
+        if (message.isEmpty())
+            return false;
+
+        const auto& a = message[0];
+        int value = 0;
+        if (a.isFloat32())    value = juce::roundToInt (juce::jlimit (0.0f, 1.0f, a.getFloat32()) * 127.0f);
+        else if (a.isInt32()) value = juce::jlimit (0, 127, a.getInt32());
+        else                  return false;
+
+        // Same controllers the mouse bellows drives.
+        audioProcessor.addMidiMessage (juce::MidiMessage::controllerEvent (1, 11, value));
+        audioProcessor.addMidiMessage (juce::MidiMessage::controllerEvent (1, 1,  value));
+        return true;
+    }
+
+    if (address == "/stradella/voicing/octave" || address == "/stradella/voicing/inversion")
+    {
+        int value = 0;
+        if (! getIntArg (message, 0, row) || ! getIntArg (message, 1, value)
+             || ! juce::isPositiveAndBelow (row, Processor::NUM_ROWS))
+            return false;
+
+        const bool isOctave = address == "/stradella/voicing/octave";
+        if (! isOctave && row != Processor::MAJOR && row != Processor::MINOR)
+            return false;
+
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s)
+        {
+            if (isOctave)                     s.octaveOffset[row] = juce::jlimit (-2, 2, value);
+            else if (row == Processor::MAJOR) s.majorInversion   = juce::jlimit (0, 2, value);
+            else                              s.minorInversion   = juce::jlimit (0, 2, value);
+        });
+        return true;
+    }
+
+    if (address == "/stradella/voicing/autoinversion")
+    {
+        int on = 0;
+        if (! getIntArg (message, 0, on))
+            return false;
+
+        audioProcessor.updateVoicingSettings ([&] (VoicingSettings& s) { s.autoInversion = on != 0; });
+        return true;
+    }
+
+    if (address == "/stradella/register")
+    {
+        int index = 0;
+        if (! getIntArg (message, 0, index) || ! juce::isPositiveAndBelow (index, BassRegisters::kNumRegisters))
+            return false;
+
+        audioProcessor.setBassRegister (index);
+        return true;
+    }
+
+    if (address == "/stradella/register/octaves")
+    {
+        int index = 0, mask = 0, mix = 0;
+        if (! getIntArg (message, 0, index) || ! getIntArg (message, 1, row) || ! getIntArg (message, 2, mask)
+             || ! juce::isPositiveAndBelow (index, BassRegisters::kNumRegisters)
+             || ! juce::isPositiveAndBelow (row, Processor::NUM_ROWS))
+            return false;
+
+        auto r = audioProcessor.getBassRegisterOctaves (index);
+        r.octaves[row] = (juce::uint8) mask;
+        if (getIntArg (message, 3, mix))
+            r.mixBassRows = mix != 0;
+
+        audioProcessor.setBassRegisterOctaves (index, r);
+        return true;
+    }
+
+    if (address == "/stradella/stats")
+    {
+        int replyPort = 0;
+        if (! getIntArg (message, 0, replyPort) || ! juce::isPositiveAndBelow (replyPort, 65536))
+            return false;
+
+        const auto host = message.size() > 1 && message[1].isString() ? message[1].getString()
+                                                                       : juce::String ("127.0.0.1");
+        return sendStatsReply (host, replyPort);
+    }
+
+    if (address == "/stradella/stats/reset")
+    {
+        resetStampedStats();
+        return true;
+    }
+
+    return false;
+}
+
+// Receive thread: the only writer of the stamped counters.
+void OscControlReceiver::recordStamped (juce::int64 sentTicks, juce::int64 receiveTicks) noexcept
+{
+    const auto queued = juce::Time::getHighResolutionTicks();
+    const auto wire   = juce::jmax ((juce::int64) 0, receiveTicks - sentTicks);
+    const auto queue  = juce::jmax ((juce::int64) 0, queued - receiveTicks);
+
+    if (numStamped.fetch_add (1, std::memory_order_relaxed) == 0)
+        firstStampTicks.store (receiveTicks, std::memory_order_relaxed);
+
+    lastStampTicks.store (receiveTicks, std::memory_order_relaxed);
+    wireLatencySum.fetch_add  (wire,  std::memory_order_relaxed);
+    queueLatencySum.fetch_add (queue, std::memory_order_relaxed);
+
+    if (wire > wireLatencyMax.load (std::memory_order_relaxed))
+        wireLatencyMax.store (wire, std::memory_order_relaxed);
+    if (queue > queueLatencyMax.load (std::memory_order_relaxed))
+        queueLatencyMax.store (queue, std::memory_order_relaxed);
+}
+
+bool OscControlReceiver::sendStatsReply (const juce::String& host, int replyPort)
+{
+    juce::OSCSender sender;
+    if (! sender.connect (host, replyPort))
+        return false;
+
+    const auto s = getStats();
+    return sender.send ("/stradella/stats/reply",
+                        (juce::int32) s.received, (juce::int32) s.rejected, (juce::int32) s.stamped,
+                        (float) s.meanWireUs,  (float) s.maxWireUs,
+                        (float) s.meanQueueUs, (float) s.maxQueueUs,
+                        (float) s.ratePerS);
+}
+
+//==============================================================================
+OscControlReceiver::Stats OscControlReceiver::getStats() const noexcept
+{
+    const double ticksPerUs = (double) juce::Time::getHighResolutionTicksPerSecond() / 1.0e6;
+
+    Stats s;
+    s.received = numReceived.load (std::memory_order_relaxed);
+    s.rejected = numRejected.load (std::memory_order_relaxed);
+    s.stamped  = numStamped.load  (std::memory_order_relaxed);
+
+    if (s.stamped > 0)
+    {
+        s.meanWireUs  = (double) wireLatencySum.load  (std::memory_order_relaxed) / (double) s.stamped / ticksPerUs;
+        s.maxWireUs   = (double) wireLatencyMax.load  (std::memory_order_relaxed) / ticksPerUs;
+        s.meanQueueUs = (double) queueLatencySum.load (std::memory_order_relaxed) / (double) s.stamped / ticksPerUs;
+        s.maxQueueUs  = (double) queueLatencyMax.load (std::memory_order_relaxed) / ticksPerUs;
+
+        const auto span = lastStampTicks.load (std::memory_order_relaxed) - firstStampTicks.load (std::memory_order_relaxed);
+        if (span > 0 && s.stamped > 1)
+            s.ratePerS = (double) (s.stamped - 1) * 1.0e6 / ((double) span / ticksPerUs);
+    }
+
+    return s;
+}
+
+void OscControlReceiver::resetStampedStats() noexcept
+{
+    numStamped.store      (0, std::memory_order_relaxed);
+    wireLatencySum.store  (0, std::memory_order_relaxed);
+    wireLatencyMax.store  (0, std::memory_order_relaxed);
+    queueLatencySum.store (0, std::memory_order_relaxed);
+    queueLatencyMax.store (0, std::memory_order_relaxed);
+    firstStampTicks.store (0, std::memory_order_relaxed);
+    lastStampTicks.store  (0, std::memory_order_relaxed);
+}
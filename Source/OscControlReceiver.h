@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    OSC-over-UDP remote control input.
+
+    Lets a touch-surface app on the same machine play the grid without going
+    through a virtual MIDI port and the host.  Messages are decoded on the
+    OSCReceiver's own network thread and pushed straight into the processor
+    (applyCellIntents / addMidiMessage), stamped with their receive time.
+
+    Address space (int or float arguments are both accepted):
+
+      /stradella/press    row col [velocity] [left] [right] [sentHigh sentLow]
+      /stradella/release  row col [sentHigh sentLow]
+      /stradella/bellows  pressure          (0.0-1.0 float, or 0-127 int)
+      /stradella/voicing/octave         row offset      (-2..+2)
+      /stradella/voicing/inversion      row inversion   (major/minor rows)
+      /stradella/voicing/autoinversion  on
+      /stradella/register               index           (bass register switch)
+      /stradella/register/octaves       index row mask [mix]   (bit n = octave n - 2)
+      /stradella/stats    replyPort [replyHost]   (answers /stradella/stats/reply)
+      /stradella/stats/reset
+
+    sentHigh/sentLow are the sender's Time::getHighResolutionTicks() split
+    into two int32s; stamped press/release messages are timed send → receive
+    and receive → queued.  Benchmarks/OscSender drives this from outside the
+    plugin and reads the counters back with /stradella/stats.
+
+    The socket binds to 127.0.0.1 unless network access is explicitly allowed.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class StraDellaMIDI_pluginAudioProcessor;
+
+//==============================================================================
+class OscControlReceiver : private juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>
+{
+public:
+    //==============================================================================
+    static constexpr int kDefaultPort = 9100;
+
+    explicit OscControlReceiver (StraDellaMIDI_pluginAudioProcessor& processor);
+    ~OscControlReceiver() override;
+
+    /** Binds the port and starts the receive thread.  Returns false if the
+        port could not be bound.  Message thread. */
+    bool start (int port, bool localhostOnly = true);
+    void stop();
+
+    bool isRunning()       const noexcept { return socket != nullptr; }
+    int  getPort()         const noexcept { return port; }
+    bool isLocalhostOnly() const noexcept { return localhostOnly; }
+
+    //==============================================================================
+    /** Counters, written by the receive thread and readable from any thread. */
+    struct Stats
+    {
+        juce::int64 received      = 0;   ///< messages decoded into an action
+        juce::int64 rejected      = 0;   ///< unknown address or bad arguments
+        juce::int64 stamped       = 0;   ///< press/release carrying a send time
+        double      meanWireUs    = 0.0; ///< send → receive
+        double      maxWireUs     = 0.0;
+        double      meanQueueUs   = 0.0; ///< receive → queued in the processor
+        double      maxQueueUs    = 0.0;
+        double      ratePerS      = 0.0; ///< stamped messages per second since the reset
+    };
+
+    Stats getStats() const noexcept;
+    void  resetStampedStats() noexcept;
+
+private:
+    //==============================================================================
+    void oscMessageReceived (const juce::OSCMessage& message) override;
+    void oscBundleReceived  (const juce::OSCBundle& bundle) override;
+
+    bool handleMessage (const juce::OSCMessage& message, juce::int64 receiveTicks);
+    void recordStamped (juce::int64 sentTicks, juce::int64 receiveTicks) noexcept;
+    bool sendStatsReply (const juce::String& host, int replyPort);
+
+    StraDellaMIDI_pluginAudioProcessor& audioProcessor;
+
+    juce::OSCReceiver                     receiver { "StraDella OSC" };
+    std::unique_ptr<juce::DatagramSocket> socket;
+    int  port          = kDefaultPort;
+    bool localhostOnly = true;
+
+    std::atomic<juce::int64> numReceived      { 0 };
+    std::atomic<juce::int64> numRejected      { 0 };
+    std::atomic<juce::int64> numStamped       { 0 };
+    std::atomic<juce::int64> wireLatencySum   { 0 };   // ticks
+    std::atomic<juce::int64> wireLatencyMax   { 0 };   // ticks
+    std::atomic<juce::int64> queueLatencySum  { 0 };   // ticks
+    std::atomic<juce::int64> queueLatencyMax  { 0 };   // ticks
+    std::atomic<juce::int64> firstStampTicks  { 0 };
+    std::atomic<juce::int64> lastStampTicks   { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OscControlReceiver)
+};
@@ -0,0 +1,277 @@
+#include "OutputSettingsWindow.h"
+
+//==============================================================================
+OutputSettingsWindow::OutputSettingsWindow (StraDellaMIDI_pluginAudioProcessor& processor)
+    : audioProcessor (processor),
+      hasDirectOutput (DirectMidiOutput::isAvailable())
+{
+    setupUI();
+    setSize (440, hasDirectOutput ? 416 : 332);
+    startTimerHz (10);
+}
+
+OutputSettingsWindow::~OutputSettingsWindow()
+{
+    stopTimer();
+}
+
+//==============================================================================
+void OutputSettingsWindow::setupUI()
+{
+    using Proc = StraDellaMIDI_pluginAudioProcessor;
+
+    // ── Title ─────────────────────────────────────────────────────────────────
+    titleLabel.setText ("Output Settings", juce::dontSendNotification);
+    titleLabel.setFont (juce::Font (juce::FontOptions (17.0f, juce::Font::bold)));
+    titleLabel.setJustificationType (juce::Justification::centred);
+    addAndMakeVisible (titleLabel);
+
+    // ── Section headers ───────────────────────────────────────────────────────
+    auto makeSectionHeader = [this](juce::Label& lbl, const juce::String& text)
+    {
+        lbl.setText (text, juce::dontSendNotification);
+        lbl.setFont (juce::Font (juce::FontOptions (12.0f, juce::Font::bold)));
+        lbl.setColour (juce::Label::textColourId, juce::Colours::lightgrey);
+        addAndMakeVisible (lbl);
+    };
+    makeSectionHeader (polyphonySectionLabel, "Polyphony");
+    makeSectionHeader (hostInputSectionLabel, "Host MIDI Input");
+    makeSectionHeader (queueSectionLabel,     "UI Event Queue");
+
+    auto makeLabel = [this](juce::Label& lbl, const juce::String& text)
+    {
+        lbl.setText (text, juce::dontSendNotification);
+        addAndMakeVisible (lbl);
+    };
+
+    // ── Polyphony ─────────────────────────────────────────────────────────────
+    // Max-voices IDs are the voice count; "Unlimited" is stored as 0.
+    const auto ls = audioProcessor.getVoiceLimiterSettings();
+
+    makeLabel (maxVoicesLabel, "Max voices:");
+    maxVoicesBox.addItem ("Unlimited", VoiceLimiter::kMaxVoices + 1);
+    for (int voices : { 4, 6, 8, 10, 12, 16, 24, 32 })
+        maxVoicesBox.addItem (juce::String (voices), voices);
+    maxVoicesBox.setSelectedId (ls.maxVoices > 0 ? ls.maxVoices : VoiceLimiter::kMaxVoices + 1,
+                                juce::dontSendNotification);
+    maxVoicesBox.onChange = [this]
+    {
+        auto s = audioProcessor.getVoiceLimiterSettings();
+        const int id = maxVoicesBox.getSelectedId();
+        s.maxVoices = id > VoiceLimiter::kMaxVoices ? 0 : id;
+        audioProcessor.setVoiceLimiterSettings (s);
+    };
+    addAndMakeVisible (maxVoicesBox);
+
+    // Policy IDs are VoiceLimiter::StealPolicy values + 1.
+    makeLabel (stealPolicyLabel, "When full, steal:");
+    for (int p = 0; p < (int) VoiceLimiter::StealPolicy::numPolicies; ++p)
+        stealPolicyBox.addItem (VoiceLimiter::getPolicyName ((VoiceLimiter::StealPolicy) p), p + 1);
+    stealPolicyBox.setSelectedId ((int) ls.policy + 1, juce::dontSendNotification);
+    stealPolicyBox.onChange = [this]
+    {
+        auto s = audioProcessor.getVoiceLimiterSettings();
+        s.policy = (VoiceLimiter::StealPolicy) (stealPolicyBox.getSelectedId() - 1);
+        audioProcessor.setVoiceLimiterSettings (s);
+    };
+    addAndMakeVisible (stealPolicyBox);
+
+    // ── Host MIDI input ───────────────────────────────────────────────────────
+    // Thru IDs are ThruMode values + 1.
+    using ThruMode = Proc::ThruMode;
+    makeLabel (thruLabel, "Host MIDI in:");
+    thruBox.addItem ("Pass through",       (int) ThruMode::pass        + 1);
+    thruBox.addItem ("Filter notes",       (int) ThruMode::filterNotes + 1);
+    thruBox.addItem ("Filter everything",  (int) ThruMode::filterAll   + 1);
+    thruBox.setSelectedId ((int) audioProcessor.getThruMode() + 1, juce::dontSendNotification);
+    thruBox.onChange = [this]
+    {
+        audioProcessor.setThruMode ((StraDellaMIDI_pluginAudioProcessor::ThruMode) (thruBox.getSelectedId() - 1));
+    };
+    addAndMakeVisible (thruBox);
+
+    // Chord input IDs are ChordInputMode values + 1.
+    using ChordInputMode = Proc::ChordInputMode;
+    makeLabel (chordInLabel, "Chords in:");
+    chordModeBox.addItem ("Off",                (int) ChordInputMode::off     + 1);
+    chordModeBox.addItem ("Light up cells",     (int) ChordInputMode::display + 1);
+    chordModeBox.addItem ("Re-voice as cells",  (int) ChordInputMode::revoice + 1);
+    chordModeBox.setSelectedId ((int) audioProcessor.getChordInputMode() + 1, juce::dontSendNotification);
+    chordModeBox.setTooltip ("Recognize chords played on the host MIDI input and show them on the grid, "
+                             "or replace them with the matching bass and chord cells.");
+    chordModeBox.onChange = [this]
+    {
+        audioProcessor.setChordInputMode ((StraDellaMIDI_pluginAudioProcessor::ChordInputMode) (chordModeBox.getSelectedId() - 1));
+    };
+    addAndMakeVisible (chordModeBox);
+
+    chordNameLabel.setColour (juce::Label::textColourId, juce::Colours::lightgrey);
+    addAndMakeVisible (chordNameLabel);
+
+    // ── UI event queue ────────────────────────────────────────────────────────
+    // Expiry IDs are indices into kMaxAgeChoices + 1.
+    static constexpr int kMaxAgeChoices[] = { 100, 250, 500, 1000, 2000, 0 };
+    makeLabel (maxAgeLabel, "Expire events:");
+    for (int i = 0; i < (int) std::size (kMaxAgeChoices); ++i)
+        maxAgeBox.addItem (kMaxAgeChoices[i] > 0 ? "After " + juce::String (kMaxAgeChoices[i]) + " ms"
+                                                 : juce::String ("Never"), i + 1);
+    const int maxAge = audioProcessor.getPendingMaxAgeMs();
+    for (int i = 0; i < (int) std::size (kMaxAgeChoices); ++i)
+        if (kMaxAgeChoices[i] == maxAge)
+            maxAgeBox.setSelectedId (i + 1, juce::dontSendNotification);
+    maxAgeBox.setTooltip ("Queued UI events older than this are discarded when the host resumes "
+                          "processing.  Note-offs are always delivered.");
+    maxAgeBox.onChange = [this]
+    {
+        audioProcessor.setPendingMaxAgeMs (kMaxAgeChoices[maxAgeBox.getSelectedId() - 1]);
+    };
+    addAndMakeVisible (maxAgeBox);
+
+    // ── Direct output (standalone) ────────────────────────────────────────────
+    // Device IDs: 1 = through host, 2 + i = directDevices[i].
+    // Mode IDs are DirectMidiOutput::Mode values + 1.
+    if (hasDirectOutput)
+    {
+        auto& direct = audioProcessor.getDirectOutput();
+
+        makeSectionHeader (directSectionLabel, "Direct Output");
+        makeLabel (directDeviceLabel, "Device:");
+
+        directDevices = juce::MidiOutput::getAvailableDevices();
+        directDeviceBox.addItem ("Off (through host)", 1);
+        int selected = 1;
+        for (int i = 0; i < directDevices.size(); ++i)
+        {
+            directDeviceBox.addItem (directDevices[i].name, i + 2);
+            if (directDevices[i].identifier == direct.getDeviceIdentifier())
+                selected = i + 2;
+        }
+        directDeviceBox.setSelectedId (selected, juce::dontSendNotification);
+        directDeviceBox.onChange = [this] { applyDirectOutput(); };
+        addAndMakeVisible (directDeviceBox);
+
+        using Mode = DirectMidiOutput::Mode;
+        makeLabel (directModeLabel, "Send from:");
+        directModeBox.addItem ("Calling thread (immediate)", (int) Mode::immediate    + 1);
+        directModeBox.addItem ("Sender thread",              (int) Mode::senderThread + 1);
+        directModeBox.setSelectedId (direct.getMode() == Mode::senderThread ? (int) Mode::senderThread + 1
+                                                                            : (int) Mode::immediate + 1,
+                                     juce::dontSendNotification);
+        directModeBox.onChange = [this] { applyDirectOutput(); };
+        addAndMakeVisible (directModeBox);
+    }
+
+    // ── Close button ──────────────────────────────────────────────────────────
+    closeButton.setButtonText ("Close");
+    closeButton.onClick = [this]
+    {
+        if (auto* dw = findParentComponentOfClass<juce::DialogWindow>())
+            dw->closeButtonPressed();
+        else
+            setVisible (false);
+    };
+    addAndMakeVisible (closeButton);
+
+    timerCallback();
+}
+
+void OutputSettingsWindow::applyDirectOutput()
+{
+    const int id = directDeviceBox.getSelectedId();
+
+    if (id < 2)
+    {
+        audioProcessor.setDirectOutputMode (DirectMidiOutput::Mode::off);
+        audioProcessor.setDirectOutputDevice ({});
+        return;
+    }
+
+    if (! audioProcessor.setDirectOutputDevice (directDevices[id - 2].identifier))
+    {
+        directDeviceBox.setSelectedId (1, juce::dontSendNotification);
+        return;
+    }
+
+    audioProcessor.setDirectOutputMode ((DirectMidiOutput::Mode) (directModeBox.getSelectedId() - 1));
+    audioProcessor.getDirectOutput().resetLatencyStats();
+}
+
+void OutputSettingsWindow::timerCallback()
+{
+    chordNameLabel.setText (chordModeBox.getSelectedId() > 1 ? ChordRecognizer::getName (audioProcessor.getRecognizedChord())
+                                                             : juce::String(),
+                            juce::dontSendNotification);
+}
+
+//==============================================================================
+void OutputSettingsWindow::paint (juce::Graphics& g)
+{
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+    g.setColour (juce::Colours::grey);
+    g.drawRect (getLocalBounds(), 2);
+}
+
+void OutputSettingsWindow::resized()
+{
+    const int m  = 15;   // outer margin
+    const int rh = 22;   // standard row height
+    const int sh = 16;   // section header height
+    const int g  =  6;   // gap between rows
+
+    auto area = getLocalBounds().reduced (m);
+
+    // ── Title ─────────────────────────────────────────────────────────────────
+    titleLabel.setBounds (area.removeFromTop (28));
+    area.removeFromTop (8);
+
+    auto makeSection = [&](juce::Label& header)
+    {
+        header.setBounds (area.removeFromTop (sh));
+        area.removeFromTop (4);
+    };
+
+    auto makeRow = [&](juce::Label& lbl, juce::Component& box)
+    {
+        auto row = area.removeFromTop (rh);
+        lbl.setBounds (row.removeFromLeft (130));
+        box.setBounds (row.reduced (2, 0));
+        area.removeFromTop (g);
+    };
+
+    // ── Polyphony ─────────────────────────────────────────────────────────────
+    makeSection (polyphonySectionLabel);
+    makeRow (maxVoicesLabel,   maxVoicesBox);
+    makeRow (stealPolicyLabel, stealPolicyBox);
+    area.removeFromTop (8);
+
+    // ── Host MIDI input ───────────────────────────────────────────────────────
+    makeSection (hostInputSectionLabel);
+    makeRow (thruLabel, thruBox);
+    {
+        auto row = area.removeFromTop (rh);
+        chordInLabel.setBounds   (row.removeFromLeft (130));
+        chordModeBox.setBounds   (row.removeFromLeft (170).reduced (2, 0));
+        row.removeFromLeft (10);
+        chordNameLabel.setBounds (row);
+        area.removeFromTop (g);
+    }
+    area.removeFromTop (8);
+
+    // ── UI event queue ────────────────────────────────────────────────────────
+    makeSection (queueSectionLabel);
+    makeRow (maxAgeLabel, maxAgeBox);
+    area.removeFromTop (8);
+
+    // ── Direct output ─────────────────────────────────────────────────────────
+    if (hasDirectOutput)
+    {
+        makeSection (directSectionLabel);
+        makeRow (directDeviceLabel, directDeviceBox);
+        makeRow (directModeLabel,   directModeBox);
+        area.removeFromTop (8);
+    }
+
+    // ── Close button ──────────────────────────────────────────────────────────
+    area.removeFromTop (4);
+    closeButton.setBounds (area.removeFromTop (30).withSizeKeepingCentre (100, 28));
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    Settings window for the output stage: the polyphony cap and its voice
+    stealing policy, what happens to the host's MIDI input (thru filter and
+    chord recognition, with the chord currently recognized), how long queued
+    UI events may wait for the host, and, in the standalone app, the direct
+    device output that bypasses the host.  The live counters for these are
+    shown in the MIDI monitor.
+*/
+class OutputSettingsWindow : public juce::Component,
+                             private juce::Timer
+{
+public:
+    //==============================================================================
+    explicit OutputSettingsWindow (StraDellaMIDI_pluginAudioProcessor& processor);
+    ~OutputSettingsWindow() override;
+
+    void paint  (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    //==============================================================================
+    // Timer: refreshes the recognized chord name.
+    void timerCallback() override;
+
+    void applyDirectOutput();
+
+    //==============================================================================
+    StraDellaMIDI_pluginAudioProcessor& audioProcessor;
+
+    // ── Section headers ───────────────────────────────────────────────────────
+    juce::Label titleLabel;
+    juce::Label polyphonySectionLabel;
+    juce::Label hostInputSectionLabel;
+    juce::Label queueSectionLabel;
+    juce::Label directSectionLabel;
+
+    // ── Polyphony ─────────────────────────────────────────────────────────────
+    juce::ComboBox maxVoicesBox;
+    juce::Label    maxVoicesLabel;
+    juce::ComboBox stealPolicyBox;
+    juce::Label    stealPolicyLabel;
+
+    // ── Host MIDI input ───────────────────────────────────────────────────────
+    juce::ComboBox thruBox;
+    juce::Label    thruLabel;
+    juce::ComboBox chordModeBox;
+    juce::Label    chordInLabel;
+    juce::Label    chordNameLabel;
+
+    // ── UI event queue ────────────────────────────────────────────────────────
+    juce::ComboBox maxAgeBox;
+    juce::Label    maxAgeLabel;
+
+    // ── Direct output (standalone only) ───────────────────────────────────────
+    const bool     hasDirectOutput;
+    juce::ComboBox directDeviceBox;
+    juce::Label    directDeviceLabel;
+    juce::ComboBox directModeBox;
+    juce::Label    directModeLabel;
+    juce::Array<juce::MidiDeviceInfo> directDevices;
+
+    juce::TextButton closeButton;
+
+    //==============================================================================
+    void setupUI();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutputSettingsWindow)
+};
@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Paint benchmark implementation.
+
+  ==============================================================================
+*/
+
+#include "PaintBenchmark.h"
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+#include "FocusCaptureOverlay.h"
+
+//==============================================================================
+#if STRADELLA_COUNT_ALLOCATIONS
+namespace
+{
+    thread_local juce::int64 threadAllocations = 0;
+}
+
+// Counting replacements of the global allocation functions.  The nothrow and
+// aligned variants are left to the library.
+void* operator new (std::size_t size)
+{
+    ++threadAllocations;
+
+    if (auto* p = std::malloc (size == 0 ? 1 : size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size)                  { return operator new (size); }
+void  operator delete   (void* p) noexcept               { std::free (p); }
+void  operator delete[] (void* p) noexcept               { std::free (p); }
+void  operator delete   (void* p, std::size_t) noexcept  { std::free (p); }
+void  operator delete[] (void* p, std::size_t) noexcept  { std::free (p); }
+
+juce::int64 PaintBenchmark::getThreadAllocationCount() noexcept   { return threadAllocations; }
+#else
+juce::int64 PaintBenchmark::getThreadAllocationCount() noexcept   { return -1; }
+#endif
+
+//==============================================================================
+namespace
+{
+    using Proc = StraDellaMIDI_pluginAudioProcessor;
+
+    constexpr int kDisplayWidth  = 3840;   // Focus mode display, physical pixels
+    constexpr int kDisplayHeight = 2160;
+
+    // numPressed distinct cells spread over the grid (7 and 48 are coprime).
+    juce::uint64 pressedCells (int numPressed) noexcept
+    {
+        juce::uint64 cells = 0;
+        for (int i = 0; i < numPressed; ++i)
+            cells |= juce::uint64 (1) << ((i * 7) % (Proc::NUM_ROWS * Proc::NUM_COLUMNS));
+        return cells;
+    }
+
+    double ticksToMs (juce::int64 ticks) noexcept
+    {
+        return juce::Time::highResolutionTicksToSeconds (ticks) * 1000.0;
+    }
+
+    juce::Image makeTarget (juce::Rectangle<int> bounds, float scale)
+    {
+        return juce::Image (juce::Image::RGB,
+                            juce::jmax (1, juce::roundToInt ((float) bounds.getWidth()  * scale)),
+                            juce::jmax (1, juce::roundToInt ((float) bounds.getHeight() * scale)),
+                            true);
+    }
+
+    // One full repaint of `component` into `target`, as a window at `scale`.
+    void paintInto (juce::Image& target, juce::Component& component, float scale)
+    {
+        juce::Graphics g (target);
+        g.addTransform (juce::AffineTransform::scale (scale));
+        component.paintEntireComponent (g, true);
+    }
+}
+
+//==============================================================================
+PaintBenchmark::Result PaintBenchmark::run (int framesPerCase)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    Result result;
+    const auto wallStart = juce::Time::getHighResolutionTicks();
+    framesPerCase = juce::jmax (2, framesPerCase);
+
+    // Private processor.  Cells are pressed through it, as the UI would, and
+    // every case gets a fresh editor, which draws the processor's held cells
+    // from its first paint.  The overlay is never put on the desktop.
+    constexpr double kSampleRate = 48000.0;
+    constexpr int    kBlockSize  = 512;
+
+    auto processor = std::make_unique<Proc>();
+    processor->setRateAndBufferSizeDetails (kSampleRate, kBlockSize);
+    processor->prepareToPlay (kSampleRate, kBlockSize);
+
+    juce::AudioBuffer<float> audio (0, kBlockSize);
+    juce::MidiBuffer         midi;
+
+    const float scales[]  = { 1.0f, 1.25f, 1.5f, 2.0f };
+    const int   pressed[] = { 0, 4, 16, Proc::NUM_ROWS * Proc::NUM_COLUMNS };
+
+    for (const bool focus : { false, true })
+    {
+        for (const float scale : scales)
+        {
+            for (const int numPressed : pressed)
+            {
+                // One block picks up the notes, so the queue never fills.
+                processor->sendAllNotesOff();
+
+                const auto cells = pressedCells (numPressed);
+                for (int bit = 0; bit < Proc::NUM_ROWS * Proc::NUM_COLUMNS; ++bit)
+                    if ((cells >> bit) & 1)
+                        processor->buttonPressed (bit / Proc::NUM_COLUMNS, bit % Proc::NUM_COLUMNS);
+
+                midi.clear();
+                processor->processBlock (audio, midi);
+
+                StraDellaMIDI_pluginAudioProcessorEditor editor (*processor);
+                FocusCaptureOverlay                      overlay (editor);
+
+                // Focus mode: the overlay covers the display in logical pixels.
+                overlay.setBounds (0, 0, juce::roundToInt ((float) kDisplayWidth  / scale),
+                                         juce::roundToInt ((float) kDisplayHeight / scale));
+
+                auto editorTarget  = makeTarget (editor.getLocalBounds(), scale);
+                auto overlayTarget = focus ? makeTarget (overlay.getLocalBounds(), scale) : juce::Image();
+
+                Case c;
+                c.name = juce::String (focus ? "focus-4k" : "editor")
+                       + " x" + juce::String (scale, 2) + " " + juce::String (numPressed) + "-pressed";
+                c.pixelWidth  = focus ? overlayTarget.getWidth()  : editorTarget.getWidth();
+                c.pixelHeight = focus ? overlayTarget.getHeight() : editorTarget.getHeight();
+
+                // The editor is new, so the first frame builds its cached layers.
+                auto frame = [&]
+                {
+                    if (focus)
+                        paintInto (overlayTarget, overlay, scale);
+
+                    paintInto (editorTarget, editor, scale);
+                };
+
+                auto start = juce::Time::getHighResolutionTicks();
+                frame();
+                c.firstFrameMs = ticksToMs (juce::Time::getHighResolutionTicks() - start);
+
+                const auto allocsBefore = getThreadAllocationCount();
+                double     totalMs      = 0.0;
+
+                for (int i = 1; i < framesPerCase; ++i)
+                {
+                    start = juce::Time::getHighResolutionTicks();
+                    frame();
+                    const double ms = ticksToMs (juce::Time::getHighResolutionTicks() - start);
+
+                    totalMs         += ms;
+                    c.worstFrameMs   = juce::jmax (c.worstFrameMs, ms);
+                }
+
+                const int numFrames = framesPerCase - 1;
+                c.msPerFrame = totalMs / numFrames;
+
+                if (allocsBefore >= 0)
+                    c.allocsPerFrame = (double) (getThreadAllocationCount() - allocsBefore) / numFrames;
+
+                result.cases.push_back (c);
+            }
+        }
+    }
+
+    processor->sendAllNotesOff();
+    processor->releaseResources();
+
+    result.wallSeconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - wallStart);
+    return result;
+}
+
+//==============================================================================
+juce::String PaintBenchmark::Result::toText() const
+{
+    juce::String text;
+    text << "# case\tpixels\tfirst ms\tms/frame\tworst ms\tallocs/frame\n";
+
+    for (const auto& c : cases)
+        text << c.name << '\t' << c.pixelWidth << 'x' << c.pixelHeight
+             << '\t' << juce::String (c.firstFrameMs, 3)
+             << '\t' << juce::String (c.msPerFrame, 3)
+             << '\t' << juce::String (c.worstFrameMs, 3)
+             << '\t' << juce::String (c.allocsPerFrame, 1) << '\n';
+
+    return text;
+}
+
+PaintBenchmark::Result PaintBenchmark::Result::fromText (const juce::String& text)
+{
+    Result result;
+
+    for (const auto& line : juce::StringArray::fromLines (text))
+    {
+        if (line.startsWithChar ('#'))
+            continue;
+
+        const auto fields = juce::StringArray::fromTokens (line, "\t", {});
+        if (fields.size() != 6 || ! fields[1].containsChar ('x'))
+            continue;
+
+        Case c;
+        c.name           = fields[0];
+        c.pixelWidth     = fields[1].upToFirstOccurrenceOf ("x", false, false).getIntValue();
+        c.pixelHeight    = fields[1].fromFirstOccurrenceOf ("x", false, false).getIntValue();
+        c.firstFrameMs   = fields[2].getDoubleValue();
+        c.msPerFrame     = fields[3].getDoubleValue();
+        c.worstFrameMs   = fields[4].getDoubleValue();
+        c.allocsPerFrame = fields[5].getDoubleValue();
+        result.cases.push_back (c);
+    }
+
+    return result;
+}
+
+juce::StringArray PaintBenchmark::Result::findRegressions (const Result& baseline, double tolerance) const
+{
+    juce::StringArray regressions;
+
+    for (const auto& c : cases)
+    {
+        for (const auto& b : baseline.cases)
+        {
+            if (b.name != c.name)
+                continue;
+
+            if (c.msPerFrame > b.msPerFrame * (1.0 + tolerance) + 0.05)
+                regressions.add (c.name + ": " + juce::String (c.msPerFrame, 3) + " ms/frame (was "
+                                   + juce::String (b.msPerFrame, 3) + ")");
+
+            if (b.allocsPerFrame >= 0.0 && c.allocsPerFrame > b.allocsPerFrame)
+                regressions.add (c.name + ": " + juce::String (c.allocsPerFrame, 1) + " allocs/frame (was "
+                                   + juce::String (b.allocsPerFrame, 1) + ")");
+            break;
+        }
+    }
+
+    return regressions;
+}
+
+juce::StringArray PaintBenchmark::Result::findMissing (const Result& baseline) const
+{
+    juce::StringArray missing;
+
+    for (const auto& c : cases)
+        if (std::none_of (baseline.cases.begin(), baseline.cases.end(),
+                          [&] (const Case& b) { return b.name == c.name; }))
+            missing.add (c.name);
+
+    return missing;
+}
+
+double PaintBenchmark::Result::worstMsPerFrame() const noexcept
+{
+    double worst = 0.0;
+    for (const auto& c : cases)
+        worst = juce::jmax (worst, c.msPerFrame);
+    return worst;
+}
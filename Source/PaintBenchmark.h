@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Offscreen benchmark of the editor's paint path.
+
+    Renders private editors (on a private processor, so nothing is shared
+    with the live UI) into an offscreen juce::Image with the software
+    renderer, so it needs a message thread but no display or window.  Cases
+    cover the normal editor and Focus mode on a 3840 x 2160 display (the
+    full-screen capture overlay plus the editor on top), at several display
+    scales and with 0 / 4 / 16 / 48 cells pressed through the processor.
+
+    Each case opens a new editor, so its first frame builds the cached
+    layers and is reported on its own; the rest are full repaints of the
+    whole component, reported as mean and worst milliseconds per frame.
+
+    Allocations per frame are counted on the calling thread when the build
+    defines STRADELLA_COUNT_ALLOCATIONS=1, which replaces the global
+    operator new; otherwise they are reported as -1.  Do not ship plugin
+    builds with it on.
+
+    A report can be saved and later runs compared against it, case by case,
+    so a rendering change that slows a case down or starts allocating shows
+    up as a regression.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef STRADELLA_COUNT_ALLOCATIONS
+ #define STRADELLA_COUNT_ALLOCATIONS 0
+#endif
+
+//==============================================================================
+class PaintBenchmark
+{
+public:
+    //==============================================================================
+    struct Case
+    {
+        juce::String name;                   ///< e.g. "focus-4k x1.5 16-pressed"
+        int          pixelWidth     = 0;     ///< rendered physical pixels
+        int          pixelHeight    = 0;
+        double       firstFrameMs   = 0.0;   ///< includes rebuilding the cached layers
+        double       msPerFrame     = 0.0;   ///< mean of the remaining frames
+        double       worstFrameMs   = 0.0;
+        double       allocsPerFrame = -1.0;  ///< -1 = not counted in this build
+    };
+
+    struct Result
+    {
+        std::vector<Case> cases;
+        double            wallSeconds = 0.0;
+
+        /** One line per case: name, size, first / mean / worst ms, allocations. */
+        juce::String toText() const;
+
+        /** Reads a report written by toText(); cases that do not parse are skipped. */
+        static Result fromText (const juce::String& text);
+
+        /** Cases slower than the baseline's by more than `tolerance` (0.25 =
+            25 %, with 0.05 ms of slack for timer noise) or allocating more
+            per frame.  Cases missing from the baseline are skipped here and
+            reported by findMissing(). */
+        juce::StringArray findRegressions (const Result& baseline, double tolerance = 0.25) const;
+
+        /** Names of this run's cases the baseline has no entry for. */
+        juce::StringArray findMissing (const Result& baseline) const;
+
+        double worstMsPerFrame() const noexcept;
+    };
+
+    /** Runs every case.  Message thread; blocks for a few seconds. */
+    static Result run (int framesPerCase = 30);
+
+    /** Allocations made so far on the calling thread (-1 when not counted). */
+    static juce::int64 getThreadAllocationCount() noexcept;
+};
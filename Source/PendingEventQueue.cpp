@@ -0,0 +1,253 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Pending event queue implementation.
+
+  ==============================================================================
+*/
+
+#include "PendingEventQueue.h"
+
+//==============================================================================
+PendingEventQueue::PendingEventQueue()
+{
+    std::fill (&controllerSlot[0][0], &controllerSlot[0][0] + 16 * 120, (juce::int16) -1);
+}
+
+void PendingEventQueue::setMaxAgeMs (int ms) noexcept
+{
+    maxAgeMs    = juce::jmax (0, ms);
+    maxAgeTicks = juce::Time::getHighResolutionTicksPerSecond() * maxAgeMs / 1000;
+}
+
+PendingEventQueue::Kind PendingEventQueue::classify (const juce::uint8* data, int size) noexcept
+{
+    const auto type = data[0] & 0xf0;
+
+    if (type == 0x90 && size >= 3)
+        return data[2] > 0 ? Kind::noteOn : Kind::noteOff;
+
+    if (type == 0x80)
+        return Kind::noteOff;
+
+    if (type == 0xb0 && size >= 3)
+        return data[1] < 120 ? Kind::controller : Kind::channelMode;
+
+    return Kind::other;
+}
+
+void PendingEventQueue::setSwallowing (int channel, int note, bool on) noexcept
+{
+    const auto bit = (juce::uint64) 1 << (note & 63);
+
+    if (on)
+        swallowNoteOff[channel][note >> 6] |= bit;
+    else
+        swallowNoteOff[channel][note >> 6] &= ~bit;
+}
+
+//==============================================================================
+bool PendingEventQueue::push (const juce::MidiMessage& msg, juce::int64 ticks, int cell,
+                              int velocityOffset) noexcept
+{
+    const auto* data = msg.getRawData();
+    const int   size = msg.getRawDataSize();
+
+    if (size < 1 || size > 3)
+    {
+        bump (numOverflowed);
+        return false;
+    }
+
+    const int  channel = data[0] & 0x0f;
+    const auto kind    = classify (data, size);
+
+    switch (kind)
+    {
+        case Kind::noteOff:
+        {
+            // Its note-on never left the queue: drop the pair.
+            if (isSwallowing (channel, data[1]))
+            {
+                setSwallowing (channel, data[1], false);
+                return true;
+            }
+
+            if (numEvents == kCapacity && ! makeRoomForRelease (channel, data[1]))
+                break;
+
+            // makeRoomForRelease() may have cancelled the queued note-on.
+            if (isSwallowing (channel, data[1]))
+            {
+                setSwallowing (channel, data[1], false);
+                return true;
+            }
+
+            return append (msg, ticks, cell, velocityOffset);
+        }
+
+        case Kind::channelMode:
+            if (numEvents == kCapacity && ! makeRoomForRelease (channel, -1))
+                break;
+
+            return append (msg, ticks, cell, velocityOffset);
+
+        case Kind::controller:
+        {
+            const auto slot = controllerSlot[channel][data[1]];
+            if (slot >= 0)
+            {
+                auto& e = events[slot];
+                e.data[2] = data[2];
+                e.ticks   = ticks;
+                bump (numCollapsed);
+                return true;
+            }
+
+            if (numEvents >= kCapacity - kReleaseReserve)
+                break;
+
+            controllerSlot[channel][data[1]] = (juce::int16) numEvents;
+            return append (msg, ticks, cell, velocityOffset);
+        }
+
+        case Kind::noteOn:
+            if (numEvents >= kCapacity - kReleaseReserve)
+            {
+                setSwallowing (channel, data[1], true);
+                break;
+            }
+
+            setSwallowing (channel, data[1], false);
+            return append (msg, ticks, cell, velocityOffset);
+
+        case Kind::other:
+        default:
+            if (numEvents >= kCapacity - kReleaseReserve)
+                break;
+
+            return append (msg, ticks, cell, velocityOffset);
+    }
+
+    bump (numOverflowed);
+    return false;
+}
+
+bool PendingEventQueue::append (const juce::MidiMessage& msg, juce::int64 ticks, int cell,
+                                int velocityOffset) noexcept
+{
+    jassert (numEvents < kCapacity);
+
+    auto& e   = events[numEvents++];
+    e.ticks   = ticks;
+    e.cell    = (juce::int8) cell;
+    e.velocityOffset = (juce::int8) juce::jlimit (-127, 127, velocityOffset);
+    e.delayMs = (float) msg.getTimeStamp();
+    e.size    = (juce::uint8) msg.getRawDataSize();
+    std::memcpy (e.data, msg.getRawData(), e.size);
+
+    depth.store (numEvents, std::memory_order_relaxed);
+    return true;
+}
+
+// The queue is full and a release-class message must get in.  Cancels the
+// queued note-on the note-off belongs to if there is one (the pair is then
+// swallowed), otherwise evicts the oldest queued CC.
+bool PendingEventQueue::makeRoomForRelease (int channel, int note) noexcept
+{
+    if (note >= 0)
+    {
+        const auto status = (juce::uint8) (0x90 | channel);
+
+        for (int i = numEvents; --i >= 0;)
+        {
+            const auto& e = events[i];
+            if (e.data[0] == status && e.data[1] == note && e.size >= 3 && e.data[2] > 0)
+            {
+                removeAt (i);
+                setSwallowing (channel, note, true);
+                bump (numOverflowed);
+                return true;
+            }
+        }
+    }
+
+    for (int i = 0; i < numEvents; ++i)
+    {
+        if (classify (events[i].data, events[i].size) == Kind::controller)
+        {
+            removeAt (i);
+            bump (numOverflowed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void PendingEventQueue::removeAt (int index) noexcept
+{
+    const auto& removed = events[index];
+    if (classify (removed.data, removed.size) == Kind::controller)
+        controllerSlot[removed.data[0] & 0x0f][removed.data[1]] = -1;
+
+    std::memmove (events + index, events + index + 1, sizeof (Event) * (size_t) (numEvents - index - 1));
+    --numEvents;
+    depth.store (numEvents, std::memory_order_relaxed);
+
+    for (int i = index; i < numEvents; ++i)
+        if (classify (events[i].data, events[i].size) == Kind::controller)
+            controllerSlot[events[i].data[0] & 0x0f][events[i].data[1]] = (juce::int16) i;
+}
+
+//==============================================================================
+int PendingEventQueue::popAll (Event* dest, juce::int64 nowTicks) noexcept
+{
+    int numOut = 0;
+
+    for (int i = 0; i < numEvents; ++i)
+    {
+        const auto& e       = events[i];
+        const int   channel = e.data[0] & 0x0f;
+        const auto  kind    = classify (e.data, e.size);
+
+        switch (kind)
+        {
+            case Kind::noteOff:
+                // Pair of a note-on that expired earlier in this pass.
+                if (isSwallowing (channel, e.data[1]))
+                {
+                    setSwallowing (channel, e.data[1], false);
+                    continue;
+                }
+                break;
+
+            case Kind::channelMode:
+                break;
+
+            case Kind::controller:
+                controllerSlot[channel][e.data[1]] = -1;
+                [[fallthrough]];
+
+            case Kind::noteOn:
+            case Kind::other:
+            default:
+                if (maxAgeTicks > 0 && nowTicks - e.ticks > maxAgeTicks)
+                {
+                    if (kind == Kind::noteOn)
+                        setSwallowing (channel, e.data[1], true);
+
+                    bump (numExpired);
+                    continue;
+                }
+                break;
+        }
+
+        dest[numOut++] = e;
+    }
+
+    numEvents = 0;
+    depth.store (0, std::memory_order_relaxed);
+    return numOut;
+}
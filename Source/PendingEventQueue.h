@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Fixed-capacity queue for the messages the UI hands to processBlock.
+
+    The host may stop calling processBlock for a long time (stopped
+    transport, bypass) while the mouse keeps producing CCs, so the queue
+    never grows and applies explicit policies instead:
+
+      - A CC (0-119) replaces the queued value of the same controller
+        rather than taking a new slot.
+      - Note-ons and other channel messages only use the first
+        kCapacity - kReleaseReserve slots; the rest is kept for note-offs
+        and channel-mode messages (All Notes Off etc.), which may also evict
+        the oldest queued CC when the queue is completely full.
+      - A note-on that is refused or expires is remembered, and its
+        note-off is swallowed, so a note is never dropped without its pair.
+      - On popAll(), events older than the maximum age expire.  Note-offs
+        and channel-mode messages never expire.
+
+    Not thread-safe apart from the counters: the processor guards it with its
+    message lock.  Neither push() nor popAll() allocates.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class PendingEventQueue
+{
+public:
+    //==============================================================================
+    static constexpr int kCapacity       = 1024;
+    static constexpr int kReleaseReserve = 128;
+
+    /** A queued ≤ 3 byte message.  delayMs is the rolled-chord offset from
+        the start of the block that picks it up (0 = play at once). */
+    struct Event
+    {
+        juce::int64 ticks   = 0;      ///< high-resolution ticks when queued
+        float       delayMs = 0.0f;
+        juce::uint8 data[3] {};
+        juce::uint8 size    = 0;
+        juce::int8  cell    = -1;     ///< grid cell the note belongs to, -1 = none
+        juce::int8  velocityOffset = 0;   ///< roll tilt, kept when a route replaces the velocity
+    };
+
+    //==============================================================================
+    PendingEventQueue();
+
+    /** Events older than this expire when popped; 0 disables expiry. */
+    void setMaxAgeMs (int ms) noexcept;
+    int  getMaxAgeMs() const noexcept   { return maxAgeMs; }
+
+    /** Queues msg (its timestamp is the roll delay in ms) for the given grid
+        cell.  Returns false if it was refused; a collapsed CC counts as queued. */
+    bool push (const juce::MidiMessage& msg, juce::int64 ticks, int cell = -1,
+               int velocityOffset = 0) noexcept;
+
+    /** Moves every live event, oldest first, into dest (room for kCapacity)
+        and empties the queue.  Returns the number written. */
+    int popAll (Event* dest, juce::int64 nowTicks) noexcept;
+
+    /** Current depth; readable from any thread. */
+    int getNumQueued() const noexcept   { return depth.load (std::memory_order_relaxed); }
+
+    // Policy counters; readable from any thread.
+    juce::uint64 getNumCollapsed()  const noexcept { return numCollapsed.load (std::memory_order_relaxed); }
+    juce::uint64 getNumOverflowed() const noexcept { return numOverflowed.load (std::memory_order_relaxed); }
+    juce::uint64 getNumExpired()    const noexcept { return numExpired.load (std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    enum class Kind { noteOn, noteOff, controller, channelMode, other };
+
+    static Kind classify (const juce::uint8* data, int size) noexcept;
+
+    bool append (const juce::MidiMessage& msg, juce::int64 ticks, int cell, int velocityOffset) noexcept;
+    bool makeRoomForRelease (int channel, int note) noexcept;
+    void removeAt (int index) noexcept;
+
+    bool isSwallowing (int channel, int note) const noexcept { return (swallowNoteOff[channel][note >> 6] >> (note & 63)) & 1; }
+    void setSwallowing (int channel, int note, bool on) noexcept;
+
+    static void bump (std::atomic<juce::uint64>& counter) noexcept { counter.fetch_add (1, std::memory_order_relaxed); }
+
+    Event        events[kCapacity];
+    int          numEvents = 0;
+    juce::int16  controllerSlot[16][120];    ///< queued index per channel/CC, -1 = none
+    juce::uint64 swallowNoteOff[16][2] {};   ///< note-ons dropped whose note-off is still to come
+
+    int         maxAgeMs    = 0;
+    juce::int64 maxAgeTicks = 0;
+
+    std::atomic<int>          depth         { 0 };
+    std::atomic<juce::uint64> numCollapsed  { 0 };
+    std::atomic<juce::uint64> numOverflowed { 0 };
+    std::atomic<juce::uint64> numExpired    { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PendingEventQueue)
+};
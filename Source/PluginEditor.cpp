@@ -53,7 +53,14 @@ StraDellaMIDI_pluginAudioProcessorEditor::StraDellaMIDI_pluginAudioProcessorEdit
     const int w = kLabelW + Proc::NUM_COLUMNS * kBtnW + staggerExtra;
     const int h = kTitleH + kHeaderH + Proc::NUM_ROWS * kBtnH + kBottomH;
     setSize (w, h);
+    setOpaque (true);
     setWantsKeyboardFocus (true);
+    gridInput.buildKeyTable (StradellaKeyboardMapper());
+
+    // Cells already held when the editor opens show from the first paint,
+    // before the first vblank.
+    displayedState = audioProcessor.getUiSnapshot();
+    displayedState.heldCells |= audioProcessor.getRecognizedCells();
 
     // ── Focus toggle button ───────────────────────────────────────────────────
     focusButton.setClickingTogglesState (true);
@@ -65,35 +72,35 @@ StraDellaMIDI_pluginAudioProcessorEditor::StraDellaMIDI_pluginAudioProcessorEdit
         focusActive = focusButton.getToggleState();
         if (focusActive)
         {
-            grabKeyboardFocus();
             aboutButton     .setInterceptsMouseClicks (false, false);
             mappingButton   .setInterceptsMouseClicks (false, false);
             expressionButton.setInterceptsMouseClicks (false, false);
-
-            // Expand window to fill the primary display so mouse events are
-            // captured from anywhere on screen.  The area outside the original
-            // plugin UI will be rendered at half-transparency.
-            originalWidth  = getWidth();
-            originalHeight = getHeight();
-            setOpaque (false);
+            outputButton    .setInterceptsMouseClicks (false, false);
+            monitorButton   .setInterceptsMouseClicks (false, false);
+
+            // Capture mouse clicks from anywhere on the primary display with a
+            // separate window placed behind the plugin UI, where the UI has a
+            // window of its own (standalone).  The editor itself keeps its
+            // normal, opaque size so key presses only repaint the cells that
+            // change.
             auto* disp = juce::Desktop::getInstance().getDisplays().getPrimaryDisplay();
-            if (disp != nullptr)
+            if (disp != nullptr && FocusCaptureOverlay::canShowBehind (*getTopLevelComponent()))
             {
-                setSize (disp->userArea.getWidth(), disp->userArea.getHeight());
-                setTopLeftPosition (0, 0);
+                focusOverlay = std::make_unique<FocusCaptureOverlay> (*this);
+                focusOverlay->showBehind (*getTopLevelComponent(), disp->userArea);
             }
+
+            grabKeyboardFocus();
         }
         else
         {
             aboutButton     .setInterceptsMouseClicks (true, true);
             mappingButton   .setInterceptsMouseClicks (true, true);
             expressionButton.setInterceptsMouseClicks (true, true);
+            outputButton    .setInterceptsMouseClicks (true, true);
+            monitorButton   .setInterceptsMouseClicks (true, true);
 
-            // Restore original plugin size.
-            setOpaque (true);
-            if (originalWidth > 0 && originalHeight > 0)
-                setSize (originalWidth, originalHeight);
-            originalWidth = originalHeight = 0;
+            focusOverlay.reset();
         }
     };
     addAndMakeVisible (focusButton);
@@ -103,27 +110,8 @@ StraDellaMIDI_pluginAudioProcessorEditor::StraDellaMIDI_pluginAudioProcessorEdit
     panicButton.setColour (juce::TextButton::textColourOffId, juce::Colours::white);
     panicButton.onClick = [this]
     {
-        // Release any currently held mouse button.
-        if (pressedRow >= 0)
-        {
-            audioProcessor.buttonReleased (pressedRow, pressedCol);
-            pressedRow = pressedCol = -1;
-        }
-
-        // Release every key held via the computer keyboard.
-        for (auto it = activeKeyRow.begin(); it != activeKeyRow.end(); ++it)
-        {
-            const int row = it.getValue();
-            const int col = activeKeyCol[it.getKey()];
-            audioProcessor.buttonReleased (row, col);
-            keyboardPressedGrid[row][col] = false;
-        }
-        activeKeyRow.clear();
-        activeKeyCol.clear();
-
-        // Broadcast All Notes Off + All Sound Off on all MIDI channels.
-        audioProcessor.sendAllNotesOff();
-        repaint();
+        // Releases held mouse/keyboard cells, then All Notes Off on all channels.
+        gridInput.panic (juce::Time::getHighResolutionTicks());
     };
     addAndMakeVisible (panicButton);
 
@@ -146,7 +134,7 @@ StraDellaMIDI_pluginAudioProcessorEditor::StraDellaMIDI_pluginAudioProcessorEdit
     mappingButton.onClick = [this]
     {
         juce::DialogWindow::LaunchOptions opts;
-        opts.content.setOwned (new MappingSettingsWindow (audioProcessor));
+        opts.content.setOwned (new MappingSettingsWindow (audioProcessor, mappingWatcher.getLastReport()));
         opts.dialogTitle                  = "Mapping Settings";
         opts.dialogBackgroundColour       = juce::Colour (0xff2a2a3e);
         opts.escapeKeyTriggersCloseButton = true;
@@ -168,41 +156,50 @@ StraDellaMIDI_pluginAudioProcessorEditor::StraDellaMIDI_pluginAudioProcessorEdit
         opts.launchAsync();
     };
 
-    addAndMakeVisible (aboutButton);
-    addAndMakeVisible (mappingButton);
-    addAndMakeVisible (expressionButton);
-
-    // Wire mouse expression MIDI output to the processor.
-    mouseExpression.onMidiMessage = [this] (const juce::MidiMessage& msg)
+    // Output button: polyphony, host input, queue expiry and direct output.
+    outputButton.onClick = [this]
     {
-        audioProcessor.addMidiMessage (msg);
+        juce::DialogWindow::LaunchOptions opts;
+        opts.content.setOwned (new OutputSettingsWindow (audioProcessor));
+        opts.dialogTitle                  = "Output Settings";
+        opts.dialogBackgroundColour       = juce::Colour (0xff2a2a3e);
+        opts.escapeKeyTriggersCloseButton = true;
+        opts.useNativeTitleBar            = false;
+        opts.resizable                    = false;
+        opts.launchAsync();
     };
 
-    // When the bellows direction changes, retrigger all held notes.
-    mouseExpression.onDirectionChange = [this]
+    // Monitor button: show the MIDI output monitor.  Only one may be open:
+    // it is the single reader of the output tap.
+    monitorButton.onClick = [this]
     {
-        const int vel = mouseExpression.getCurrentNoteVelocity();
-        auto mods = juce::ModifierKeys::getCurrentModifiers();
-        const bool leftDown  = mods.isLeftButtonDown();
-        const bool rightDown = mods.isRightButtonDown();
-
-        if (pressedRow >= 0)
+        if (monitorDialog != nullptr)
         {
-            audioProcessor.buttonReleased (pressedRow, pressedCol);
-            audioProcessor.buttonPressed  (pressedRow, pressedCol, vel, leftDown, rightDown);
+            monitorDialog->toFront (true);
+            return;
         }
 
-        for (auto it = activeKeyRow.begin(); it != activeKeyRow.end(); ++it)
-        {
-            const int row = it.getValue();
-            const int col = activeKeyCol[it.getKey()];
-            audioProcessor.buttonReleased (row, col);
-            audioProcessor.buttonPressed  (row, col, vel, leftDown, rightDown);
-        }
+        juce::DialogWindow::LaunchOptions opts;
+        opts.content.setOwned (new MidiMonitorWindow (audioProcessor));
+        opts.dialogTitle                  = "MIDI Monitor";
+        opts.dialogBackgroundColour       = juce::Colour (0xff2a2a3e);
+        opts.escapeKeyTriggersCloseButton = true;
+        opts.useNativeTitleBar            = false;
+        opts.resizable                    = false;
+        monitorDialog = opts.launchAsync();
     };
 
+    addAndMakeVisible (aboutButton);
+    addAndMakeVisible (mappingButton);
+    addAndMakeVisible (expressionButton);
+    addAndMakeVisible (outputButton);
+    addAndMakeVisible (monitorButton);
+
+    // Expression CCs and the bellows retrigger are wired up by gridInput.
     mouseExpression.startTracking();
 
+    mappingWatcher.watch (KeyboardMappingWatcher::getDefaultFile());
+
     // Register for global focus-change events so Focus mode can re-assert focus.
     juce::Desktop::getInstance().addFocusChangeListener (this);
 }
@@ -210,6 +207,9 @@ StraDellaMIDI_pluginAudioProcessorEditor::StraDellaMIDI_pluginAudioProcessorEdit
 StraDellaMIDI_pluginAudioProcessorEditor::~StraDellaMIDI_pluginAudioProcessorEditor()
 {
     juce::Desktop::getInstance().removeFocusChangeListener (this);
+
+    // A new editor must not open a second reader of the output tap.
+    monitorDialog.deleteAndZero();
 }
 
 //==============================================================================
@@ -265,29 +265,89 @@ StraDellaMIDI_pluginAudioProcessorEditor::rowColour (int row, bool pressed) cons
     return pressed ? base.brighter (0.5f) : base;
 }
 
+// A cell is drawn pressed when the processor reports it held, whatever the
+// source (mouse, keyboard, retrigger or any other input).
+bool StraDellaMIDI_pluginAudioProcessorEditor::isCellPressed (int row, int col) const
+{
+    return displayedState.isHeld (row, col);
+}
+
+// Invalidates only the pixels of one grid cell.
+void StraDellaMIDI_pluginAudioProcessorEditor::repaintCell (int row, int col)
+{
+    if (row >= 0 && col >= 0)
+        repaint (buttonBounds (row, col));
+}
+
+// Small vertical bellows/expression meter left of the panic button.
+juce::Rectangle<int> StraDellaMIDI_pluginAudioProcessorEditor::expressionMeterBounds() const
+{
+    return { getWidth() - 79, 10, 8, 36 };
+}
+
+// Called once per display refresh: reads the processor snapshot and repaints
+// only the cells (and meter) whose state changed since the last frame.
+void StraDellaMIDI_pluginAudioProcessorEditor::updateFromProcessor()
+{
+    // Cells matching the chord recognized on the host input light up too.
+    auto latest = audioProcessor.getUiSnapshot();
+    latest.heldCells |= audioProcessor.getRecognizedCells();
+
+    auto       changed = latest.heldCells ^ displayedState.heldCells;
+    const bool expressionChanged = latest.expression != displayedState.expression;
+
+    displayedState = latest;
+
+    for (int bit = 0; changed != 0; ++bit, changed >>= 1)
+        if ((changed & 1) != 0)
+            repaintCell (bit / Proc::NUM_COLUMNS, bit % Proc::NUM_COLUMNS);
+
+    if (expressionChanged)
+        repaint (expressionMeterBounds());
+
+    // Mouse button changes re-voice held chords; settings changes are
+    // recorded at frame rate while a session is running.
+    const auto now = juce::Time::getHighResolutionTicks();
+    gridInput.pollMouseButtons (now);
+    gridInput.pollSettings (now);
+}
+
 //==============================================================================
-void StraDellaMIDI_pluginAudioProcessorEditor::paint (juce::Graphics& g)
+// Draws one rounded button (fill, border and note label) into `area`.
+void StraDellaMIDI_pluginAudioProcessorEditor::drawButton (juce::Graphics& g, int row, int col,
+                                                           bool pressed, juce::Rectangle<int> area) const
 {
-    // When Focus mode has expanded the window to fill the screen, uiW/uiH define
-    // the original plugin UI area.  Everything outside is rendered as a
-    // semi-transparent overlay so the underlying desktop is dimly visible.
-    const int uiW = (focusActive && originalWidth  > 0) ? originalWidth  : getWidth();
-    const int uiH = (focusActive && originalHeight > 0) ? originalHeight : getHeight();
+    const juce::Font noteFont (juce::FontOptions (11.0f));
+
+    // Fill
+    g.setColour (rowColour (row, pressed));
+    g.fillRoundedRectangle (area.reduced (2).toFloat(), 5.0f);
+
+    // Border
+    g.setColour (pressed ? juce::Colours::white
+                         : juce::Colours::darkgrey);
+    g.drawRoundedRectangle (area.reduced (2).toFloat(), 5.0f, 1.0f);
+
+    // Note label inside button
+    // Third row shows the note a major 3rd above the root;
+    // all other rows show the root (column) note name.
+    g.setColour (juce::Colours::black);
+    g.setFont (noteFont);
+    const juce::String label = (row == Proc::COUNTERBASS)
+                               ? Proc::getThirdNoteName (col)
+                               : Proc::getColumnName (col);
+    g.drawFittedText (label, area.reduced (3),
+                      juce::Justification::centred, 1);
+}
 
+// Draws everything that does not depend on press state: background, title,
+// column headers, row labels and every button in its unpressed state.
+void StraDellaMIDI_pluginAudioProcessorEditor::drawStaticLayer (juce::Graphics& g, int uiW, int uiH) const
+{
     // Background for the original plugin area (fully opaque dark)
     g.setColour (juce::Colour (0xff1a1a2e));
     g.fillRect (0, 0, uiW, uiH);
 
-    // Semi-transparent dark overlay covering the expanded strips
-    if (getWidth() > uiW || getHeight() > uiH)
-    {
-        g.setColour (juce::Colour (0x80000000));   // black @ 50% alpha
-        if (getWidth() > uiW)
-            g.fillRect (uiW, 0, getWidth() - uiW, getHeight());    // right strip (full height)
-        if (getHeight() > uiH)
-            g.fillRect (0, uiH, uiW, getHeight() - uiH);           // bottom strip (left part only)
-    }
-
     // ── Branding / title area ────────────────────────────────────────────────
     {
         // "straDella" in large bold italic (approximates a script font)
@@ -308,7 +368,6 @@ void StraDellaMIDI_pluginAudioProcessorEditor::paint (juce::Graphics& g)
     }
 
     const juce::Font labelFont (juce::FontOptions (12.0f, juce::Font::bold));
-    const juce::Font noteFont  (juce::FontOptions (11.0f));
 
     // ── Column headers (note names, aligned with row 0) ──────────────────────
     g.setColour (juce::Colours::lightgrey);
@@ -335,48 +394,95 @@ void StraDellaMIDI_pluginAudioProcessorEditor::paint (juce::Graphics& g)
                           juce::Justification::centredLeft, 2);
     }
 
-    // ── Button grid ──────────────────────────────────────────────────────────
+    // ── Button grid (unpressed) ──────────────────────────────────────────────
+    for (int row = 0; row < Proc::NUM_ROWS; ++row)
+        for (int col = 0; col < Proc::NUM_COLUMNS; ++col)
+            drawButton (g, row, col, false, buttonBounds (row, col));
+}
+
+// Re-renders the cached layers at the given physical pixel scale.  Called
+// lazily from paint() whenever the scale or the UI size changes, so text is
+// laid out and rasterised once instead of on every repaint.
+void StraDellaMIDI_pluginAudioProcessorEditor::renderCaches (float scale, int uiW, int uiH)
+{
+    cacheScale  = scale;
+    cacheWidth  = uiW;
+    cacheHeight = uiH;
+
+    staticLayerCache = juce::Image (juce::Image::RGB,
+                                    juce::jmax (1, juce::roundToInt ((float) uiW * scale)),
+                                    juce::jmax (1, juce::roundToInt ((float) uiH * scale)),
+                                    false);
+    {
+        juce::Graphics ig (staticLayerCache);
+        ig.addTransform (juce::AffineTransform::scale (scale));
+        drawStaticLayer (ig, uiW, uiH);
+    }
+
+    const int spriteW = juce::roundToInt ((float) kBtnW * scale);
+    const int spriteH = juce::roundToInt ((float) kBtnH * scale);
+
     for (int row = 0; row < Proc::NUM_ROWS; ++row)
     {
         for (int col = 0; col < Proc::NUM_COLUMNS; ++col)
         {
-            const bool pressed = (row == pressedRow && col == pressedCol)
-                              || keyboardPressedGrid[row][col];
-            const auto bounds  = buttonBounds (row, col);
-
-            // Fill
-            g.setColour (rowColour (row, pressed));
-            g.fillRoundedRectangle (bounds.reduced (2).toFloat(), 5.0f);
-
-            // Border
-            g.setColour (pressed ? juce::Colours::white
-                                 : juce::Colours::darkgrey);
-            g.drawRoundedRectangle (bounds.reduced (2).toFloat(), 5.0f, 1.0f);
-
-            // Note label inside button
-            // Third row shows the note a major 3rd above the root;
-            // all other rows show the root (column) note name.
-            g.setColour (juce::Colours::black);
-            g.setFont (noteFont);
-            const juce::String label = (row == Proc::COUNTERBASS)
-                                       ? Proc::getThirdNoteName (col)
-                                       : Proc::getColumnName (col);
-            g.drawFittedText (label, bounds.reduced (3),
-                              juce::Justification::centred, 1);
+            auto& sprite = pressedSprites[row][col];
+            sprite = juce::Image (juce::Image::ARGB, spriteW, spriteH, true);
+
+            juce::Graphics ig (sprite);
+            ig.addTransform (juce::AffineTransform::scale (scale));
+            drawButton (ig, row, col, true, { 0, 0, kBtnW, kBtnH });
         }
     }
 }
 
+//==============================================================================
+void StraDellaMIDI_pluginAudioProcessorEditor::paint (juce::Graphics& g)
+{
+    const int uiW = getWidth();
+    const int uiH = getHeight();
+
+    const auto scale = (float) g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (scale != cacheScale || uiW != cacheWidth || uiH != cacheHeight)
+        renderCaches (scale, uiW, uiH);
+
+    // Static layer: only the part inside the clip region is actually blitted.
+    g.drawImage (staticLayerCache, juce::Rectangle<int> (0, 0, uiW, uiH).toFloat());
+
+    // Pressed buttons are drawn from their sprites, skipping any cell that
+    // lies outside the area being repainted.
+    for (int row = 0; row < Proc::NUM_ROWS; ++row)
+    {
+        for (int col = 0; col < Proc::NUM_COLUMNS; ++col)
+        {
+            if (! isCellPressed (row, col))
+                continue;
+
+            const auto bounds = buttonBounds (row, col);
+            if (g.clipRegionIntersects (bounds))
+                g.drawImage (pressedSprites[row][col], bounds.toFloat());
+        }
+    }
+
+    // Expression meter (fills from the bottom).
+    const auto meter = expressionMeterBounds();
+    if (g.clipRegionIntersects (meter))
+    {
+        g.setColour (juce::Colour (0xff3a3a5e));
+        g.fillRect (meter);
+        const int fillH = meter.getHeight() * displayedState.expression / 127;
+        g.setColour (juce::Colour (0xff22aa44));
+        g.fillRect (meter.withTop (meter.getBottom() - fillH));
+    }
+}
+
 void StraDellaMIDI_pluginAudioProcessorEditor::resized()
 {
-    // When in full-screen Focus mode the window may be the size of the entire
-    // display.  Always lay out UI elements relative to the original plugin size
-    // so they remain in the same position.
-    const int uiW = (focusActive && originalWidth > 0) ? originalWidth : getWidth();
+    const int uiW = getWidth();
 
     const int btnAreaY = kTitleH + kHeaderH + Proc::NUM_ROWS * kBtnH + 5;
     const int btnH     = kBottomH - 8;
-    const int third    = (uiW - 8) / 3;
+    const int fifth    = (uiW - 12) / 5;
 
     // Top-row buttons sit inside the title area.
     static constexpr int kTopBtnY = 10;
@@ -384,9 +490,11 @@ void StraDellaMIDI_pluginAudioProcessorEditor::resized()
     focusButton.setBounds (5,           kTopBtnY, 100, kTopBtnH);
     panicButton.setBounds (uiW - 65,    kTopBtnY,  60, kTopBtnH);
 
-    aboutButton     .setBounds (2,               btnAreaY, third,     btnH);
-    mappingButton   .setBounds (2 + third + 2,   btnAreaY, third,     btnH);
-    expressionButton.setBounds (2 + 2 * (third + 2), btnAreaY, third + 2, btnH);
+    aboutButton     .setBounds (2,                       btnAreaY, fifth,     btnH);
+    mappingButton   .setBounds (2 + fifth + 2,           btnAreaY, fifth,     btnH);
+    expressionButton.setBounds (2 + 2 * (fifth + 2),     btnAreaY, fifth,     btnH);
+    outputButton    .setBounds (2 + 3 * (fifth + 2),     btnAreaY, fifth,     btnH);
+    monitorButton   .setBounds (2 + 4 * (fifth + 2),     btnAreaY, fifth + 2, btnH);
 }
 
 //==============================================================================
@@ -408,6 +516,8 @@ void StraDellaMIDI_pluginAudioProcessorEditor::globalFocusChanged (juce::Compone
 //==============================================================================
 void StraDellaMIDI_pluginAudioProcessorEditor::mouseDown (const juce::MouseEvent& e)
 {
+    const auto ticks = juce::Time::getHighResolutionTicks();
+
     // In Focus mode the grid is driven exclusively by the computer keyboard.
     // Mouse clicks on the grid are suppressed to prevent the double-trigger
     // stuck-note scenario (mouse + keyboard pressing the same cell).
@@ -418,25 +528,12 @@ void StraDellaMIDI_pluginAudioProcessorEditor::mouseDown (const juce::MouseEvent
     hitTest (e.getPosition(), row, col);
 
     if (row >= 0)
-    {
-        pressedRow = row;
-        pressedCol = col;
-        const bool leftDown  = e.mods.isLeftButtonDown();
-        const bool rightDown = e.mods.isRightButtonDown();
-        audioProcessor.buttonPressed (row, col, mouseExpression.getCurrentNoteVelocity(),
-                                      leftDown, rightDown);
-        repaint();
-    }
+        gridInput.mouseDown (row, col, e.mods.isLeftButtonDown(), e.mods.isRightButtonDown(), ticks);
 }
 
 void StraDellaMIDI_pluginAudioProcessorEditor::mouseUp (const juce::MouseEvent& /*e*/)
 {
-    if (pressedRow >= 0)
-    {
-        audioProcessor.buttonReleased (pressedRow, pressedCol);
-        pressedRow = pressedCol = -1;
-        repaint();
-    }
+    gridInput.mouseUp (juce::Time::getHighResolutionTicks());
 }
 
 //==============================================================================
@@ -444,23 +541,17 @@ bool StraDellaMIDI_pluginAudioProcessorEditor::keyPressed (const juce::KeyPress&
 {
     const int keyCode = key.getKeyCode();
 
-    // Ignore auto-repeated key events (key already active).
-    if (activeKeyRow.contains (keyCode))
-        return true;
-
-    int row, col;
-    if (keyboardMapper.getButtonCoords (keyCode, row, col))
+    // Escape leaves Focus mode (the overlay forwards its keys here).
+    if (focusActive && key == juce::KeyPress::escapeKey)
     {
-        activeKeyRow.set (keyCode, row);
-        activeKeyCol.set (keyCode, col);
-        keyboardPressedGrid[row][col] = true;
-        auto mods = juce::ModifierKeys::getCurrentModifiers();
-        audioProcessor.buttonPressed (row, col, mouseExpression.getCurrentNoteVelocity(),
-                                      mods.isLeftButtonDown(), mods.isRightButtonDown());
-        repaint();
+        focusButton.triggerClick();
         return true;
     }
-    return false;
+
+    const auto mods = juce::ModifierKeys::getCurrentModifiers();
+
+    return gridInput.keyPressed (keyCode, mods.isLeftButtonDown(), mods.isRightButtonDown(),
+                                 juce::Time::getHighResolutionTicks());
 }
 
 bool StraDellaMIDI_pluginAudioProcessorEditor::keyStateChanged (bool isKeyDown)
@@ -468,26 +559,8 @@ bool StraDellaMIDI_pluginAudioProcessorEditor::keyStateChanged (bool isKeyDown)
     if (isKeyDown)
         return false;   // key-down events are handled by keyPressed()
 
-    // A key was released — find any active keyboard buttons that are no longer held.
-    juce::Array<int> toRelease;
-    for (auto it = activeKeyRow.begin(); it != activeKeyRow.end(); ++it)
-        if (!juce::KeyPress::isKeyCurrentlyDown (it.getKey()))
-            toRelease.add (it.getKey());
-
-    for (int keyCode : toRelease)
-    {
-        const int row = activeKeyRow[keyCode];
-        const int col = activeKeyCol[keyCode];
-        audioProcessor.buttonReleased (row, col);
-        keyboardPressedGrid[row][col] = false;
-        activeKeyRow.remove (keyCode);
-        activeKeyCol.remove (keyCode);
-    }
-
-    if (!toRelease.isEmpty())
-    {
-        repaint();
-        return true;
-    }
-    return false;
+    // A key was released — the engine polls only the keys it holds.
+    const int released = gridInput.keysReleased (juce::Time::getHighResolutionTicks(),
+                                                 [] (int keyCode) { return juce::KeyPress::isKeyCurrentlyDown (keyCode); });
+    return released > 0;
 }
@@ -10,6 +10,7 @@
 
     Keyboard input is handled by StradellaKeyboardMapper, which maps rows of
     computer keyboard keys to accordion rows (third, bass, major, minor).
+    The mapping file is watched and reloaded while the editor is open.
 
   ==============================================================================
 */
@@ -22,6 +23,11 @@
 #include "MouseMidiExpression.h"
 #include "MouseMidiSettingsWindow.h"
 #include "MappingSettingsWindow.h"
+#include "OutputSettingsWindow.h"
+#include "MidiMonitorWindow.h"
+#include "FocusCaptureOverlay.h"
+#include "GridInputController.h"
+#include "KeyboardMappingWatcher.h"
 
 //==============================================================================
 class StraDellaMIDI_pluginAudioProcessorEditor  : public juce::AudioProcessorEditor,
@@ -52,40 +58,63 @@ private:
 
     // Visual appearance helpers
     juce::Colour rowColour (int row, bool pressed) const;
+    bool         isCellPressed (int row, int col) const;
 
-    //==============================================================================
-    StraDellaMIDI_pluginAudioProcessor& audioProcessor;
+    // Cached-layer rendering: the static layer (title, labels, unpressed
+    // buttons) and one pressed sprite per cell are rasterised once per display
+    // scale; paint() only blits them.  Press changes repaint single cells.
+    void drawButton      (juce::Graphics& g, int row, int col, bool pressed,
+                          juce::Rectangle<int> area) const;
+    void drawStaticLayer (juce::Graphics& g, int uiW, int uiH) const;
+    void renderCaches    (float scale, int uiW, int uiH);
+    void repaintCell     (int row, int col);
 
-    // Track which button (if any) is currently held by the mouse.
-    int pressedRow { -1 };
-    int pressedCol { -1 };
+    // Display-refresh-synced view of the processor's held cells / expression.
+    juce::Rectangle<int> expressionMeterBounds() const;
+    void                 updateFromProcessor();
 
-    // Keyboard input: maps computer key codes to their active grid cell.
-    StradellaKeyboardMapper keyboardMapper;
-    juce::HashMap<int, int> activeKeyRow;   ///< keyCode → plugin row
-    juce::HashMap<int, int> activeKeyCol;   ///< keyCode → plugin column
+    //==============================================================================
+    StraDellaMIDI_pluginAudioProcessor& audioProcessor;
 
     // Mouse MIDI expression (accordion bellows emulation)
     MouseMidiExpression mouseExpression;
 
-    // Highlight grid cells that are currently triggered by the keyboard.
-    bool keyboardPressedGrid[StraDellaMIDI_pluginAudioProcessor::NUM_ROWS]
-                            [StraDellaMIDI_pluginAudioProcessor::NUM_COLUMNS] {};
+    // Mouse-held cell, keyboard engine, bellows retrigger and input recording.
+    GridInputController gridInput { audioProcessor, mouseExpression };
+
+    // Keyboard input: key → cell comes from the mapping file, reloaded when it
+    // changes (built-in mapping until the first load, or without a file).
+    KeyboardMappingWatcher mappingWatcher { gridInput };
+
+    // Processor state as last drawn; refreshed once per vblank.
+    UiSnapshot            displayedState;
+    juce::VBlankAttachment vblankAttachment { this, [this] { updateFromProcessor(); } };
 
     // Bottom action buttons
     juce::TextButton aboutButton      { "About" };
     juce::TextButton mappingButton    { "Mapping" };
     juce::TextButton expressionButton { "Expression" };
+    juce::TextButton outputButton     { "Output" };
+    juce::TextButton monitorButton    { "Monitor" };
+
+    // The open MIDI monitor, if any (it owns itself; closed with the editor).
+    juce::Component::SafePointer<juce::DialogWindow> monitorDialog;
 
     // Top action buttons
     juce::TextButton focusButton { "Focus" };   ///< toggle – captures keyboard & mouse focus
     juce::TextButton panicButton { "!" };       ///< sends All Notes Off on all channels
     bool             focusActive { false };     ///< mirrors focusButton toggle state
 
-    // Original plugin size stored when Focus mode expands the window to fill screen.
-    // Zero when not in full-screen focus mode.
-    int originalWidth  { 0 };
-    int originalHeight { 0 };
+    // Cached layers (see renderCaches()).  cacheScale == 0 forces a rebuild.
+    juce::Image staticLayerCache;
+    juce::Image pressedSprites[StraDellaMIDI_pluginAudioProcessor::NUM_ROWS]
+                              [StraDellaMIDI_pluginAudioProcessor::NUM_COLUMNS];
+    float cacheScale  { 0.0f };
+    int   cacheWidth  { 0 };
+    int   cacheHeight { 0 };
+
+    // Screen-sized input-capture window shown behind the editor in Focus mode.
+    std::unique_ptr<FocusCaptureOverlay> focusOverlay;
 
     // Layout constants (pixels)
     static constexpr int kTitleH    = 55;   // branding / title area height
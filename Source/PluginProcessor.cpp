@@ -9,6 +9,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "AsyncLogger.h"
 
 //==============================================================================
 // Stradella bass layout data
@@ -60,21 +61,91 @@ namespace
         "Third", "Bass", "Major", "Minor"
     };
 
+    // The register a host program change selects, or -1 for any other event.
+    static int registerProgramChange (const juce::uint8* data, int numBytes)
+    {
+        return numBytes == 2 && (data[0] & 0xf0) == 0xc0 && data[1] < BassRegisters::kNumRegisters
+                 ? (int) data[1] : -1;
+    }
+
+    // Whether a host input event is forwarded under the given thru mode.
+    static bool passesThru (const juce::uint8* data, int numBytes,
+                            StraDellaMIDI_pluginAudioProcessor::ThruMode mode)
+    {
+        using ThruMode = StraDellaMIDI_pluginAudioProcessor::ThruMode;
+
+        if (mode == ThruMode::filterAll)
+            return false;
+
+        if (mode == ThruMode::filterNotes && numBytes == 3)
+        {
+            const auto status = data[0] & 0xf0;
+            return status != 0x80 && status != 0x90;
+        }
+
+        return true;
+    }
+
     // Move the lowest note up an octave for each inversion step.
     // Notes array must be in ascending order on entry (always true for our chords:
     // we build them as [base, base+3/4, base+7, base+10, base+14] in that order).
     // After adding notes[0]+12 (always > notes.back() for standard chord intervals
     // of ≤14 semitones) and removing notes[0], the array stays sorted.
-    static void applyInversion (juce::Array<int>& notes, int inversion)
+    static void applyInversion (int* notes, int numNotes, int inversion)
     {
         jassert (inversion >= 0 && inversion <= 2);
-        for (int i = 0; i < inversion; ++i)
+        for (int i = 0; i < inversion && numNotes >= 2; ++i)
         {
-            if (notes.size() < 2) break;
             // notes[0] + 12 always lands above the existing highest note because
             // the widest interval in our chords (root → 9th) is only 14 semitones.
-            notes.add (notes[0] + 12);
-            notes.remove (0);
+            const int lowest = notes[0];
+            std::memmove (notes, notes + 1, sizeof (int) * (size_t) (numNotes - 1));
+            notes[numNotes - 1] = lowest + 12;
+        }
+    }
+
+    // Fixed-size core of buildButtonNotes(): writes the cell's notes to `out`
+    // in ascending order and returns how many.  Does not allocate, so
+    // processBlock uses it too.
+    static int buildCellNotes (const VoicingSettings& v, int row, int col,
+                               bool leftMouseDown, bool rightMouseDown,
+                               int inversion, int octShift,
+                               int (&out)[StraDellaMIDI_pluginAudioProcessor::kMaxCellNotes])
+    {
+        using Proc = StraDellaMIDI_pluginAudioProcessor;
+        const int root = kRootNotes[col];
+
+        switch (row)
+        {
+            case Proc::COUNTERBASS:
+                out[0] = root + 4 + octShift;
+                return 1;
+
+            case Proc::BASS:
+                out[0] = root + octShift;
+                return 1;
+
+            case Proc::MAJOR:
+            case Proc::MINOR:
+            {
+                const bool minor    = row == Proc::MINOR;
+                const int  base     = root + 12 + octShift;
+                const bool addSev   = leftMouseDown  && (minor ? v.minorLeftMouseAdds7  : v.majorLeftMouseAdds7);
+                const bool addNinth = rightMouseDown && (minor ? v.minorRightMouseAdds9 : v.majorRightMouseAdds9);
+
+                int n = 0;
+                out[n++] = base;
+                out[n++] = base + (minor ? 3 : 4);   // minor / major 3rd
+                out[n++] = base + 7;                 // perfect 5th
+                if (addSev)   out[n++] = base + 10;  // minor 7th  → dominant 7 / minor 7
+                if (addNinth) out[n++] = base + 14;  // major 9th
+
+                applyInversion (out, n, inversion);
+                return n;
+            }
+
+            default:
+                return 0;
         }
     }
 }
@@ -111,78 +182,624 @@ juce::String StraDellaMIDI_pluginAudioProcessor::getThirdNoteName (int col)
 //   right mouse down → adds the major 9th when the setting is enabled
 juce::Array<int> StraDellaMIDI_pluginAudioProcessor::getNotesForButton (
         int row, int col, bool leftMouseDown, bool rightMouseDown) const
+{
+    jassert (row >= 0 && row < NUM_ROWS);
+
+    const int inversion = row == MAJOR ? voicingSettings.majorInversion
+                        : row == MINOR ? voicingSettings.minorInversion
+                                       : 0;
+
+    return buildButtonNotes (row, col, leftMouseDown, rightMouseDown,
+                             inversion, voicingSettings.octaveOffset[row] * 12);
+}
+
+juce::Array<int> StraDellaMIDI_pluginAudioProcessor::buildButtonNotes (
+        int row, int col, bool leftMouseDown, bool rightMouseDown,
+        int inversion, int octShift) const
 {
     jassert (col >= 0 && col < NUM_COLUMNS);
     jassert (row >= 0 && row < NUM_ROWS);
 
-    const int root      = kRootNotes[col];
-    const int octShift  = voicingSettings.octaveOffset[row] * 12;
+    int notes[kMaxCellNotes];
+    const int numNotes = buildCellNotes (voicingSettings, row, col, leftMouseDown, rightMouseDown,
+                                         inversion, octShift, notes);
+    return juce::Array<int> (notes, numNotes);
+}
+
+// Picks the voicing of this chord closest to the previous chord (one table
+// lookup) and remembers it for the next press.  Called with messageLock held.
+juce::Array<int> StraDellaMIDI_pluginAudioProcessor::getVoiceLedNotes (
+        int row, int col, bool leftMouseDown, bool rightMouseDown)
+{
+    const auto& v = chooseVoiceLedVoicing (row, col);
+
+    return buildButtonNotes (row, col, leftMouseDown, rightMouseDown,
+                             v.inversion, v.octaveShift * 12);
+}
+
+const VoiceLeadingTable::Voicing& StraDellaMIDI_pluginAudioProcessor::chooseVoiceLedVoicing (int row, int col)
+{
+    jassert (row == MAJOR || row == MINOR);
+
+    const int chord      = VoiceLeadingTable::chordIndex (row == MINOR, col);
+    const int defaultInv = row == MAJOR ? voicingSettings.majorInversion
+                                        : voicingSettings.minorInversion;
 
-    switch (row)
+    lastChordVoicing = voiceLeading.chooseVoicing (lastChordVoicing, chord, defaultInv);
+    return voiceLeading.getVoicing (lastChordVoicing);
+}
+
+//==============================================================================
+// Re-voicing of held cells.  A cell's voicing is recomputed from what it was
+// pressed with (buttons, velocity, the auto-inversion choice) and the current
+// settings; the difference to what it sounds is sent as note-offs and
+// note-ons, without a roll.  All called with messageLock held.
+NoteMask StraDellaMIDI_pluginAudioProcessor::heldCellNotesLocked (int row, int col, const HeldVoicing& held) const
+{
+    const int inversion   = held.voiceLed ? held.inversion
+                          : row == MAJOR  ? voicingSettings.majorInversion
+                          : row == MINOR  ? voicingSettings.minorInversion
+                                          : 0;
+    const int octaveShift = held.voiceLed ? held.octaveShift : voicingSettings.octaveOffset[row];
+
+    int notes[kMaxCellNotes];
+    const int numNotes = buildCellNotes (voicingSettings, row, col, held.leftMouseDown, held.rightMouseDown,
+                                         inversion, octaveShift * 12, notes);
+
+    NoteMask mask;
+    for (int i = 0; i < numNotes; ++i)
+        mask.set (juce::jlimit (0, 127, notes[i]));
+
+    return bassRegisters.expand (bassRegister, row, mask);
+}
+
+void StraDellaMIDI_pluginAudioProcessor::revoiceHeldCellLocked (int row, int col, HeldVoicing& held)
+{
+    const auto next = heldCellNotesLocked (row, col, held);
+    if (next == held.notes)
+        return;
+
+    const int cell = cellIndex (row, col);
+
+    held.notes.without (next).forEach ([this] (int note)
+    {
+        cellNoteOffLocked (note);
+    });
+
+    next.without (held.notes).forEach ([this, &held, cell] (int note)
     {
-        case COUNTERBASS:
-            return { root + 4 + octShift };
+        cellNoteOnLocked (juce::MidiMessage::noteOn (1, note, held.velocity), cell);
+    });
 
-        case BASS:
-            return { root + octShift };
+    held.notes = next;
+}
+
+void StraDellaMIDI_pluginAudioProcessor::revoiceHeldCellsLocked (bool followMouseButtons)
+{
+    int keys[NUM_ROWS * NUM_COLUMNS];
+    int numKeys = 0;
+
+    for (juce::HashMap<int, HeldVoicing>::Iterator it (activeNotes); it.next() && numKeys < NUM_ROWS * NUM_COLUMNS;)
+        keys[numKeys++] = it.getKey();
 
-        case MAJOR:
+    for (int i = 0; i < numKeys; ++i)
+    {
+        const int row = keys[i] / 1000;
+        const int col = keys[i] % 1000;
+        auto held = activeNotes[keys[i]];
+
+        if (followMouseButtons && (row == MAJOR || row == MINOR))
         {
-            const int base       = root + 12 + octShift;
-            const bool addSev    = leftMouseDown  && voicingSettings.majorLeftMouseAdds7;
-            const bool addNinth  = rightMouseDown && voicingSettings.majorRightMouseAdds9;
-
-            juce::Array<int> notes;
-            notes.add (base);
-            notes.add (base + 4);   // major 3rd
-            notes.add (base + 7);   // perfect 5th
-            if (addSev)   notes.add (base + 10);  // minor 7th  → dominant 7
-            if (addNinth) notes.add (base + 14);  // major 9th
-
-            applyInversion (notes, voicingSettings.majorInversion);
-            return notes;
+            held.leftMouseDown  = heldLeftMouseDown;
+            held.rightMouseDown = heldRightMouseDown;
         }
 
-        case MINOR:
+        revoiceHeldCellLocked (row, col, held);
+        activeNotes.set (keys[i], held);
+    }
+}
+
+// Pattern mode: the chord source follows a button or voicing change from its
+// next step.
+void StraDellaMIDI_pluginAudioProcessor::refreshPatternChordLocked()
+{
+    if (isPatternActive() && patternChordKey >= 0)
+    {
+        const int  row       = patternChordKey / 1000;
+        const int  col       = patternChordKey % 1000;
+        const bool voiceLead = voicingSettings.autoInversion;
+
+        setPatternChordLocked (voiceLead ? getVoiceLedNotes  (row, col, heldLeftMouseDown, heldRightMouseDown)
+                                         : getNotesForButton (row, col, heldLeftMouseDown, heldRightMouseDown),
+                               patternChordKey);
+    }
+}
+
+void StraDellaMIDI_pluginAudioProcessor::setMouseButtons (bool leftMouseDown, bool rightMouseDown,
+                                                          juce::int64 ticks)
+{
+    const juce::ScopedLock sl (messageLock);
+
+    if (leftMouseDown == heldLeftMouseDown && rightMouseDown == heldRightMouseDown)
+        return;
+
+    heldLeftMouseDown  = leftMouseDown;
+    heldRightMouseDown = rightMouseDown;
+    currentInputTicks  = ticks != 0 ? ticks : juce::Time::getHighResolutionTicks();
+    revoiceHeldCellsLocked (true);
+    refreshPatternChordLocked();
+}
+
+//==============================================================================
+void StraDellaMIDI_pluginAudioProcessor::setBassRegister (int index)
+{
+    const auto inputTicks = juce::Time::getHighResolutionTicks();
+    index = juce::jlimit (0, BassRegisters::kNumRegisters - 1, index);
+
+    // Keeps the host's view of the parameter in step; processBlock then sees
+    // no change to apply.
+    *registerParameter = index;
+
+    const juce::ScopedLock sl (messageLock);
+    currentInputTicks = inputTicks;
+    applyBassRegisterLocked (index);
+}
+
+// Message thread: applies the register a host program change selected (see
+// processBlock) or the host automated.
+void StraDellaMIDI_pluginAudioProcessor::timerCallback()
+{
+    if (const int index = programRegister.exchange (-1); index >= 0)
+    {
+        setBassRegister (index);
+        return;
+    }
+
+    const int index = registerParameter->getIndex();
+
+    const juce::ScopedLock sl (messageLock);
+    if (index != bassRegister)
+    {
+        currentInputTicks = juce::Time::getHighResolutionTicks();
+        applyBassRegisterLocked (index);
+    }
+}
+
+int StraDellaMIDI_pluginAudioProcessor::getBassRegister() const
+{
+    const juce::ScopedLock sl (messageLock);
+    return bassRegister;
+}
+
+void StraDellaMIDI_pluginAudioProcessor::setBassRegisterOctaves (int index, const BassRegisters::Register& r)
+{
+    const juce::ScopedLock sl (messageLock);
+    bassRegisters.setRegister (index, r);
+
+    if (index == bassRegister)
+        revoiceHeldCellsLocked (false);
+}
+
+BassRegisters::Register StraDellaMIDI_pluginAudioProcessor::getBassRegisterOctaves (int index) const
+{
+    const juce::ScopedLock sl (messageLock);
+    return bassRegisters.getRegister (index);
+}
+
+void StraDellaMIDI_pluginAudioProcessor::applyBassRegisterLocked (int index)
+{
+    if (index == bassRegister)
+        return;
+
+    bassRegister = index;
+    revoiceHeldCellsLocked (false);
+}
+
+int StraDellaMIDI_pluginAudioProcessor::getCurrentProgram()
+{
+    return getBassRegister();
+}
+
+void StraDellaMIDI_pluginAudioProcessor::setCurrentProgram (int index)
+{
+    setBassRegister (index);
+}
+
+const juce::String StraDellaMIDI_pluginAudioProcessor::getProgramName (int index)
+{
+    return BassRegisters::getName (index);
+}
+
+void StraDellaMIDI_pluginAudioProcessor::setVoicingSettings (const VoicingSettings& s)
+{
+    const juce::ScopedLock sl (messageLock);
+    setVoicingSettingsLocked (s);
+}
+
+VoicingSettings StraDellaMIDI_pluginAudioProcessor::getVoicingSettings() const
+{
+    const juce::ScopedLock sl (messageLock);
+    return voicingSettings;
+}
+
+void StraDellaMIDI_pluginAudioProcessor::setVoicingSettingsLocked (const VoicingSettings& s)
+{
+    // Voicing indices are only meaningful for the range they were built for.
+    if (s.autoInversionLowNote != voiceLeading.getRangeLowNote())
+    {
+        voiceLeading.build (kRootNotes, s.autoInversionLowNote);
+        lastChordVoicing = -1;
+    }
+
+    voicingSettings = s;
+    revoiceHeldCellsLocked (false);
+    refreshPatternChordLocked();
+}
+
+void StraDellaMIDI_pluginAudioProcessor::beginInputSession (juce::int64 randomSeed)
+{
+    const juce::ScopedLock sl (messageLock);
+    lastChordVoicing = -1;
+    strumRandom.setSeed (randomSeed);
+}
+
+//==============================================================================
+void StraDellaMIDI_pluginAudioProcessor::setPatternSettings (const BassPatternEngine::Settings& s)
+{
+    const juce::ScopedLock sl (messageLock);
+
+    // Cells held across an on/off switch belong to the other mode: their
+    // direct notes are released normally and they are not picked up as sources.
+    const bool wasActive = isPatternActive();
+    patternSettings = s;
+    if (wasActive != isPatternActive())
+        clearPatternSourcesLocked();
+}
+
+BassPatternEngine::Settings StraDellaMIDI_pluginAudioProcessor::getPatternSettings() const
+{
+    const juce::ScopedLock sl (messageLock);
+    return patternSettings;
+}
+
+void StraDellaMIDI_pluginAudioProcessor::setThruMode (ThruMode mode)
+{
+    const juce::ScopedLock sl (messageLock);
+    thruMode = mode;
+}
+
+StraDellaMIDI_pluginAudioProcessor::ThruMode StraDellaMIDI_pluginAudioProcessor::getThruMode() const
+{
+    const juce::ScopedLock sl (messageLock);
+    return thruMode;
+}
+
+void StraDellaMIDI_pluginAudioProcessor::setChordInputMode (ChordInputMode mode)
+{
+    const juce::ScopedLock sl (messageLock);
+    chordInputMode = mode;
+}
+
+StraDellaMIDI_pluginAudioProcessor::ChordInputMode StraDellaMIDI_pluginAudioProcessor::getChordInputMode() const
+{
+    const juce::ScopedLock sl (messageLock);
+    return chordInputMode;
+}
+
+ChordRecognizer::Chord StraDellaMIDI_pluginAudioProcessor::getRecognizedChord() const noexcept
+{
+    const auto word = recognizedChordWord.load (std::memory_order_acquire);
+
+    ChordRecognizer::Chord c;
+    c.root    = (juce::int8) (word & 0xff);
+    c.quality = (ChordRecognizer::Quality) ((word >> 8) & 0xff);
+    c.bass    = (juce::int8) ((word >> 16) & 0xff);
+    return c;
+}
+
+void StraDellaMIDI_pluginAudioProcessor::publishRecognizedChord() noexcept
+{
+    const auto c = lastChordInputMode != ChordInputMode::off ? chordRecognizer.getChord()
+                                                             : ChordRecognizer::Chord();
+    recognizedChordWord.store ((juce::uint32) (juce::uint8) c.root
+                                 | ((juce::uint32) c.quality << 8)
+                                 | ((juce::uint32) (juce::uint8) c.bass << 16),
+                               std::memory_order_release);
+}
+
+// Replaces the sounding revoiced notes with the recognized chord's cells:
+// the bass cell as pressed, the chord cell with the 7th/9th "mouse buttons"
+// its quality needs, at the fixed inversion (no auto inversion or roll, which
+// belong to the press path).  Audio thread; does not allocate.
+void StraDellaMIDI_pluginAudioProcessor::revoiceRecognizedChord (const VoicingSettings& voicing,
+                                                                 int sampleOffset) noexcept
+{
+    releaseRevoicedNotes (sampleOffset);
+
+    const auto cells    = chordRecognizer.toCells (chordRecognizer.getChord());
+    const auto velocity = (juce::uint8) juce::jlimit (1, 127, revoiceVelocity);
+
+    auto play = [&] (int row, int col, bool seventh, bool ninth, int inversion, int priority)
+    {
+        int notes[kMaxCellNotes];
+        const int numNotes = buildCellNotes (voicing, row, col, seventh, ninth, inversion,
+                                             voicing.octaveOffset[row] * 12, notes);
+
+        for (int i = 0; i < numNotes; ++i)
         {
-            const int base       = root + 12 + octShift;
-            const bool addSev    = leftMouseDown  && voicingSettings.minorLeftMouseAdds7;
-            const bool addNinth  = rightMouseDown && voicingSettings.minorRightMouseAdds9;
-
-            juce::Array<int> notes;
-            notes.add (base);
-            notes.add (base + 3);   // minor 3rd
-            notes.add (base + 7);   // perfect 5th
-            if (addSev)   notes.add (base + 10);  // minor 7th
-            if (addNinth) notes.add (base + 14);  // major 9th
-
-            applyInversion (notes, voicingSettings.minorInversion);
-            return notes;
+            const auto       note = (juce::uint8) juce::jlimit (0, 127, notes[i]);
+            const juce::uint8 on[] = { 0x90, note, velocity };
+
+            if (generatedEvents.add (on, 3, sampleOffset, priority))
+                revoicedNotes[numRevoicedNotes++] = note;
         }
+    };
+
+    if (cells.bassRow >= 0)
+        play (cells.bassRow, cells.bassCol, false, false, 0, cells.bassRow == BASS ? 3 : 2);
+
+    if (cells.chordRow >= 0)
+        play (cells.chordRow, cells.chordCol, cells.seventh, cells.ninth,
+              cells.chordRow == MAJOR ? voicing.majorInversion : voicing.minorInversion, 1);
+}
 
-        default:
-            return {};
+void StraDellaMIDI_pluginAudioProcessor::releaseRevoicedNotes (int sampleOffset) noexcept
+{
+    for (int i = 0; i < numRevoicedNotes; ++i)
+    {
+        const juce::uint8 off[] = { 0x80, (juce::uint8) revoicedNotes[i], 0 };
+        generatedEvents.add (off, 3, sampleOffset);
     }
+
+    numRevoicedNotes = 0;
+}
+
+// Thru filtering for one host event, remembering which note-ons went out so
+// their note-offs always follow.  Audio thread.
+bool StraDellaMIDI_pluginAudioProcessor::passHostEvent (const juce::uint8* data, int numBytes,
+                                                        ThruMode thru) noexcept
+{
+    const bool passes = passesThru (data, numBytes, thru);
+
+    if (numBytes != 3)
+        return passes;
+
+    const auto status = data[0] & 0xf0;
+    auto&      counts = hostNotesForwarded[data[0] & 0x0f];
+    auto&      count  = counts[data[1] & 0x7f];
+
+    if (status == 0x90 && data[2] > 0)
+    {
+        if (passes && count < 255)
+            ++count;
+
+        return passes;
+    }
+
+    if (status == 0x80 || status == 0x90)
+    {
+        if (count == 0)
+            return passes;
+
+        --count;
+        return true;
+    }
+
+    // All Sound Off / All Notes Off that goes out ends them all.
+    if (passes && status == 0xb0 && (data[1] == 120 || data[1] == 123))
+        std::memset (counts, 0, sizeof (counts));
+
+    return passes;
+}
+
+void StraDellaMIDI_pluginAudioProcessor::setVoiceLimiterSettings (const VoiceLimiter::Settings& s)
+{
+    const juce::ScopedLock sl (messageLock);
+    voiceLimiterSettings = s;
+}
+
+VoiceLimiter::Settings StraDellaMIDI_pluginAudioProcessor::getVoiceLimiterSettings() const
+{
+    const juce::ScopedLock sl (messageLock);
+    return voiceLimiterSettings;
+}
+
+void StraDellaMIDI_pluginAudioProcessor::setModulationSettings (const ModulationMatrix::Settings& s)
+{
+    const juce::ScopedLock sl (messageLock);
+    if (s != modulationSettings)
+    {
+        modulationSettings = s;
+        modulationChanged  = true;
+    }
+}
+
+// Message thread, every pointer sample.  Pointer Y also drives the editor's
+// bellows meter.
+void StraDellaMIDI_pluginAudioProcessor::setModulationSources (float pointerY, float bellowsSpeed)
+{
+    modulationMatrix.setPointerSources (pointerY, bellowsSpeed);
+
+    const int level = juce::roundToInt (juce::jlimit (0.0f, 1.0f, pointerY) * 127.0f);
+
+    const juce::ScopedLock sl (messageLock);
+    if (level != heldState.expression)
+    {
+        heldState.expression = level;
+        publishUiSnapshot();
+    }
+}
+
+ModulationMatrix::Settings StraDellaMIDI_pluginAudioProcessor::getModulationSettings() const
+{
+    const juce::ScopedLock sl (messageLock);
+    return modulationSettings;
+}
+
+void StraDellaMIDI_pluginAudioProcessor::setPendingMaxAgeMs (int ms)
+{
+    const juce::ScopedLock sl (messageLock);
+    pendingQueue.setMaxAgeMs (ms);
+}
+
+int StraDellaMIDI_pluginAudioProcessor::getPendingMaxAgeMs() const
+{
+    const juce::ScopedLock sl (messageLock);
+    return pendingQueue.getMaxAgeMs();
+}
+
+// Bass outranks counterbass, which outranks chord tones; the 7th and 9th
+// extensions are the first to go when the limiter has to steal.
+int StraDellaMIDI_pluginAudioProcessor::voicePriority (int row, int col, int note) noexcept
+{
+    if (row == BASS)        return 3;
+    if (row == COUNTERBASS) return 2;
+
+    const int interval = ((note - kRootNotes[col]) % 12 + 12) % 12;
+    return (interval == 10 || interval == 2) ? 0 : 1;
+}
+
+int StraDellaMIDI_pluginAudioProcessor::cellVoicePriority (int cell, int note) noexcept
+{
+    return juce::isPositiveAndBelow (cell, NUM_ROWS * NUM_COLUMNS)
+               ? voicePriority (cell / NUM_COLUMNS, cell % NUM_COLUMNS, note)
+               : VoiceLimiter::kDefaultPriority;
+}
+
+// The pattern helpers below are all called with messageLock held.
+void StraDellaMIDI_pluginAudioProcessor::setPatternBassLocked (int row, int col)
+{
+    // The counterbass step plays the other single-note row of the same column.
+    const int other = row == BASS ? COUNTERBASS : BASS;
+    patternSources.bass    = getNotesForButton (row,   col)[0];
+    patternSources.altBass = getNotesForButton (other, col)[0];
+    patternBassKey = row * 1000 + col;
+
+    patternSources.bassPriority    = voicePriority (row,   col, patternSources.bass);
+    patternSources.altBassPriority = voicePriority (other, col, patternSources.altBass);
+}
+
+void StraDellaMIDI_pluginAudioProcessor::setPatternChordLocked (const juce::Array<int>& notes, int key)
+{
+    patternSources.numChord = juce::jmin (notes.size(), BassPatternEngine::Sources::kMaxChordNotes);
+    for (int i = 0; i < patternSources.numChord; ++i)
+    {
+        patternSources.chord[i]         = notes[i];
+        patternSources.chordPriority[i] = voicePriority (key / 1000, key % 1000, notes[i]);
+    }
+    patternChordKey = key;
+}
+
+void StraDellaMIDI_pluginAudioProcessor::patternCellReleasedLocked (int row, int col)
+{
+    const int key = row * 1000 + col;
+
+    // A released source falls back to another held cell of the same kind that
+    // was pressed in pattern mode (such cells have no direct notes).
+    auto findHeld = [this] (int firstRow, int secondRow, int& outRow, int& outCol)
+    {
+        for (int r : { firstRow, secondRow })
+            for (int c = 0; c < NUM_COLUMNS; ++c)
+                if (heldState.isHeld (r, c) && ! activeNotes.contains (r * 1000 + c))
+                {
+                    outRow = r;
+                    outCol = c;
+                    return true;
+                }
+        return false;
+    };
+
+    int r = 0, c = 0;
+
+    if (key == patternBassKey)
+    {
+        patternSources.bass    = -1;
+        patternSources.altBass = -1;
+        patternBassKey         = -1;
+
+        if (findHeld (BASS, COUNTERBASS, r, c))
+            setPatternBassLocked (r, c);
+    }
+    else if (key == patternChordKey)
+    {
+        patternSources.numChord = 0;
+        patternChordKey         = -1;
+
+        if (findHeld (MAJOR, MINOR, r, c))
+            setPatternChordLocked (getNotesForButton (r, c), r * 1000 + c);
+    }
+}
+
+void StraDellaMIDI_pluginAudioProcessor::clearPatternSourcesLocked()
+{
+    patternSources  = {};
+    patternBassKey  = -1;
+    patternChordKey = -1;
 }
 
 //==============================================================================
 StraDellaMIDI_pluginAudioProcessor::StraDellaMIDI_pluginAudioProcessor()
     : AudioProcessor (BusesProperties())   // MIDI effect – no audio buses
 {
+    voiceLeading.build (kRootNotes, voicingSettings.autoInversionLowNote);
+    chordRecognizer.build (kRootNotes);
+    pendingQueue.setMaxAgeMs (500);
+
+    juce::StringArray registerNames;
+    for (int i = 0; i < BassRegisters::kNumRegisters; ++i)
+        registerNames.add (BassRegisters::getName (i));
+
+    addParameter (registerParameter = new juce::AudioParameterChoice (juce::ParameterID { "register", 1 },
+                                                                      "Bass register", registerNames, 0));
+
+    // Picks up register automation and host program changes (at most one
+    // tick late, well under a beat).
+    startTimerHz (50);
+
+   #if STRADELLA_ASYNC_LOGGING
+    AsyncLogger::getInstance().addClient();
+   #endif
 }
 
 StraDellaMIDI_pluginAudioProcessor::~StraDellaMIDI_pluginAudioProcessor()
 {
+    stopTimer();
+
+   #if STRADELLA_ASYNC_LOGGING
+    AsyncLogger::getInstance().removeClient();
+   #endif
 }
 
 //==============================================================================
 const juce::String StraDellaMIDI_pluginAudioProcessor::getName() const
 {
+    // Console targets that build the processor (Benchmarks/) have no plugin defines.
+   #ifdef JucePlugin_Name
     return JucePlugin_Name;
+   #else
+    return "straDellaMIDI";
+   #endif
 }
 
-void StraDellaMIDI_pluginAudioProcessor::prepareToPlay (double /*sampleRate*/, int /*samplesPerBlock*/)
+void StraDellaMIDI_pluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    if (sampleRate > 0.0)
+        currentSampleRate = sampleRate;
+
+    outputTap.setSampleRate (sampleRate);
+    patternEngine.prepare (sampleRate);
+    strumWheel.reset (samplePosition);
+    voiceLimiter.reset();
+    modulationMatrix.prepare (sampleRate);
+
+    // Reserve output capacity up front: every generator at its limit, plus
+    // one steal note-off per voice and one host event per sample.
+    const int generatedCapacity = kPendingCapacity + 2 * TimingWheel::kCapacity;
+    generatedEvents.reserve (generatedCapacity);
+
+    reservedOutputBytes = (size_t) (generatedCapacity + VoiceLimiter::kMaxVoices + juce::jmax (0, samplesPerBlock))
+                            * MidiEventList::bytesPerEvent (3);
+    mergedOutput.ensureSize (reservedOutputBytes);
 }
 
 void StraDellaMIDI_pluginAudioProcessor::releaseResources()
@@ -202,14 +819,222 @@ void StraDellaMIDI_pluginAudioProcessor::processBlock (juce::AudioBuffer<float>&
     buffer.clear();
 
     // Drain pending note messages queued by the editor (UI thread).
-    juce::Array<juce::MidiMessage> incoming;
+    int                            numIncoming;
+    BassPatternEngine::Settings    pattern;
+    BassPatternEngine::Sources     sources;
+    VoiceLimiter::Settings         limiter;
+    ThruMode                       thru;
+    ChordInputMode                 chordMode;
+    VoicingSettings                voicing;
+    ModulationMatrix::Settings     modulation;
+    bool                           cellsSounding;
+    bool                           updateModulation = false;
+
+    // A program change on the host input switches the bass register (the
+    // last one in the block wins).  Host CCs and note velocities are
+    // modulation sources.
+    int programChange = -1;
+
+    for (const auto metadata : midiMessages)
+    {
+        modulationMatrix.handleInput (metadata.data, metadata.numBytes);
+
+        if (const int r = registerProgramChange (metadata.data, metadata.numBytes); r >= 0)
+            programChange = r;
+    }
+
+    // The register switch itself happens on the message thread (see
+    // timerCallback); posting a message from here would not be realtime-safe.
+    if (programChange >= 0)
+        programRegister.store (programChange);
+
     {
         const juce::ScopedLock sl (messageLock);
-        incoming.swapWith (pendingMessages);
+
+        numIncoming = pendingQueue.popAll (incomingEvents, juce::Time::getHighResolutionTicks());
+        cellsSounding = activeNotes.size() > 0;
+        pattern = patternSettings;
+        sources = patternSources;
+        limiter = voiceLimiterSettings;
+        thru    = thruMode;
+        chordMode = chordInputMode;
+        if (chordMode == ChordInputMode::revoice)
+            voicing = voicingSettings;
+
+        if (modulationChanged)
+        {
+            modulation        = modulationSettings;
+            modulationChanged = false;
+            updateModulation  = true;
+        }
     }
 
-    for (auto& msg : incoming)
-        midiMessages.addEvent (msg, 0);
+    if (updateModulation)
+        modulationMatrix.setSettings (modulation);
+
+    const double samplesPerMs = currentSampleRate / 1000.0;
+    const int    numSamples   = buffer.getNumSamples();
+
+    statDelivered.fetch_add ((juce::uint64) numIncoming, std::memory_order_relaxed);
+    if (numIncoming > statPeakDepth.load (std::memory_order_relaxed))
+        statPeakDepth.store (numIncoming, std::memory_order_relaxed);
+
+    // Everything generated this block is collected here and merged with the
+    // host input at the end.
+    generatedEvents.clear();
+
+    // Modulation matrix, once per block.  The grid's note-ons count as a
+    // velocity source before a route may replace their velocity.
+    for (int i = 0; i < numIncoming; ++i)
+        modulationMatrix.handleInput (incomingEvents[i].data, incomingEvents[i].size);
+
+    modulationMatrix.process (numSamples, curveBank.acquire(), generatedEvents);
+    const int modulatedVelocity = modulationMatrix.getNoteVelocity();
+
+    for (int i = 0; i < numIncoming; ++i)
+    {
+        // ≤ 3 bytes, so the message lives inline and nothing is allocated.
+        const auto&       e = incomingEvents[i];
+        juce::MidiMessage msg (e.data, e.size, e.delayMs);
+        bool cancelledRolledNote = false;
+
+        // The roll tilt still applies on top of a modulated velocity.
+        if (modulatedVelocity > 0 && msg.isNoteOn())
+            msg.setVelocity ((float) juce::jlimit (1, 127, modulatedVelocity + e.velocityOffset) / 127.0f);
+
+        if (msg.isNoteOn() && msg.getTimeStamp() > 0.0)
+        {
+            // Rolled chord tone: park it until its offset (or play it now if
+            // the wheel is full).
+            const auto due = samplePosition + (juce::int64) (msg.getTimeStamp() * samplesPerMs);
+            if (strumWheel.schedule (due, msg, e.cell))
+                continue;
+        }
+        else if (msg.isNoteOff() && strumWheel.getNumPending() > 0)
+        {
+            // Released before its rolled note-on was due: cancel that cell's
+            // note-on.  Another cell's roll of the same pitch is left alone.
+            const auto status = (juce::uint8) (0x90 | (msg.getChannel() - 1));
+            const auto note   = (juce::uint8) msg.getNoteNumber();
+            const auto cell   = e.cell;
+            cancelledRolledNote = strumWheel.removeIf ([=] (const TimingWheel::Event& w)
+                                                       { return w.data[0] == status && w.data[1] == note
+                                                             && w.tag == cell; }) > 0;
+        }
+        else if (msg.isAllNotesOff() || msg.isAllSoundOff())
+        {
+            strumWheel.reset (samplePosition);
+            numRevoicedNotes = 0;
+        }
+
+        trackUiNote (msg.getRawData(), msg.getRawDataSize(), cancelledRolledNote);
+        generatedEvents.add (msg, 0, cellVoicePriority (e.cell, e.data[1]));
+    }
+
+    strumWheel.popDue (samplePosition + numSamples, [&] (const TimingWheel::Event& e)
+    {
+        trackUiNote (e.data, e.size, false);
+        generatedEvents.add (e.data, e.size, (int) juce::jlimit ((juce::int64) 0, (juce::int64) numSamples - 1,
+                                                                 e.time - samplePosition),
+                             cellVoicePriority (e.tag, e.data[1]));
+    });
+
+    // Invariant: once no cell holds notes and no rolled tone is waiting, every
+    // UI note-on has been followed by its note-off.  A violation is counted
+    // in BoundaryStats::stuckNotes, not asserted, so a debug build keeps
+    // running and the stress test can report it.
+    if (! cellsSounding && strumWheel.getNumPending() == 0 && numUiNotesSounding > 0)
+    {
+        statStuck.fetch_add ((juce::uint64) numUiNotesSounding, std::memory_order_relaxed);
+        std::memset (uiNotesSounding, 0, sizeof (uiNotesSounding));
+        numUiNotesSounding = 0;
+    }
+
+    // Host input chord recognition.  Runs over the host events before the
+    // merge, so revoiced notes are sorted in with everything generated.  A
+    // mode change keeps the held chord: display shows it, revoice plays it.
+    if (chordMode != lastChordInputMode)
+    {
+        releaseRevoicedNotes (0);
+        lastChordInputMode = chordMode;
+        publishRecognizedChord();
+
+        if (chordMode == ChordInputMode::revoice)
+            revoiceRecognizedChord (voicing, 0);
+    }
+
+    for (const auto metadata : midiMessages)
+    {
+        if (metadata.numBytes == 3 && (metadata.data[0] & 0xf0) == 0x90 && metadata.data[2] > 0)
+            revoiceVelocity = metadata.data[2];
+
+        if (! chordRecognizer.handle (metadata.data, metadata.numBytes) || chordMode == ChordInputMode::off)
+            continue;
+
+        publishRecognizedChord();
+        if (chordMode == ChordInputMode::revoice)
+            revoiceRecognizedChord (voicing, metadata.samplePosition);
+    }
+
+    // The revoiced notes replace newly played ones; notes already forwarded
+    // still get their note-offs (see passHostEvent).
+    if (chordMode == ChordInputMode::revoice && thru == ThruMode::pass)
+        thru = ThruMode::filterNotes;
+
+    // Automatic bass pattern, locked to the host position when there is one.
+    juce::Optional<juce::AudioPlayHead::PositionInfo> position;
+    if (auto* playHead = getPlayHead())
+        position = playHead->getPosition();
+
+    patternEngine.process (sources, pattern, position, samplePosition,
+                           numSamples, generatedEvents);
+
+    // Merge the sorted generated events with the host input in one linear
+    // pass, appending straight into the reserved output buffer.  Thru
+    // filtering and the polyphony cap are applied in the same pass, so the
+    // limiter sees every note that leaves the plugin, in order.
+    generatedEvents.sort();
+    mergedOutput.clear();
+    voiceLimiter.beginBlock (limiter);
+
+    auto       next = generatedEvents.begin();
+    const auto last = generatedEvents.end();
+
+    for (const auto metadata : midiMessages)
+    {
+        for (; next != last && next->sampleOffset < metadata.samplePosition; ++next)
+            voiceLimiter.add (next->data, next->size, next->sampleOffset, mergedOutput, next->priority);
+
+        // A program change that switched the register was consumed above.
+        if (registerProgramChange (metadata.data, metadata.numBytes) >= 0
+             || ! passHostEvent (metadata.data, metadata.numBytes, thru))
+            continue;
+
+        if (metadata.numBytes <= 3)
+            voiceLimiter.add (metadata.data, metadata.numBytes, metadata.samplePosition, mergedOutput);
+        else
+            mergedOutput.addEvent (metadata.data, metadata.numBytes, metadata.samplePosition);
+    }
+
+    for (; next != last; ++next)
+        voiceLimiter.add (next->data, next->size, next->sampleOffset, mergedOutput, next->priority);
+
+    voiceLimiter.endBlock();
+    statDropped.store ((juce::uint64) generatedEvents.getNumDropped(), std::memory_order_relaxed);
+
+    // Hand the merged buffer to the host and keep its previous one as next
+    // block's output.  ensureSize() allocates only while the buffer we got
+    // back is smaller than the reserve: in the first blocks, or when the
+    // host hands over a new buffer.  Hosts reuse the same MidiBuffer every
+    // callback, so once both have grown the steady state does not allocate.
+    midiMessages.swapWith (mergedOutput);
+    mergedOutput.ensureSize (reservedOutputBytes);
+
+    // Copy the final output to the MIDI monitor (only while it is open).
+    if (outputTap.isEnabled())
+        outputTap.capture (midiMessages, samplePosition);
+
+    samplePosition += buffer.getNumSamples();
 }
 
 //==============================================================================
@@ -223,10 +1048,48 @@ juce::AudioProcessorEditor* StraDellaMIDI_pluginAudioProcessor::createEditor()
 //==============================================================================
 // Called from the UI thread when a stradella button is clicked.
 void StraDellaMIDI_pluginAudioProcessor::buttonPressed (int row, int col, int velocity,
-                                                         bool leftMouseDown, bool rightMouseDown)
+                                                         bool leftMouseDown, bool rightMouseDown,
+                                                         juce::int64 ticks)
 {
-    const int key = row * 1000 + col;
+    // Stamped before waiting for the lock, so the wait counts as latency.
+    const auto inputTicks = ticks != 0 ? ticks : juce::Time::getHighResolutionTicks();
+
     const juce::ScopedLock sl (messageLock);
+    currentInputTicks = inputTicks;
+    pressCellLocked (row, col, velocity, leftMouseDown, rightMouseDown);
+}
+
+void StraDellaMIDI_pluginAudioProcessor::buttonReleased (int row, int col, juce::int64 ticks)
+{
+    const auto inputTicks = ticks != 0 ? ticks : juce::Time::getHighResolutionTicks();
+
+    const juce::ScopedLock sl (messageLock);
+    currentInputTicks = inputTicks;
+    releaseCellLocked (row, col);
+}
+
+void StraDellaMIDI_pluginAudioProcessor::applyCellIntents (const CellIntent* intents, int numIntents)
+{
+    if (numIntents <= 0)
+        return;
+
+    const juce::ScopedLock sl (messageLock);
+    for (int i = 0; i < numIntents; ++i)
+    {
+        const auto& in = intents[i];
+        currentInputTicks = in.ticks != 0 ? in.ticks : juce::Time::getHighResolutionTicks();
+
+        if (in.isPress)
+            pressCellLocked (in.row, in.col, in.velocity, in.leftMouseDown, in.rightMouseDown);
+        else
+            releaseCellLocked (in.row, in.col);
+    }
+}
+
+void StraDellaMIDI_pluginAudioProcessor::pressCellLocked (int row, int col, int velocity,
+                                                           bool leftMouseDown, bool rightMouseDown)
+{
+    const int key = row * 1000 + col;
 
     // Increment reference count.  Send note-on only the first time the cell
     // is pressed (count rises from 0 → 1); subsequent presses from a second
@@ -237,18 +1100,100 @@ void StraDellaMIDI_pluginAudioProcessor::buttonPressed (int row, int col, int ve
 
     if (count == 0)
     {
-        const auto notes = getNotesForButton (row, col, leftMouseDown, rightMouseDown);
-        activeNotes.set (key, notes);
-        for (int note : notes)
-            pendingMessages.add (juce::MidiMessage::noteOn (1, juce::jlimit (0, 127, note),
-                                                            (juce::uint8) juce::jlimit (0, 127, velocity)));
+        setCellHeld (row, col, true);
+
+        const bool voiceLead = voicingSettings.autoInversion && (row == MAJOR || row == MINOR);
+
+        if (isPatternActive())
+        {
+            // No direct notes: the cell becomes a source for the next pattern step.
+            patternSources.velocity = juce::jlimit (1, 127, velocity);
+            if (row == COUNTERBASS || row == BASS)
+                setPatternBassLocked (row, col);
+            else
+                setPatternChordLocked (voiceLead ? getVoiceLedNotes  (row, col, leftMouseDown, rightMouseDown)
+                                                 : getNotesForButton (row, col, leftMouseDown, rightMouseDown),
+                                       key);
+
+            STRADELLA_LOG (AsyncLogger::Event::cellPressed, row, col, velocity, 0);
+            return;
+        }
+
+        HeldVoicing held;
+        held.velocity       = (juce::uint8) juce::jlimit (0, 127, velocity);
+        held.leftMouseDown  = leftMouseDown;
+        held.rightMouseDown = rightMouseDown;
+        held.voiceLed       = voiceLead;
+
+        if (voiceLead)
+        {
+            const auto& v    = chooseVoiceLedVoicing (row, col);
+            held.inversion   = v.inversion;
+            held.octaveShift = v.octaveShift;
+        }
+
+        held.notes = heldCellNotesLocked (row, col, held);
+        activeNotes.set (key, held);
+
+        juce::Array<int> notes;
+        held.notes.forEach ([&notes] (int note) { notes.add (note); });
+
+        if ((row == MAJOR || row == MINOR) && notes.size() > 1
+             && voicingSettings.strumDirection != VoicingSettings::strumOff)
+        {
+            queueChordNoteOns (notes, velocity, cellIndex (row, col));
+        }
+        else
+        {
+            for (int note : notes)
+                cellNoteOnLocked (juce::MidiMessage::noteOn (1, juce::jlimit (0, 127, note),
+                                                             (juce::uint8) juce::jlimit (0, 127, velocity)),
+                                  cellIndex (row, col));
+        }
+
+        STRADELLA_LOG (AsyncLogger::Event::cellPressed, row, col, velocity, notes.size());
+    }
+}
+
+// Queues a chord's note-ons in roll order, each stamped with its delay (see
+// pendingQueue and DirectMidiOutput::send) and with the velocity tilt
+// applied.  Called with messageLock held.
+void StraDellaMIDI_pluginAudioProcessor::queueChordNoteOns (const juce::Array<int>& notes, int velocity, int cell)
+{
+    auto order = notes;   // ascending = strum up
+
+    if (voicingSettings.strumDirection == VoicingSettings::strumDown)
+    {
+        for (int i = 0, j = order.size() - 1; i < j; ++i, --j)
+            order.swap (i, j);
+    }
+    else if (voicingSettings.strumDirection == VoicingSettings::strumRandom)
+    {
+        for (int i = order.size() - 1; i > 0; --i)
+            order.swap (i, strumRandom.nextInt (i + 1));
     }
+
+    const float spreadMs = juce::jlimit (0.0f, 50.0f, voicingSettings.strumSpreadMs);
+    const int   tilt     = juce::jlimit (-40, 40, voicingSettings.strumVelocityTilt);
+    const int   last     = order.size() - 1;
+
+    for (int i = 0; i <= last; ++i)
+    {
+        const float position = (float) i / (float) last;
+        currentVelocityOffset = juce::roundToInt (tilt * position);
+
+        auto msg = juce::MidiMessage::noteOn (1, juce::jlimit (0, 127, order[i]),
+                                              (juce::uint8) juce::jlimit (1, 127, velocity + currentVelocityOffset));
+        msg.setTimeStamp (spreadMs * position);
+        cellNoteOnLocked (msg, cell);
+    }
+
+    currentVelocityOffset = 0;
 }
 
-void StraDellaMIDI_pluginAudioProcessor::buttonReleased (int row, int col)
+void StraDellaMIDI_pluginAudioProcessor::releaseCellLocked (int row, int col)
 {
     const int key = row * 1000 + col;
-    const juce::ScopedLock sl (messageLock);
 
     if (!pressCount.contains (key))
         return;
@@ -263,32 +1208,218 @@ void StraDellaMIDI_pluginAudioProcessor::buttonReleased (int row, int col)
 
     // Count reached 0: send note-offs and clean up.
     pressCount.remove (key);
+    setCellHeld (row, col, false);
+    patternCellReleasedLocked (row, col);
     if (activeNotes.contains (key))
     {
-        for (int note : activeNotes[key])
-            pendingMessages.add (juce::MidiMessage::noteOff (1, juce::jlimit (0, 127, note)));
+        const auto notes = activeNotes[key].notes;
+        notes.forEach ([this] (int note)
+        {
+            cellNoteOffLocked (note);
+        });
         activeNotes.remove (key);
+
+        STRADELLA_LOG (AsyncLogger::Event::cellReleased, row, col, notes.size());
+    }
+}
+
+// A cell starts or stops sounding one pitch (see pitchCount).  Both called
+// with messageLock held.
+void StraDellaMIDI_pluginAudioProcessor::cellNoteOnLocked (const juce::MidiMessage& noteOn, int cell)
+{
+    const int note = noteOn.getNoteNumber();
+
+    if (pitchCount[note]++ == 0)
+    {
+        noteOwner[note] = (juce::int8) cell;
+        queueMessageLocked (noteOn, cell);
     }
 }
 
+void StraDellaMIDI_pluginAudioProcessor::cellNoteOffLocked (int note)
+{
+    if (pitchCount[note] == 0)
+        return;
+
+    if (--pitchCount[note] == 0)
+        queueMessageLocked (juce::MidiMessage::noteOff (1, note), noteOwner[note]);
+}
+
+void StraDellaMIDI_pluginAudioProcessor::clearCellNotesLocked()
+{
+    activeNotes.clear();
+    std::memset (pitchCount, 0, sizeof (pitchCount));
+}
+
+void StraDellaMIDI_pluginAudioProcessor::queueMessageLocked (const juce::MidiMessage& msg, int cell)
+{
+    if (directOutput.isActive())
+        directOutput.send (msg, currentInputTicks, cell);
+    else
+        pushPendingLocked (msg, cell);
+}
+
+void StraDellaMIDI_pluginAudioProcessor::pushPendingLocked (const juce::MidiMessage& msg, int cell)
+{
+    if (pendingQueue.push (msg, juce::Time::getHighResolutionTicks(), cell, currentVelocityOffset))
+        statQueued.fetch_add (1, std::memory_order_relaxed);
+}
+
+bool StraDellaMIDI_pluginAudioProcessor::setDirectOutputDevice (const juce::String& identifier)
+{
+    const juce::ScopedLock sl (messageLock);
+    const bool wasActive = directOutput.isActive();
+    bool ok = identifier.isEmpty();
+
+    if (identifier.isEmpty() || ! DirectMidiOutput::isAvailable())
+        directOutput.close();
+    else
+        ok = directOutput.open (identifier);
+
+    directOutputRouteChangedLocked (wasActive);
+    return ok;
+}
+
+void StraDellaMIDI_pluginAudioProcessor::setDirectOutputMode (DirectMidiOutput::Mode mode)
+{
+    const juce::ScopedLock sl (messageLock);
+    const bool wasActive = directOutput.isActive();
+    directOutput.setMode (mode);
+    directOutputRouteChangedLocked (wasActive);
+}
+
+// A held note's note-off would otherwise leave by the other route and hang the
+// first one, so switching route silences the host side (closing the device
+// silences the device side) and forgets held cells.  Called with messageLock held.
+void StraDellaMIDI_pluginAudioProcessor::directOutputRouteChangedLocked (bool wasActive)
+{
+    if (wasActive == directOutput.isActive())
+        return;
+
+    if (wasActive)
+        directOutput.close();
+    else
+        for (int ch = 1; ch <= 16; ++ch)
+            pushPendingLocked (juce::MidiMessage::allNotesOff (ch));
+
+    clearCellNotesLocked();
+}
+
 void StraDellaMIDI_pluginAudioProcessor::addMidiMessage (const juce::MidiMessage& msg)
 {
+    const auto inputTicks = juce::Time::getHighResolutionTicks();
+
     const juce::ScopedLock sl (messageLock);
-    pendingMessages.add (msg);
+    currentInputTicks = inputTicks;
+    queueMessageLocked (msg);
+
+    // Mirror the bellows level for the editor's expression meter.
+    if (msg.isControllerOfType (11) || msg.isControllerOfType (1))
+    {
+        heldState.expression = msg.getControllerValue();
+        publishUiSnapshot();
+    }
+}
+
+//==============================================================================
+// Both called with messageLock held.
+void StraDellaMIDI_pluginAudioProcessor::setCellHeld (int row, int col, bool held)
+{
+    static_assert (NUM_ROWS * NUM_COLUMNS <= 48, "held-cell bitset must fit UiSnapshot");
+
+    const auto bit = juce::uint64 (1) << (row * NUM_COLUMNS + col);
+    heldState.heldCells = held ? (heldState.heldCells | bit) : (heldState.heldCells & ~bit);
+    publishUiSnapshot();
+}
+
+void StraDellaMIDI_pluginAudioProcessor::publishUiSnapshot()
+{
+    uiSnapshotWord.store (heldState.pack(), std::memory_order_release);
 }
 
 void StraDellaMIDI_pluginAudioProcessor::sendAllNotesOff()
 {
     const juce::ScopedLock sl (messageLock);
-    activeNotes.clear();
+    clearCellNotesLocked();
     pressCount.clear();
+    clearPatternSourcesLocked();
+    heldState.heldCells = 0;
+    publishUiSnapshot();
+    // Panic goes down both paths: pattern notes always leave via processBlock.
     for (int ch = 1; ch <= 16; ++ch)
     {
-        pendingMessages.add (juce::MidiMessage::allNotesOff (ch));
-        pendingMessages.add (juce::MidiMessage::allSoundOff (ch));
+        pushPendingLocked (juce::MidiMessage::allNotesOff (ch));
+        pushPendingLocked (juce::MidiMessage::allSoundOff (ch));
+
+        if (directOutput.isActive())
+        {
+            directOutput.send (juce::MidiMessage::allNotesOff (ch), 0);
+            directOutput.send (juce::MidiMessage::allSoundOff (ch), 0);
+        }
+    }
+
+    STRADELLA_LOG (AsyncLogger::Event::allNotesOff);
+}
+
+//==============================================================================
+// Audio thread: keeps uiNotesSounding in step with a UI-originated event that
+// is about to leave processBlock.
+void StraDellaMIDI_pluginAudioProcessor::trackUiNote (const juce::uint8* data, int size,
+                                                      bool cancelledRolledNote) noexcept
+{
+    if (size != 3)
+        return;
+
+    const int  status = data[0] & 0xf0;
+    auto*      counts = uiNotesSounding[data[0] & 0x0f];
+    auto&      count  = counts[data[1] & 0x7f];
+
+    if (status == 0x90 && data[2] > 0)
+    {
+        if (count < 255)
+        {
+            ++count;
+            ++numUiNotesSounding;
+        }
+    }
+    else if (status == 0x80 || status == 0x90)
+    {
+        // A note-off whose rolled note-on was cancelled has nothing to end.
+        if (count > 0)
+        {
+            --count;
+            --numUiNotesSounding;
+        }
+        else if (! cancelledRolledNote)
+        {
+            statUnmatched.fetch_add (1, std::memory_order_relaxed);
+        }
+    }
+    else if (status == 0xb0 && (data[1] == 120 || data[1] == 123))
+    {
+        for (int note = 0; note < 128; ++note)
+            numUiNotesSounding -= counts[note];
+
+        std::memset (counts, 0, 128);
     }
 }
 
+StraDellaMIDI_pluginAudioProcessor::BoundaryStats StraDellaMIDI_pluginAudioProcessor::getBoundaryStats() const noexcept
+{
+    BoundaryStats s;
+    s.messagesQueued    = statQueued.load (std::memory_order_relaxed);
+    s.messagesDelivered = statDelivered.load (std::memory_order_relaxed);
+    s.peakQueueDepth    = statPeakDepth.load (std::memory_order_relaxed);
+    s.queueDepth        = pendingQueue.getNumQueued();
+    s.eventsDropped     = statDropped.load (std::memory_order_relaxed);
+    s.eventsCollapsed   = pendingQueue.getNumCollapsed();
+    s.eventsOverflowed  = pendingQueue.getNumOverflowed();
+    s.eventsExpired     = pendingQueue.getNumExpired();
+    s.unmatchedNoteOffs = statUnmatched.load (std::memory_order_relaxed);
+    s.stuckNotes        = statStuck.load (std::memory_order_relaxed);
+    return s;
+}
+
 //==============================================================================
 // This creates new instances of the plugin.
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
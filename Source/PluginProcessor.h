@@ -16,6 +16,21 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "MidiOutputTap.h"
+#include "VoiceLeadingTable.h"
+#include "BassPatternEngine.h"
+#include "TimingWheel.h"
+#include "VoiceLimiter.h"
+#include "MidiEventList.h"
+#include "PendingEventQueue.h"
+#include "ChordRecognizer.h"
+#include "NoteMask.h"
+#include "BassRegisters.h"
+#include "OscControlReceiver.h"
+#include "DirectMidiOutput.h"
+#include "InputRecorder.h"
+#include "ModulationMatrix.h"
+#include "CurveBank.h"
 
 //==============================================================================
 /** Per-row voicing parameters exposed to the Expression settings window. */
@@ -36,18 +51,85 @@ struct VoicingSettings
     // Right mouse button adds the major 9th.
     bool majorRightMouseAdds9 = true;
     bool minorRightMouseAdds9 = true;
+
+    // Auto inversion: each major/minor press picks the inversion and octave
+    // closest to the previously sounding chord (minimal total semitone
+    // movement).  The lowest chord tone stays within
+    // [autoInversionLowNote, autoInversionLowNote + 12]; the fixed inversion
+    // above only chooses the first chord.  The chord rows' octave offsets
+    // do not apply in this mode: the range alone sets the register.
+    bool autoInversion        = false;
+    int  autoInversionLowNote = 48;   // C3
+
+    // Chord roll: major/minor chord tones are spread over strumSpreadMs
+    // (0-50 ms) instead of starting together.  strumVelocityTilt (-40..+40)
+    // is added in proportion across the roll, so positive values make the
+    // last note louder than the first.
+    enum StrumDirection { strumOff = 0, strumUp, strumDown, strumRandom };
+
+    int   strumDirection    = strumOff;
+    float strumSpreadMs     = 15.0f;
+    int   strumVelocityTilt = 0;
+};
+
+//==============================================================================
+/** One press or release of a grid cell, as handed to the processor in batches
+    by the input engines.  ticks is juce::Time::getHighResolutionTicks() at the
+    moment the input transition was observed. */
+struct CellIntent
+{
+    juce::int64 ticks          = 0;
+    juce::int8  row            = 0;
+    juce::int8  col            = 0;
+    bool        isPress        = false;
+    juce::uint8 velocity       = 100;
+    bool        leftMouseDown  = false;
+    bool        rightMouseDown = false;
+};
+
+//==============================================================================
+/** Compact view of processor state for the editor: one bit per held grid cell
+    (bit = row * NUM_COLUMNS + col) plus the bellows level (pointer Y or OSC expression, 0-127).
+    Packed into a single 64-bit word so it can be published and read wait-free. */
+struct UiSnapshot
+{
+    juce::uint64 heldCells  = 0;
+    int          expression = 0;
+
+    bool isHeld (int row, int col) const noexcept;   // defined after the processor
+
+    juce::uint64 pack() const noexcept
+    {
+        return (heldCells & ((juce::uint64 (1) << 48) - 1)) | (juce::uint64 (expression & 0x7f) << 48);
+    }
+
+    static UiSnapshot unpack (juce::uint64 word) noexcept
+    {
+        return { word & ((juce::uint64 (1) << 48) - 1), (int) ((word >> 48) & 0x7f) };
+    }
 };
 
 //==============================================================================
-class StraDellaMIDI_pluginAudioProcessor  : public juce::AudioProcessor
+class StraDellaMIDI_pluginAudioProcessor  : public juce::AudioProcessor,
+                                            private juce::Timer
 {
 public:
     //==============================================================================
     static constexpr int NUM_COLUMNS = 12;
     static constexpr int NUM_ROWS    = 4;
 
+    // Most notes one cell can sound (root, 3rd, 5th, 7th, 9th).
+    static constexpr int kMaxCellNotes = 5;
+
     enum RowType { COUNTERBASS = 0, BASS, MAJOR, MINOR };
 
+    // What happens to MIDI arriving from the host.
+    enum class ThruMode { pass = 0, filterNotes, filterAll };
+
+    // Chord recognition of host MIDI: display lights the matching grid cells,
+    // revoice also replaces the played notes with those cells' notes.
+    enum class ChordInputMode { off = 0, display, revoice };
+
     //==============================================================================
     StraDellaMIDI_pluginAudioProcessor();
     ~StraDellaMIDI_pluginAudioProcessor() override;
@@ -71,10 +153,11 @@ public:
     double getTailLengthSeconds() const override { return 0.0; }
 
     //==============================================================================
-    int  getNumPrograms()                                        override { return 1; }
-    int  getCurrentProgram()                                     override { return 0; }
-    void setCurrentProgram (int)                                 override {}
-    const juce::String getProgramName (int)                      override { return {}; }
+    // Programs are the bass registers (see setBassRegister()).
+    int  getNumPrograms()                                        override { return BassRegisters::kNumRegisters; }
+    int  getCurrentProgram()                                     override;
+    void setCurrentProgram (int index)                           override;
+    const juce::String getProgramName (int index)                override;
     void changeProgramName (int, const juce::String&)            override {}
 
     //==============================================================================
@@ -84,9 +167,20 @@ public:
     //==============================================================================
     // Called from the editor (UI thread) to queue note-on / note-off events.
     // leftMouseDown / rightMouseDown affect chord voicing for major/minor rows.
+    // ticks is when the input event arrived (as CellIntent::ticks); 0 stamps
+    // the call itself, before the message lock is taken.
     void buttonPressed  (int row, int col, int velocity = 100,
-                         bool leftMouseDown = false, bool rightMouseDown = false);
-    void buttonReleased (int row, int col);
+                         bool leftMouseDown = false, bool rightMouseDown = false,
+                         juce::int64 ticks = 0);
+    void buttonReleased (int row, int col, juce::int64 ticks = 0);
+
+    // Applies a batch of presses/releases under a single lock acquisition.
+    void applyCellIntents (const CellIntent* intents, int numIntents);
+
+    // The mouse buttons went down or up (ticks as CellIntent::ticks).  Held
+    // chord cells take the new 7th/9th extensions at once: only the pitches
+    // that differ are stopped or started, common tones keep sounding.
+    void setMouseButtons (bool leftMouseDown, bool rightMouseDown, juce::int64 ticks);
 
     // Called to queue arbitrary MIDI messages (e.g. CC from mouse expression).
     void addMidiMessage (const juce::MidiMessage& msg);
@@ -94,9 +188,111 @@ public:
     // Sends All Notes Off + All Sound Off on all 16 MIDI channels (panic).
     void sendAllNotesOff();
 
-    // Voicing settings accessors.
-    void                   setVoicingSettings (const VoicingSettings& s) { voicingSettings = s; }
-    const VoicingSettings& getVoicingSettings () const                   { return voicingSettings; }
+    // Latest held-cell / expression snapshot.  Wait-free; safe from any thread.
+    UiSnapshot getUiSnapshot() const noexcept { return UiSnapshot::unpack (uiSnapshotWord.load (std::memory_order_acquire)); }
+
+    // Lock-free copy of every event leaving processBlock, for the MIDI monitor.
+    MidiOutputTap& getOutputTap() noexcept { return outputTap; }
+
+    // Counters for the UI -> audio hand-over.  processBlock checks its
+    // invariants every block and counts violations here rather than failing.
+    struct BoundaryStats
+    {
+        juce::uint64 messagesQueued     = 0;   ///< accepted into the pending queue (collapsed CCs included)
+        juce::uint64 messagesDelivered  = 0;   ///< picked up by processBlock
+        int          peakQueueDepth     = 0;   ///< most messages one block picked up
+        int          queueDepth         = 0;   ///< messages waiting right now
+        juce::uint64 eventsDropped      = 0;   ///< lost to a full generated-event list
+        juce::uint64 eventsCollapsed    = 0;   ///< queued CCs replaced by a newer value
+        juce::uint64 eventsOverflowed   = 0;   ///< refused or evicted by the full pending queue
+        juce::uint64 eventsExpired      = 0;   ///< waited longer than the pending max age
+        juce::uint64 unmatchedNoteOffs  = 0;   ///< note-offs for notes that were not sounding
+        juce::uint64 stuckNotes         = 0;   ///< notes still sounding with no cell held
+    };
+
+    BoundaryStats getBoundaryStats() const noexcept;
+
+    // Queued UI messages older than this are discarded by processBlock
+    // (note-offs excepted), so a host that stops processing for a while does
+    // not get a burst of stale CCs on resume.  0 = never expire.
+    void setPendingMaxAgeMs (int ms);
+    int  getPendingMaxAgeMs () const;
+
+    // Raw input session recording (see InputRecorder / InputReplayer).
+    InputRecorder& getInputRecorder() noexcept { return inputRecorder; }
+
+    // Puts the state that input sessions depend on into a known state: the
+    // auto-inversion history is forgotten and the chord-roll random order is
+    // reseeded.  Called when recording starts and before a replay.
+    void beginInputSession (juce::int64 randomSeed);
+
+    // Optional OSC/UDP remote control input (off until started).
+    OscControlReceiver& getOscReceiver() noexcept { return oscReceiver; }
+
+    // Standalone only: send the grid's messages straight to a MIDI device
+    // instead of waiting for processBlock.  An empty identifier closes it.
+    bool              setDirectOutputDevice (const juce::String& identifier);
+    void              setDirectOutputMode   (DirectMidiOutput::Mode mode);
+    DirectMidiOutput& getDirectOutput() noexcept { return directOutput; }
+
+    // Voicing settings accessors.  Any thread; the getter returns a copy.
+    // updateVoicingSettings() applies a read-modify-write under one lock, so
+    // concurrent editors (UI, OSC) cannot undo each other's changes.
+    void            setVoicingSettings (const VoicingSettings& s);
+    VoicingSettings getVoicingSettings () const;
+
+    template <typename Fn>
+    void updateVoicingSettings (Fn&& change)
+    {
+        const juce::ScopedLock sl (messageLock);
+        auto s = voicingSettings;
+        change (s);
+        setVoicingSettingsLocked (s);
+    }
+
+    // Automatic bass pattern.  While a pattern is selected, held cells feed the
+    // pattern engine instead of sounding directly.
+    void                        setPatternSettings (const BassPatternEngine::Settings& s);
+    BassPatternEngine::Settings getPatternSettings () const;
+
+    // Host input forwarding.
+    void     setThruMode (ThruMode mode);
+    ThruMode getThruMode () const;
+
+    // Host input chord recognition.  The recognized chord and its cells are
+    // published by processBlock and readable wait-free from any thread.
+    void                   setChordInputMode (ChordInputMode mode);
+    ChordInputMode         getChordInputMode () const;
+    ChordRecognizer::Chord getRecognizedChord() const noexcept;
+    juce::uint64           getRecognizedCells() const noexcept { return chordRecognizer.toCells (getRecognizedChord()).mask(); }
+
+    // Bass register switch (multi-reed octave doubling).  Any thread; also
+    // switched by host automation of the "register" parameter, by
+    // setCurrentProgram() and by program changes on the host MIDI input.
+    // Held cells take the new register at once, by note-mask difference.
+    void setBassRegister (int index);
+    int  getBassRegister () const;
+
+    // Edits one register's octave sets; held cells follow if it is active.
+    void                    setBassRegisterOctaves (int index, const BassRegisters::Register& r);
+    BassRegisters::Register getBassRegisterOctaves (int index) const;
+
+    // Output polyphony cap.  The limiter's counters are readable from any thread.
+    void                   setVoiceLimiterSettings (const VoiceLimiter::Settings& s);
+    VoiceLimiter::Settings getVoiceLimiterSettings () const;
+    const VoiceLimiter&    getVoiceLimiter () const noexcept { return voiceLimiter; }
+
+    // Modulation matrix (expression sources -> MIDI destinations), evaluated
+    // once per block.  Settings from any thread; the pointer sources come
+    // from the mouse expression on the message thread.
+    void                       setModulationSettings (const ModulationMatrix::Settings& s);
+    ModulationMatrix::Settings getModulationSettings () const;
+    void setModulationSources (float pointerY, float bellowsSpeed);
+
+    // Expression response curves, shared by the mouse expression (message
+    // thread) and the modulation matrix (audio thread).  Edit the drawn
+    // curve on the message thread only.
+    CurveBank& getCurveBank() noexcept { return curveBank; }
 
     // Static helpers – public so the editor can use them for labels.
     juce::Array<int> getNotesForButton (int row, int col,
@@ -109,12 +305,95 @@ public:
 
 private:
     //==============================================================================
-    juce::Array<juce::MidiMessage> pendingMessages;
-    juce::CriticalSection          messageLock;
+    // Messages queued by the UI thread (guarded by messageLock).  A note-on
+    // with a non-zero timestamp is a rolled chord tone: the timestamp is its
+    // delay in milliseconds from the start of the block that picks it up.
+    // processBlock moves the queue into incomingEvents (audio thread only).
+    PendingEventQueue        pendingQueue;
+    PendingEventQueue::Event incomingEvents[PendingEventQueue::kCapacity];
+    juce::CriticalSection    messageLock;
+
+    // Routes a UI-side message to pendingQueue, or straight to the direct
+    // output when that is active.  Called with messageLock held.
+    void queueMessageLocked (const juce::MidiMessage& msg, int cell = -1);
+    void pushPendingLocked  (const juce::MidiMessage& msg, int cell = -1);
+
+    // Grid cell tag carried by queued notes (see PendingEventQueue::Event).
+    static int cellIndex (int row, int col) noexcept   { return row * NUM_COLUMNS + col; }
+    void directOutputRouteChangedLocked (bool wasActive);
 
-    // Tracks which MIDI notes are currently sounding per (row*1000+col) key,
-    // so buttonReleased() can send the exact note-offs that were sent on press.
-    juce::HashMap<int, juce::Array<int>> activeNotes;
+    // When the input behind the messages being queued was observed
+    // (high-resolution ticks, guarded by messageLock); used for latency.
+    juce::int64 currentInputTicks = 0;
+
+    // Roll velocity tilt of the note-on being queued (guarded by
+    // messageLock), re-applied by processBlock on top of a modulated velocity.
+    int currentVelocityOffset = 0;
+
+    // Rolled note-ons waiting for their time (audio thread only), tagged with
+    // their cell.  A note-off from the same cell for the same pitch removes
+    // the waiting note-on (the note-off itself still goes out, and is not
+    // counted as unmatched), so a quick tap never leaves a late, stuck note.
+    TimingWheel  strumWheel;
+    juce::Random strumRandom;   ///< random roll order, guarded by messageLock
+
+    void queueChordNoteOns (const juce::Array<int>& notes, int velocity, int cell);
+
+    // What a directly sounding cell is playing and how it was voiced, so a
+    // mouse-button or voicing change can re-voice it and buttonReleased() can
+    // send the exact note-offs.  inversion/octaveShift are only used when
+    // voiceLed; otherwise they follow the current VoicingSettings.
+    struct HeldVoicing
+    {
+        NoteMask    notes;
+        juce::uint8 velocity       = 100;
+        bool        leftMouseDown  = false;
+        bool        rightMouseDown = false;
+        bool        voiceLed       = false;
+        juce::int8  inversion      = 0;
+        juce::int8  octaveShift    = 0;
+    };
+
+    // Sounding cells per (row*1000+col) key.
+    juce::HashMap<int, HeldVoicing> activeNotes;
+
+    // Held cells can share a pitch (register doublings, a chord tone that is
+    // also a bass note).  pitchCount is how many held cells sound each pitch
+    // and noteOwner the cell whose note-on started it (guarded by
+    // messageLock).  Only the first cell sends the note-on and only the last
+    // the note-off, tagged with the owner so it cancels the owner's rolled
+    // note-on if that is still waiting.
+    juce::uint8 pitchCount[128] {};
+    juce::int8  noteOwner[128]  {};
+
+    void cellNoteOnLocked  (const juce::MidiMessage& noteOn, int cell);
+    void cellNoteOffLocked (int note);
+    void clearCellNotesLocked();
+
+    // Last mouse buttons passed to setMouseButtons() (guarded by messageLock).
+    bool heldLeftMouseDown  = false;
+    bool heldRightMouseDown = false;
+
+    // Re-voicing of held cells.  All called with messageLock held; none of
+    // them allocates, so processBlock can switch the register.
+    NoteMask heldCellNotesLocked (int row, int col, const HeldVoicing& held) const;
+    void     revoiceHeldCellLocked (int row, int col, HeldVoicing& held);
+    void     revoiceHeldCellsLocked (bool followMouseButtons);
+    void     refreshPatternChordLocked();
+
+    // Bass registers (guarded by messageLock).  registerParameter is owned by
+    // the AudioProcessor.  Register switches re-voice held cells, which may
+    // write to a direct output device, so they are applied on the message
+    // thread: processBlock only leaves a host program change in
+    // programRegister, and timerCallback() applies it (moving the parameter
+    // there, so the host sees it too) or a change of the automated parameter.
+    BassRegisters               bassRegisters;
+    int                         bassRegister = 0;
+    juce::AudioParameterChoice* registerParameter = nullptr;
+    std::atomic<int>            programRegister { -1 };
+
+    void applyBassRegisterLocked (int index);
+    void timerCallback() override;
 
     // Reference count per cell: counts how many input sources (mouse + keyboard)
     // are simultaneously holding the same button.  Note-on is sent only when the
@@ -123,7 +402,134 @@ private:
     // same cell at the same time.
     juce::HashMap<int, int> pressCount;
 
-    VoicingSettings voicingSettings;
+    // Editor-facing state, guarded by messageLock and published as one atomic
+    // word whenever it changes (see publishUiSnapshot()).
+    UiSnapshot                heldState;
+    std::atomic<juce::uint64> uiSnapshotWord { 0 };
+
+    // Press/release bookkeeping shared by the single and batched entry points.
+    // Both must be called with messageLock held.
+    void pressCellLocked   (int row, int col, int velocity, bool leftMouseDown, bool rightMouseDown);
+    void releaseCellLocked (int row, int col);
+
+    void setCellHeld (int row, int col, bool held);
+    void publishUiSnapshot();
+
+    VoicingSettings voicingSettings;   ///< guarded by messageLock
+    void setVoicingSettingsLocked (const VoicingSettings& s);
+
+    // Auto-inversion state (guarded by messageLock).
+    VoiceLeadingTable voiceLeading;
+    int               lastChordVoicing = -1;   ///< index into voiceLeading, -1 = none yet
+
+    // Builds a button's notes with an explicit inversion and octave shift.
+    juce::Array<int> buildButtonNotes (int row, int col, bool leftMouseDown, bool rightMouseDown,
+                                       int inversion, int octaveShiftSemitones) const;
+
+    // Auto-inversion variant of getNotesForButton() for the chord rows.
+    juce::Array<int> getVoiceLedNotes (int row, int col, bool leftMouseDown, bool rightMouseDown);
+    const VoiceLeadingTable::Voicing& chooseVoiceLedVoicing (int row, int col);
+
+    MidiOutputTap outputTap;
+    juce::int64   samplePosition = 0;   ///< running sample count, stamps tapped blocks
+    double        currentSampleRate = 44100.0;   ///< from prepareToPlay; times rolled notes
+
+    // Bass pattern state.  Settings and sources are guarded by messageLock and
+    // copied to the audio thread at the top of each block; the engine itself
+    // is only touched by processBlock.
+    BassPatternEngine           patternEngine;
+    BassPatternEngine::Settings patternSettings;
+    BassPatternEngine::Sources  patternSources;
+    int patternBassKey  = -1;   ///< row*1000+col of the cell feeding the bass steps
+    int patternChordKey = -1;   ///< row*1000+col of the cell feeding the chord steps
+
+    bool isPatternActive() const noexcept { return patternSettings.pattern != BassPatternEngine::Pattern::off; }
+    void setPatternBassLocked  (int row, int col);
+    void setPatternChordLocked (const juce::Array<int>& notes, int key);
+    void patternCellReleasedLocked (int row, int col);
+    void clearPatternSourcesLocked();
+
+    // Output stage.  Generators append to generatedEvents; processBlock merges
+    // it with the host input into mergedOutput.  Both are sized in
+    // prepareToPlay; kPendingCapacity is the most UI messages one block takes.
+    static constexpr int kPendingCapacity = PendingEventQueue::kCapacity;
+
+    MidiEventList    generatedEvents;
+    juce::MidiBuffer mergedOutput;
+    size_t           reservedOutputBytes = 0;
+    ThruMode         thruMode = ThruMode::pass;   ///< guarded by messageLock
+
+    // Output voice limiter (audio thread) and its settings (messageLock).
+    VoiceLimiter           voiceLimiter;
+    VoiceLimiter::Settings voiceLimiterSettings;
+
+    // Modulation matrix (audio thread) and its settings (messageLock).
+    // modulationChanged tells processBlock to recompile the routes.
+    ModulationMatrix           modulationMatrix;
+    ModulationMatrix::Settings modulationSettings;
+    bool                       modulationChanged = false;
+
+    // Response curve tables; the audio thread reads them through acquire().
+    CurveBank                  curveBank;
+
+    // Voice limiter steal priority of a note, from the row (and for chord
+    // rows, the interval) that produced it; cellVoicePriority() takes a
+    // queued event's cell tag and falls back to the default for -1.
+    static int voicePriority     (int row, int col, int note) noexcept;
+    static int cellVoicePriority (int cell, int note) noexcept;
+
+    // Host input chord recognition (audio thread; the mode is guarded by
+    // messageLock).  The recognizer follows the host notes in every mode, so
+    // switching mode keeps the chord being held.  In revoice mode the cells'
+    // notes are generated straight into generatedEvents; revoicedNotes holds
+    // what is sounding (bass cell + chord cell, at most 10 notes).
+    ChordRecognizer           chordRecognizer;
+    ChordInputMode            chordInputMode     = ChordInputMode::off;
+    ChordInputMode            lastChordInputMode = ChordInputMode::off;
+    std::atomic<juce::uint32> recognizedChordWord { 0x00ff00ff };   // packed ChordRecognizer::Chord()
+    int                       revoicedNotes[10] {};
+    int                       numRevoicedNotes = 0;
+    int                       revoiceVelocity  = 100;
+
+    void publishRecognizedChord() noexcept;
+    void revoiceRecognizedChord (const VoicingSettings& voicing, int sampleOffset) noexcept;
+    void releaseRevoicedNotes (int sampleOffset) noexcept;
+
+    // Host note-ons forwarded to the output and not yet ended, per channel
+    // and pitch (audio thread only).  Their note-offs pass whatever the thru
+    // mode is now, so filtering (or revoice, which filters note-ons) only
+    // ever suppresses new notes and never strands a sounding one.
+    juce::uint8 hostNotesForwarded[16][128] {};
+
+    bool passHostEvent (const juce::uint8* data, int numBytes, ThruMode thru) noexcept;
+
+    DirectMidiOutput directOutput;
+    InputRecorder    inputRecorder;
+
+    // Boundary invariants (see BoundaryStats).  uiNotesSounding counts, per
+    // channel and pitch, the UI-originated note-ons that have left
+    // processBlock without their note-off yet (audio thread only).
+    juce::uint8 uiNotesSounding[16][128] {};
+    int         numUiNotesSounding = 0;
+
+    void trackUiNote (const juce::uint8* data, int size, bool cancelledRolledNote) noexcept;
+
+    std::atomic<juce::uint64> statQueued     { 0 };
+    std::atomic<juce::uint64> statDelivered  { 0 };
+    std::atomic<int>          statPeakDepth  { 0 };
+    std::atomic<juce::uint64> statDropped    { 0 };
+    std::atomic<juce::uint64> statUnmatched  { 0 };
+    std::atomic<juce::uint64> statStuck      { 0 };
+
+    // Declared last: its receive thread calls back into this processor, so it
+    // must be stopped before any other member is destroyed.
+    OscControlReceiver oscReceiver { *this };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StraDellaMIDI_pluginAudioProcessor)
 };
+
+//==============================================================================
+inline bool UiSnapshot::isHeld (int row, int col) const noexcept
+{
+    return ((heldCells >> (row * StraDellaMIDI_pluginAudioProcessor::NUM_COLUMNS + col)) & 1) != 0;
+}
@@ -189,100 +189,73 @@ juce::String StradellaKeyboardMapper::getMidiNoteName (int midiNoteNumber)
 }
 
 //==============================================================================
-bool StradellaKeyboardMapper::loadConfiguration (const juce::File& configFile)
+bool StradellaKeyboardMapper::loadConfiguration (const juce::File& configFile,
+                                                 juce::Array<KeyboardMappingParser::Diagnostic>* diagnostics)
 {
-    if (!configFile.existsAsFile())
+    juce::FileInputStream in (configFile);
+    if (! configFile.existsAsFile() || ! in.openedOk())
         return false;
 
+    loadConfiguration (in, diagnostics);
+    return true;
+}
+
+void StradellaKeyboardMapper::loadConfiguration (juce::InputStream& in,
+                                                 juce::Array<KeyboardMappingParser::Diagnostic>* diagnostics)
+{
+    using Parser  = KeyboardMappingParser;
+    using Section = Parser::Section;
+
     // Start from the default mappings and override with file contents.
     setupDefaultMappings();
 
-    juce::StringArray lines;
-    configFile.readLines (lines);
-
-    // Current section determines the KeyType for subsequent key=value lines.
-    // Supported: [bass], [counterbass], [major], [minor]
-    // Other sections (e.g. [voicing]) are marked by setting skipSection = true.
-    KeyType currentSection = KeyType::SingleNote;
-    bool    skipSection    = false;
+    // Line each key was last mapped on in this file, to warn about repeats.
+    juce::HashMap<int, int> lineOfKey;
 
-    for (const auto& rawLine : lines)
+    Parser parser ([this, &lineOfKey] (Parser& p, const Parser::Entry& e)
     {
-        const auto line = rawLine.trim();
-        if (line.isEmpty() || line.startsWith ("#"))
-            continue;
-
-        // Section header, e.g. "[major]"
-        if (line.startsWith ("["))
-        {
-            const auto name = line.substring (1, line.indexOf ("]")).trim().toLowerCase();
-            skipSection = false;
-            if      (name == "bass")                           currentSection = KeyType::SingleNote;
-            else if (name == "counterbass" || name == "third") currentSection = KeyType::ThirdNote;
-            else if (name == "major")                          currentSection = KeyType::MajorChord;
-            else if (name == "minor")                          currentSection = KeyType::MinorChord;
-            else                                               skipSection = true;  // unknown section (e.g. [voicing])
-            continue;
-        }
-
-        // Skip lines belonging to an unrecognised section.
-        if (skipSection)
-            continue;
-
-        // key = note1[,note2,...] [# comment]
-        const int eqPos = line.indexOf ("=");
-        if (eqPos <= 0)
-            continue;
-
-        const auto keyStr = line.substring (0, eqPos).trim();
-        if (keyStr.isEmpty())
-            continue;
-        const int keyCode = normalizeKeyCode (static_cast<int> (static_cast<juce::juce_wchar> (keyStr[0])));
-
-        // Strip trailing comment, then parse comma-separated note values.
-        auto valStr = line.substring (eqPos + 1);
-        const int hashPos = valStr.indexOf ("#");
-        if (hashPos >= 0)
-            valStr = valStr.substring (0, hashPos);
-        valStr = valStr.trim();
-
-        juce::Array<int> notes;
-        for (const auto& tok : juce::StringArray::fromTokens (valStr, ",", ""))
-        {
-            const int n = tok.trim().getIntValue();
-            if (n >= 0 && n <= 127)
-                notes.add (n);
-        }
-
-        if (notes.isEmpty())
-            continue;
+        const auto type = e.section == Section::third ? KeyType::ThirdNote
+                        : e.section == Section::major ? KeyType::MajorChord
+                        : e.section == Section::minor ? KeyType::MinorChord
+                                                      : KeyType::SingleNote;
 
         // Determine the root note so we can find the plugin column.
         //   SingleNote  → notes[0] is the root (octave 2)
         //   ThirdNote   → notes[0] is root+4;  root = notes[0]-4
         //   Chord types → notes[0] is root+12; root = notes[0]-12
-        int rootNote = notes[0];
-        switch (currentSection)
-        {
-            case KeyType::ThirdNote:  rootNote = notes[0] - 4;  break;
-            case KeyType::MajorChord:
-            case KeyType::MinorChord: rootNote = notes[0] - 12; break;
-            default: break;
-        }
+        const int first    = e.notes[0];
+        const int rootNote = type == KeyType::ThirdNote ? first - 4
+                           : type == KeyType::SingleNote ? first
+                                                         : first - 12;
 
         int col = -1;
         for (int c = 0; c < 12; ++c)
             if (kColumnRoots[c] == rootNote) { col = c; break; }
 
+        if (col < 0)
+            p.report (e.line, e.notesColumn, false,
+                      "note " + juce::String (first) + " does not start a column of the grid; the key plays no cell");
+
+        if (lineOfKey.contains (e.keyCode))
+            p.report (e.line, e.keyColumn, false,
+                      "key '" + Parser::getKeyName (e.keyCode) + "' is already mapped on line "
+                        + juce::String (lineOfKey[e.keyCode]) + "; this line replaces it");
+
+        lineOfKey.set (e.keyCode, e.line);
+
         KeyMapping mapping;
-        mapping.keyCode   = keyCode;
-        mapping.type      = currentSection;
-        mapping.midiNotes = notes;
-        mapping.pluginRow = keyTypeToPluginRow (currentSection);
+        mapping.keyCode   = e.keyCode;
+        mapping.type      = type;
+        for (int i = 0; i < e.numNotes; ++i)
+            mapping.midiNotes.add (e.notes[i]);
+        mapping.pluginRow = keyTypeToPluginRow (type);
         mapping.pluginCol = col;
-        mapping.description = getMidiNoteName (notes.size() == 1 ? notes[0] : rootNote);
-        keyMappings.set (keyCode, mapping);
-    }
+        mapping.description = getMidiNoteName (e.numNotes == 1 || col < 0 ? first : rootNote);
+        keyMappings.set (e.keyCode, mapping);
+    });
 
-    return true;
+    parser.parse (in);
+
+    if (diagnostics != nullptr)
+        diagnostics->addArray (parser.getDiagnostics());
 }
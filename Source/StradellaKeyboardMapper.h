@@ -1,11 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "KeyboardMappingParser.h"
 
 //==============================================================================
 /**
     Maps computer keyboard keys to MIDI notes based on Stradella accordion layout.
-    Supports loading configuration from a text file for flexible key mappings.
+    Supports loading configuration from a text file for flexible key mappings
+    (parsed by KeyboardMappingParser, so keys may also be F-keys or numpad keys).
 
     Default keyboard rows (10 of 12 circle-of-fifths pitches: Eb Bb F C G D A E B F#):
       [third]        1 2 3 4 5 6 7 8 9 0   — major 3rd above root  (Stradella row 0)
@@ -27,8 +29,15 @@ public:
     //==============================================================================
     StradellaKeyboardMapper();
     
-    /** Loads keyboard mappings from a configuration file */
-    bool loadConfiguration(const juce::File& configFile);
+    /** Loads keyboard mappings from a configuration file, on top of the defaults.
+        Problems are added to diagnostics (when given) with their line and column;
+        lines with errors are skipped.  Returns false if the file cannot be read. */
+    bool loadConfiguration(const juce::File& configFile,
+                           juce::Array<KeyboardMappingParser::Diagnostic>* diagnostics = nullptr);
+
+    /** As above, reading the mapping text from a stream. */
+    void loadConfiguration(juce::InputStream& in,
+                           juce::Array<KeyboardMappingParser::Diagnostic>* diagnostics = nullptr);
     
     /** Loads default keyboard mappings */
     void loadDefaultConfiguration();
@@ -53,6 +62,15 @@ public:
     */
     bool getButtonCoords(int keyCode, int& rowOut, int& colOut) const;
 
+    /** Calls fn (keyCode, row, col) for every key mapped to a grid cell. */
+    template <typename Fn>
+    void forEachMappedKey(Fn&& fn) const
+    {
+        for (juce::HashMap<int, KeyMapping>::Iterator i (keyMappings); i.next();)
+            if (i.getValue().pluginRow >= 0 && i.getValue().pluginCol >= 0)
+                fn (i.getKey(), i.getValue().pluginRow, i.getValue().pluginCol);
+    }
+
 private:
     struct KeyMapping
     {
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Timing-wheel scheduler implementation.
+
+  ==============================================================================
+*/
+
+#include "TimingWheel.h"
+
+//==============================================================================
+TimingWheel::TimingWheel()
+{
+    reset();
+}
+
+void TimingWheel::reset (juce::int64 now) noexcept
+{
+    for (auto& head : slots)
+        head = -1;
+
+    for (int i = 0; i < kCapacity; ++i)
+        pool[i].next = (juce::int16) (i + 1 < kCapacity ? i + 1 : -1);
+
+    freeList   = 0;
+    numPending = 0;
+    cursorTick = juce::jmax ((juce::int64) 0, now) / kSlotSamples;
+}
+
+bool TimingWheel::schedule (juce::int64 time, const juce::MidiMessage& message, int tag) noexcept
+{
+    if (freeList < 0 || message.getRawDataSize() > 3)
+    {
+        ++numDropped;
+        return false;
+    }
+
+    const auto index = freeList;
+    auto& e = pool[index];
+    freeList = e.next;
+
+    e.time = time;
+    e.tag  = (juce::int8) tag;
+    e.size = (juce::uint8) message.getRawDataSize();
+    std::memcpy (e.data, message.getRawData(), e.size);
+
+    // Late events go into the cursor slot so the next popDue() fires them.
+    const auto tick = juce::jmax (cursorTick, time / kSlotSamples);
+    const int  slot = (int) (tick % kNumSlots);
+    e.next = slots[slot];
+    slots[slot] = index;
+
+    ++numPending;
+    return true;
+}
+
+void TimingWheel::release (juce::int16 index) noexcept
+{
+    pool[index].next = freeList;
+    freeList = index;
+    --numPending;
+}
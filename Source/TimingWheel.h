@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Fixed-capacity timing-wheel scheduler for future MIDI events.
+
+    Events are keyed by absolute sample time and hashed into kNumSlots slots
+    of kSlotSamples samples each; every slot is an intrusive list threaded
+    through a preallocated node pool.  Scheduling and firing never allocate,
+    so the wheel can be used directly inside processBlock.  Events further
+    ahead than one wheel revolution simply stay in their slot until their
+    time comes round.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class TimingWheel
+{
+public:
+    //==============================================================================
+    static constexpr int kNumSlots    = 256;
+    static constexpr int kSlotSamples = 64;
+    static constexpr int kCapacity    = 1024;
+
+    /** A short (≤ 3 byte) MIDI message due at an absolute sample time. */
+    struct Event
+    {
+        juce::int64 time = 0;
+        juce::uint8 data[3] {};
+        juce::uint8 size = 0;
+        juce::int8  tag  = -1;   // caller's label (e.g. the owning grid cell)
+        juce::int16 next = -1;   // pool link
+    };
+
+    //==============================================================================
+    TimingWheel();
+
+    /** Drops every pending event and moves the cursor to `now`. */
+    void reset (juce::int64 now = 0) noexcept;
+
+    /** Schedules a message.  Returns false (and drops it) when the pool is full. */
+    bool schedule (juce::int64 time, const juce::MidiMessage& message, int tag = -1) noexcept;
+
+    /** Fires, in no particular order, every event with time < endTime and
+        removes it.  fn is called as fn (const Event&). */
+    template <typename Fn>
+    void popDue (juce::int64 endTime, Fn&& fn)
+    {
+        const auto lastTick = (endTime - 1) / kSlotSamples;
+        const auto numTicks = juce::jmin ((juce::int64) kNumSlots, lastTick - cursorTick + 1);
+
+        for (juce::int64 i = 0; i < numTicks; ++i)
+        {
+            const int slot = (int) ((cursorTick + i) % kNumSlots);
+            auto* link = &slots[slot];
+
+            while (*link >= 0)
+            {
+                auto& e = pool[*link];
+                if (e.time < endTime)
+                {
+                    fn (static_cast<const Event&> (e));
+                    const auto index = *link;
+                    *link = e.next;
+                    release (index);
+                }
+                else
+                {
+                    link = &e.next;
+                }
+            }
+        }
+
+        // Keep the cursor on the slot containing endTime: it may still hold
+        // events due later in that slot.
+        cursorTick = juce::jmax (cursorTick, endTime / kSlotSamples);
+    }
+
+    /** Fires and removes every pending event regardless of its time. */
+    template <typename Fn>
+    void popAll (Fn&& fn)
+    {
+        for (auto& head : slots)
+        {
+            while (head >= 0)
+            {
+                const auto index = head;
+                head = pool[index].next;
+                fn (static_cast<const Event&> (pool[index]));
+                release (index);
+            }
+        }
+    }
+
+    /** Removes, without firing, every pending event for which pred (const Event&)
+        returns true.  Returns the number removed.  Walks the whole wheel. */
+    template <typename Pred>
+    int removeIf (Pred&& pred)
+    {
+        int removed = 0;
+
+        for (auto& head : slots)
+        {
+            auto* link = &head;
+            while (*link >= 0)
+            {
+                if (pred (static_cast<const Event&> (pool[*link])))
+                {
+                    const auto index = *link;
+                    *link = pool[index].next;
+                    release (index);
+                    ++removed;
+                }
+                else
+                {
+                    link = &pool[*link].next;
+                }
+            }
+        }
+
+        return removed;
+    }
+
+    int getNumPending() const noexcept   { return numPending; }
+    juce::int64 getNumDropped() const noexcept { return numDropped; }
+
+private:
+    //==============================================================================
+    void release (juce::int16 index) noexcept;
+
+    Event       pool[kCapacity];
+    juce::int16 slots[kNumSlots];
+    juce::int16 freeList   = -1;
+    int         numPending = 0;
+    juce::int64 numDropped = 0;
+    juce::int64 cursorTick = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimingWheel)
+};
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Voice-leading table implementation.
+
+  ==============================================================================
+*/
+
+#include "VoiceLeadingTable.h"
+
+//==============================================================================
+int VoiceLeadingTable::distance (const Voicing& a, const Voicing& b) noexcept
+{
+    return std::abs (a.notes[0] - b.notes[0])
+         + std::abs (a.notes[1] - b.notes[1])
+         + std::abs (a.notes[2] - b.notes[2]);
+}
+
+void VoiceLeadingTable::build (const int* columnRoots, int lowNote)
+{
+    // Octave shifts of ±2 around the default register cover these ranges.
+    lowNote     = juce::jlimit (kMinRangeLowNote, kMaxRangeLowNote, lowNote);
+    rangeLow    = lowNote;
+    numVoicings = 0;
+
+    const int highNote = lowNote + 12;
+    const int centre   = lowNote + 6;
+
+    // ── Enumerate candidate voicings ─────────────────────────────────────────
+    int firstOfChord[kNumChords + 1] {};
+
+    for (int chord = 0; chord < kNumChords; ++chord)
+    {
+        firstOfChord[chord] = numVoicings;
+
+        const bool isMinor = chord >= 12;
+        const int  base    = columnRoots[chord % 12] + 12;
+        const int  third   = isMinor ? 3 : 4;
+
+        for (int inversion = 0; inversion < 3; ++inversion)
+        {
+            for (int octave = -2; octave <= 2; ++octave)
+            {
+                int tones[3] = { base + octave * 12, base + octave * 12 + third, base + octave * 12 + 7 };
+
+                // Same rule as the processor's applyInversion(): the lowest
+                // tone moves up an octave per inversion step.
+                for (int i = 0; i < inversion; ++i)
+                {
+                    const int lowest = tones[0];
+                    tones[0] = tones[1];
+                    tones[1] = tones[2];
+                    tones[2] = lowest + 12;
+                }
+
+                if (tones[0] < lowNote || tones[0] > highNote)
+                    continue;
+
+                jassert (numVoicings < kMaxVoicings);
+                auto& v = voicings[numVoicings++];
+                v.chord       = (juce::int8) chord;
+                v.inversion   = (juce::int8) inversion;
+                v.octaveShift = (juce::int8) octave;
+                for (int i = 0; i < 3; ++i)
+                    v.notes[i] = (juce::int8) tones[i];
+            }
+        }
+    }
+    firstOfChord[kNumChords] = numVoicings;
+
+    // Prefer candidates that keep the chord near the middle of the range,
+    // then lower inversions, when movement is tied.
+    auto tieBreak = [centre] (const Voicing& v)
+    {
+        return std::abs (v.notes[0] - centre) * 4 + v.inversion;
+    };
+
+    // ── Starting voicing per chord and requested inversion ───────────────────
+    for (int chord = 0; chord < kNumChords; ++chord)
+    {
+        for (int inversion = 0; inversion < 3; ++inversion)
+        {
+            int best = -1, bestScore = std::numeric_limits<int>::max();
+            for (int c = firstOfChord[chord]; c < firstOfChord[chord + 1]; ++c)
+            {
+                const auto& v   = voicings[c];
+                const int score = (v.inversion == inversion ? 0 : 1000) + tieBreak (v);
+                if (score < bestScore) { bestScore = score; best = c; }
+            }
+            jassert (best >= 0);
+            startVoicing[chord][inversion] = (juce::int16) best;
+        }
+    }
+
+    // ── Best move from every voicing to every chord ──────────────────────────
+    for (int from = 0; from < numVoicings; ++from)
+    {
+        for (int chord = 0; chord < kNumChords; ++chord)
+        {
+            int best = -1, bestScore = std::numeric_limits<int>::max();
+            for (int c = firstOfChord[chord]; c < firstOfChord[chord + 1]; ++c)
+            {
+                const int score = distance (voicings[from], voicings[c]) * 1000 + tieBreak (voicings[c]);
+                if (score < bestScore) { bestScore = score; best = c; }
+            }
+            bestMove[from][chord] = (juce::int16) best;
+        }
+    }
+}
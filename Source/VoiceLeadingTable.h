@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Precomputed voice-leading table for the "auto inversion" mode.
+
+    Every voicing of the 24 chord-row triads (12 major + 12 minor, in root
+    position or either inversion) whose lowest note lies inside the configured
+    one-octave range is enumerated once.  For each (previous voicing, next
+    chord) pair the table stores the candidate voicing with the smallest total
+    semitone movement, so choosing the inversion on the press path is a single
+    array lookup.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class VoiceLeadingTable
+{
+public:
+    //==============================================================================
+    static constexpr int kNumChords   = 24;   // quality (0 = major, 1 = minor) * 12 + column
+    static constexpr int kMaxVoicings = kNumChords * 6;
+
+    // Supported lowest-note range starts (MIDI notes).
+    static constexpr int kMinRangeLowNote = 36;
+    static constexpr int kMaxRangeLowNote = 72;
+
+    struct Voicing
+    {
+        juce::int8 chord       = 0;
+        juce::int8 inversion   = 0;   // 0 = root position, 1 = first, 2 = second
+        juce::int8 octaveShift = 0;   // octaves relative to the default chord register
+        juce::int8 notes[3]    {};    // ascending triad tones
+    };
+
+    //==============================================================================
+    VoiceLeadingTable() = default;
+
+    /** Enumerates all voicings whose lowest note lies in [lowNote, lowNote + 12]
+        and rebuilds the best-move table.  columnRoots are the bass root notes
+        of the 12 columns; chords are voiced from root + 12. */
+    void build (const int* columnRoots, int lowNote);
+
+    bool isBuilt() const noexcept                   { return numVoicings > 0; }
+    int  getRangeLowNote() const noexcept           { return rangeLow; }
+
+    static int chordIndex (bool isMinor, int col) noexcept { return (isMinor ? 12 : 0) + col; }
+
+    /** O(1): voicing of `chord` closest to previousVoicing, or the starting
+        voicing for `chord` with the given inversion when previousVoicing < 0. */
+    int chooseVoicing (int previousVoicing, int chord, int defaultInversion) const noexcept
+    {
+        jassert (isBuilt() && juce::isPositiveAndBelow (chord, kNumChords));
+        return previousVoicing >= 0 ? bestMove[previousVoicing][chord]
+                                    : startVoicing[chord][juce::jlimit (0, 2, defaultInversion)];
+    }
+
+    const Voicing& getVoicing (int index) const noexcept
+    {
+        jassert (juce::isPositiveAndBelow (index, numVoicings));
+        return voicings[index];
+    }
+
+    /** Total semitone movement between two voicings (tones paired in order). */
+    static int distance (const Voicing& a, const Voicing& b) noexcept;
+
+private:
+    //==============================================================================
+    Voicing     voicings[kMaxVoicings];
+    int         numVoicings = 0;
+    int         rangeLow    = 0;
+    juce::int16 bestMove[kMaxVoicings][kNumChords] {};
+    juce::int16 startVoicing[kNumChords][3] {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoiceLeadingTable)
+};
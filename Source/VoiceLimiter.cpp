@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Voice limiter implementation.
+
+  ==============================================================================
+*/
+
+#include "VoiceLimiter.h"
+
+//==============================================================================
+juce::String VoiceLimiter::getPolicyName (StealPolicy p)
+{
+    switch (p)
+    {
+        case StealPolicy::oldest:              return "Oldest";
+        case StealPolicy::lowestPriority:      return "Lowest priority row";
+        case StealPolicy::duplicatePitchFirst: return "Duplicate pitch first";
+        case StealPolicy::numPolicies:
+        default:                               break;
+    }
+
+    return {};
+}
+
+VoiceLimiter::VoiceLimiter() = default;
+
+void VoiceLimiter::reset() noexcept
+{
+    numVoices = 0;
+    std::memset (stolenOffs, 0, sizeof (stolenOffs));
+    numActivePublished.store (0, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void VoiceLimiter::beginBlock (const Settings& settings) noexcept
+{
+    limit  = settings.maxVoices > 0 ? juce::jmin (settings.maxVoices, kMaxVoices) : 0;
+    policy = settings.policy;
+}
+
+void VoiceLimiter::endBlock() noexcept
+{
+    numActivePublished.store (numVoices, std::memory_order_relaxed);
+}
+
+void VoiceLimiter::add (const juce::uint8* data, int size, int sampleOffset, juce::MidiBuffer& out,
+                        int priority) noexcept
+{
+    const auto status = size > 0 ? (data[0] & 0xf0) : 0;
+    const auto ch     = (juce::uint8) (size > 0 ? (data[0] & 0x0f) : 0);
+
+    if (size == 3 && status == 0x90 && data[2] > 0)
+    {
+        const auto note = (juce::uint8) (data[1] & 0x7f);
+
+        // Make room first, at the same sample, so the synth never sees more
+        // than `limit` voices.  Unlimited never steals.
+        while (limit > 0 && numVoices >= limit)
+        {
+            const int   victim = chooseVictim (policy);
+            const auto& v      = voices[victim];
+
+            const juce::uint8 noteOff[3] = { (juce::uint8) (0x80 | v.channel), v.note, 0 };
+            out.addEvent (noteOff, 3, sampleOffset);
+
+            if (stolenOffs[v.channel][v.note] < 255)
+                ++stolenOffs[v.channel][v.note];
+
+            removeVoice (victim);
+            numStolen.fetch_add (1, std::memory_order_relaxed);
+        }
+
+        // Unlimited: voices past kMaxVoices sound but are not tracked.
+        if (numVoices < kMaxVoices)
+            voices[numVoices++] = { ch, note, (juce::uint8) juce::jlimit (0, 255, priority), nextSerial++ };
+    }
+    else if (size == 3 && (status == 0x80 || status == 0x90))
+    {
+        const auto note = (juce::uint8) (data[1] & 0x7f);
+
+        // This voice was already ended when it was stolen.
+        if (stolenOffs[ch][note] > 0)
+        {
+            --stolenOffs[ch][note];
+            return;
+        }
+
+        int oldest = -1;
+        for (int i = 0; i < numVoices; ++i)
+            if (voices[i].channel == ch && voices[i].note == note
+                 && (oldest < 0 || voices[i].serial < voices[oldest].serial))
+                oldest = i;
+
+        if (oldest >= 0)
+            removeVoice (oldest);
+    }
+    else if (size == 3 && status == 0xb0 && (data[1] == 120 || data[1] == 123))
+    {
+        // All Sound Off / All Notes Off.
+        for (int i = numVoices; --i >= 0;)
+            if (voices[i].channel == ch)
+                removeVoice (i);
+
+        std::memset (stolenOffs[ch], 0, sizeof (stolenOffs[ch]));
+    }
+
+    out.addEvent (data, size, sampleOffset);
+}
+
+//==============================================================================
+int VoiceLimiter::chooseVictim (StealPolicy policy) const noexcept
+{
+    jassert (numVoices > 0);
+
+    // (priority, age) ordering: lower priority first, then older first.
+    auto lessImportant = [this] (int a, int b)
+    {
+        if (voices[a].priority != voices[b].priority)
+            return voices[a].priority < voices[b].priority;
+        return voices[a].serial < voices[b].serial;
+    };
+
+    int best = -1;
+
+    switch (policy)
+    {
+        case StealPolicy::duplicatePitchFirst:
+            // A voice whose pitch class is doubled elsewhere adds the least.
+            for (int i = 0; i < numVoices; ++i)
+            {
+                bool doubled = false;
+                for (int j = 0; j < numVoices && ! doubled; ++j)
+                    doubled = j != i && (voices[j].note % 12) == (voices[i].note % 12);
+
+                if (doubled && (best < 0 || lessImportant (i, best)))
+                    best = i;
+            }
+
+            if (best >= 0)
+                return best;
+
+            JUCE_FALLTHROUGH;
+
+        case StealPolicy::oldest:
+            best = 0;
+            for (int i = 1; i < numVoices; ++i)
+                if (voices[i].serial < voices[best].serial)
+                    best = i;
+            return best;
+
+        case StealPolicy::lowestPriority:
+        case StealPolicy::numPolicies:
+        default:
+            best = 0;
+            for (int i = 1; i < numVoices; ++i)
+                if (lessImportant (i, best))
+                    best = i;
+            return best;
+    }
+}
+
+void VoiceLimiter::removeVoice (int index) noexcept
+{
+    jassert (juce::isPositiveAndBelow (index, numVoices));
+    voices[index] = voices[--numVoices];
+}
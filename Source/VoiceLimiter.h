@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    StraDellaMIDI – Stradella Bass Accordion MIDI Effect Plugin
+    Output polyphony cap with voice stealing.
+
+    The limiter sits in processBlock's final merge pass and sees every note
+    that leaves the plugin, in output order.  When a note-on would exceed the configured
+    polyphony, a sounding voice is ended first (at the same sample) according
+    to the steal policy.  The original note-off of a stolen voice is swallowed
+    later so it cannot cut a newer note of the same pitch.
+
+    Each note-on arrives with its own priority, from the processor, which
+    knows which row produced it: bass 3, counterbass 2, chord tone 1, 7th/9th
+    extension 0.  Two voices of the same pitch from different rows keep
+    their own priorities.
+
+    With maxVoices = 0 nothing is ever stolen; voices are still counted (up
+    to kMaxVoices) for getNumActive().
+
+    All bookkeeping uses fixed arrays and nothing here allocates.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MidiEventList.h"
+
+//==============================================================================
+class VoiceLimiter
+{
+public:
+    //==============================================================================
+    enum class StealPolicy { oldest = 0, lowestPriority, duplicatePitchFirst, numPolicies };
+
+    static juce::String getPolicyName (StealPolicy p);
+
+    static constexpr int kMaxVoices      = 128;
+    static constexpr int kDefaultPriority = 1;   ///< host notes and anything untagged
+
+    struct Settings
+    {
+        int         maxVoices = 0;   ///< 0 = unlimited
+        StealPolicy policy    = StealPolicy::lowestPriority;
+    };
+
+    //==============================================================================
+    VoiceLimiter();
+
+    /** Forgets all sounding voices. */
+    void reset() noexcept;
+
+    /** Audio thread, once per block: every event leaving the plugin goes
+        through add() between these two calls, in sample order. */
+    void beginBlock (const Settings& settings) noexcept;
+    void endBlock() noexcept;
+
+    /** Appends the event to `out` (events arrive in sample order), first
+        ending a stolen voice if the note-on needs room, or swallows it if it
+        is the note-off of a voice that was already stolen.  priority is the
+        steal priority of the voice a note-on starts. */
+    void add (const juce::uint8* data, int size, int sampleOffset, juce::MidiBuffer& out,
+              int priority = kDefaultPriority) noexcept;
+
+    /** Total voices stolen since construction.  Any thread. */
+    juce::uint64 getNumStolen() const noexcept   { return numStolen.load (std::memory_order_relaxed); }
+
+    /** Voices sounding after the last block.  Any thread; approximate. */
+    int getNumActive() const noexcept            { return numActivePublished.load (std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    struct Voice
+    {
+        juce::uint8  channel  = 0;   // 0-15
+        juce::uint8  note     = 0;
+        juce::uint8  priority = 1;
+        juce::uint32 serial   = 0;   // start order, for "oldest"
+    };
+
+    int  chooseVictim (StealPolicy policy) const noexcept;
+    void removeVoice  (int index) noexcept;
+
+    Voice        voices[kMaxVoices];
+    int          numVoices  = 0;
+    int          limit      = 0;             ///< 0 = unlimited
+    StealPolicy  policy     = StealPolicy::lowestPriority;
+    juce::uint32 nextSerial = 0;
+
+    // Note-offs still to arrive for voices that were already stolen.
+    juce::uint8  stolenOffs[16][128] {};
+
+    std::atomic<juce::uint64> numStolen          { 0 };
+    std::atomic<int>          numActivePublished { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoiceLimiter)
+};